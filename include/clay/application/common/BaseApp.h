@@ -8,6 +8,8 @@
 
 namespace clay {
 
+class BaseScene;
+
 class BaseApp {
 public:
     BaseApp(BaseGraphicsContext* graphicsContext);
@@ -23,6 +25,9 @@ public:
     BaseGraphicsContext& getGraphicsContext();
 
 protected:
+    /** Destroys a scene once the frames in flight that may draw it have finished, without idling the device */
+    void retireScene(std::unique_ptr<BaseScene> pScene);
+
     std::unique_ptr<BaseGraphicsContext> mpGraphicsContext_;
 
     Resources mResources_;
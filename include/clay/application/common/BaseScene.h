@@ -8,12 +8,17 @@
 #include "clay/utils/common/Utils.h"
 #include "clay/graphics/common/Model.h"
 #include "clay/graphics/common/Camera.h"
+#include "clay/graphics/common/GpuArena.h"
 #include "clay/application/common/Resources.h"
 
 namespace clay {
 
 class BaseApp;
 
+namespace ecs {
+class EntityManager;
+} // namespace ecs
+
 class BaseScene {
 public:
     struct CameraConstant {
@@ -27,6 +32,12 @@ public:
 
     virtual void initialize() = 0;
 
+    /**
+     * Records work that must happen outside the render pass before render. By default culls the clusters of
+     * the entity manager set with setEntityManager against this view
+     */
+    virtual void record(vk::CommandBuffer cmdBuffer, const glm::mat4& view, const glm::mat4& projection);
+
     virtual void render(vk::CommandBuffer cmdBuffer) = 0;
 
     virtual void update(float dt) = 0;
@@ -39,13 +50,28 @@ public:
 
     Resources& getResources();
 
+    /** Device local memory of everything the scene loads through its Resources, freed in one go with the scene */
+    GpuArena& getArena();
+
     Camera* getFocusCamera();
 
+    /** Entities of pEntityManager with a ModelRenderable::mpCuller_ are culled by the default record */
+    void setEntityManager(ecs::EntityManager* pEntityManager);
+
+    /**
+     * Applies the texture usage RenderSystem reported last frame and points the next reports at the focus
+     * camera. Called by the app once per frame, outside of command recording
+     */
+    void streamTextures(float viewportHeight);
+
 protected:
     BaseApp& mApp_;
+    // declared before the resources so its blocks are freed after them
+    GpuArena mArena_;
     Resources mResources_;
     Camera mCamera_;
     Camera* mpFocusCamera_;
+    ecs::EntityManager* mpEntityManager_ = nullptr;
 };
 
 } // namespace clay
\ No newline at end of file
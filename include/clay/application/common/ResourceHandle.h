@@ -0,0 +1,17 @@
+#pragma once
+// standard lib
+#include <cstdint>
+
+namespace clay {
+
+/**
+ * Slot index and generation of a resource in its Resources pool, spelled Resources::Handle<T>. Kept apart
+ * from Resources so types stored in the pools can hold handles to each other
+ */
+template<typename T>
+struct ResourceHandle {
+    uint32_t index = 0;
+    uint32_t gen = 0;
+};
+
+} // namespace clay
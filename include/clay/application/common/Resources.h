@@ -1,10 +1,18 @@
 #pragma once
 // standard lib
+#include <array>
+#include <atomic>
 #include <filesystem>
 #include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 // clay
+#include "clay/application/common/ResourceHandle.h"
 #include "clay/audio/Audio.h"
 #include "clay/graphics/common/BaseGraphicsContext.h"
 #include "clay/graphics/common/Mesh.h"
@@ -13,37 +21,182 @@
 #include "clay/graphics/common/Texture.h"
 #include "clay/graphics/common/PipelineResource.h"
 #include "clay/graphics/common/Font.h"
+#include "clay/graphics/common/GpuArena.h"
+#include "clay/graphics/common/TextureStreamer.h"
+#include "clay/utils/common/AssetArchive.h"
+#include "clay/utils/common/DerivedDataCache.h"
+#include "clay/utils/common/FileWatcher.h"
+#include "clay/utils/common/FlatHashMap.h"
+#include "clay/utils/common/ThreadPool.h"
 #include "clay/utils/common/Utils.h"
 
 namespace clay {
 class Resources {
 public:
     template<typename T>
-    struct Handle {
-        uint32_t index = 0;
-        uint32_t gen = 0;
+    using Handle = ResourceHandle<T>;
+
+    /**
+     * Resource name hashed with utils::hashString. Declare ids as constexpr to hash at compile time,
+     * lookups by id then hash nothing at run time
+     */
+    struct ResourceId {
+        constexpr ResourceId(const char* name)
+            : value(utils::hashString(name)) {}
+
+        constexpr ResourceId(std::string_view name)
+            : value(utils::hashString(name)) {}
+
+        ResourceId(const std::string& name)
+            : value(utils::hashString(name)) {}
+
+        uint64_t value;
+    };
+
+    /** Memory held by the resources of one type, see getMemoryStats */
+    struct MemoryStats {
+        uint32_t count = 0;
+        uint64_t cpuBytes = 0;
+        std::array<vk::DeviceSize, VK_MAX_MEMORY_HEAPS> deviceBytes{}; // by memory heap
+        uint64_t peakCpuBytes = 0;
+        vk::DeviceSize peakDeviceBytes = 0; // every heap together
+    };
+
+    enum class ReportFormat : uint8_t {
+        JSON = 0,
+        CSV
+    };
+
+    /** Heap limits checked by update, see setBudgetPolicy */
+    struct BudgetPolicy {
+        float warnFraction = 0.85f;  // of each heap's budget, logged once per crossing
+        float evictFraction = 0.95f;
+        // called past evictFraction with the bytes to free to get back under warnFraction, such as by
+        // lowering a TextureStreamer budget or releasing resources
+        std::function<void(uint32_t heapIndex, vk::DeviceSize bytesOver)> evict;
     };
 
+    /**
+     * Slots live in fixed size chunks that never move, so pointers to resources stay valid until they are
+     * removed. Resolving a handle with operator[], isValid or isReady takes no lock and may run on any
+     * thread while another thread adds, reserves or fulfills other slots. Everything else is serialized by
+     * the pool. Releasing, removing or reloading a resource must not overlap readers of that same handle
+     */
     template<typename T>
     class ResourcePool {
     public:
         ResourcePool(BaseGraphicsContext& graphicsContext);
 
+        ResourcePool(const ResourcePool&) = delete;
+        ResourcePool& operator=(const ResourcePool&) = delete;
+
+        ~ResourcePool();
+
         Handle<T> loadResource(const std::vector<std::string>& resourcePaths, const std::string& resourceName);
         Handle<T> add(T&& obj, const std::string& name);
+        /** Takes a slot filled in later by fulfill, until then operator[] returns the placeholder */
+        Handle<T> reserve(const std::string& name);
+        /** Takes a slot filled in later by fulfill, until then operator[] returns standIn */
+        Handle<T> reserve(const std::string& name, T&& standIn);
+        /** Reserved with a stand in that fulfill has not replaced yet */
+        bool hasStandIn(Handle<T> handle) const;
+        /** Stores the loaded object, a previous one is destroyed once no frame in flight uses it */
+        void fulfill(Handle<T> handle, T&& obj);
+        bool isReady(Handle<T> handle) const;
+        /** Set before handles of this type are resolved on other threads */
+        void setPlaceholder(T&& obj);
+        bool hasPlaceholder() const;
+        const T& getPlaceholder() const;
+        /** Adds a reference to the live resource of that name, if any */
+        std::optional<Handle<T>> acquire(const std::string& name);
+        bool isValid(Handle<T> handle) const;
+        void retain(Handle<T> handle);
+        /** Drops a reference, the last one removes the resource */
+        void release(Handle<T> handle);
+        uint32_t getRefCount(Handle<T> handle) const;
+        /** Destroys the object once no frame in flight can use it, then frees the slot and its name */
         void remove(Handle<T> handle);
+        void removeAll();
         T& operator[](Handle<T> handle);
-        Handle<T> getHandle(const std::string& name) const;
+
+        /** Calls fn(T&) for every loaded resource */
+        template<typename Fn>
+        void forEach(Fn&& fn) {
+            const uint32_t count = slotCount.load(std::memory_order_acquire);
+            for (uint32_t i = 0; i < count; ++i) {
+                Slot& slot = *findSlot(i);
+                if (slot.state.load(std::memory_order_acquire) == SLOT_READY) {
+                    fn(*slot.object);
+                }
+            }
+        }
+        Handle<T> getHandle(ResourceId id) const;
+        /** Measures every resource again, picking up ones that changed size in place */
+        MemoryStats getMemoryStats();
 
     private:
+        enum SlotState : uint8_t {
+            SLOT_FREE = 0,
+            SLOT_LOADING,  // reserved, waiting for its asynchronous load
+            SLOT_STAND_IN, // reserved, operator[] returns the stand in object until the load is done
+            SLOT_READY
+        };
+
+        struct Slot {
+            std::optional<T> object;
+            // bumped when the slot is freed so older handles stop resolving
+            std::atomic<uint32_t> generation{0};
+            std::atomic<uint8_t> state{SLOT_FREE};
+            uint32_t refCount = 0;
+            std::string name;
+            // what the object counted for in stats
+            uint64_t cpuBytes = 0;
+            vk::DeviceSize deviceBytes = 0;
+        };
+
+        static constexpr uint32_t kChunkSize = 128;
+        static constexpr uint32_t kMaxChunks = 2048;
+
+        /** nullptr past the slots published so far */
+        Slot* findSlot(uint32_t index) const;
+
+        Handle<T> insertLocked(T&& obj, const std::string& name, SlotState state);
+        void removeLocked(Handle<T> handle);
+
+        /** Moves the object out of its slot, or the placeholder, into a deferred destroy */
+        void retire(std::optional<T>& object);
+
+        /** Counts the slot's object in stats, or takes it back out */
+        void account(Slot& slot);
+        void unaccount(Slot& slot);
+
         BaseGraphicsContext& mGraphicsContext_;
-        std::vector<T> resources;
-        // track when a resource slot is resused, if a older generation is used, then throw error
-        std::vector<uint32_t> generations; 
+        std::array<std::atomic<Slot*>, kMaxChunks> chunks{};
+        // slots below this are constructed and visible to readers
+        std::atomic<uint32_t> slotCount{0};
+        std::optional<T> placeholder;
+        // writers only
+        mutable std::mutex writeMutex;
         // stack of vacant indices
         std::vector<uint32_t> freeList;
-        // update when a resource is freed
-        std::unordered_map<std::string, Handle<T>> name2Handle;
+        // resource id -> handle, update when a resource is freed
+        utils::FlatHashMap<uint64_t, Handle<T>> ids;
+        MemoryStats stats;
+        uint32_t deviceHeapIndex = UINT32_MAX; // device local heap, looked up on first use
+    };
+
+    /** One resource of a scene manifest, see loadManifest */
+    struct ManifestEntry {
+        enum class Type : uint8_t {
+            MESH = 0,
+            MODEL,   // also loads the mesh under name + "#mesh", as loadResource<Model> does
+            TEXTURE,
+            AUDIO
+        };
+
+        Type type;
+        std::vector<std::string> paths;
+        std::string name;
     };
 
     static void setFileLoader(std::function<utils::FileData(const std::string&)> loader);
@@ -52,13 +205,79 @@ public:
 
     static const std::filesystem::path& getResourcePath(); 
 
+    /**
+     * Files found in a mounted archive are served from it instead of the file loader, paths are looked up
+     * relative to the resource path. Later mounts take precedence. Mount before loading starts
+     */
+    static void mountArchive(std::shared_ptr<const utils::AssetArchive> archive);
+
+    static void unmountArchives();
+
+    /**
+     * Model imports are looked up in the cache by source content before running the importer, and stored
+     * after. Pass nullptr to stop using it. Set before loading starts
+     */
+    static void setDerivedDataCache(std::shared_ptr<utils::DerivedDataCache> cache);
+
     Resources(BaseGraphicsContext& graphicsContext);
 
     ~Resources();
 
+    /** GPU memory for resources loaded from here on is placed in the arena, which must outlive them */
+    void setArena(GpuArena* pArena);
+
+    /** Streams the mips of registered textures, RenderSystem reports usage to it for entities with a stream id */
+    TextureStreamer& getTextureStreamer();
+
     template<typename T>
     Resources::Handle<T> loadResource(const std::vector<std::string>& resourcePaths, const std::string& resourceName);
 
+    /**
+     * Returns at once while a worker thread reads and decodes the file. The GPU upload happens in update,
+     * until then operator[] returns the placeholder. Texture and Mesh only. The file loader is called from
+     * worker threads
+     */
+    template<typename T>
+    Resources::Handle<T> loadResourceAsync(const std::vector<std::string>& resourcePaths, const std::string& resourceName);
+
+    /**
+     * Loads every entry and blocks until they are ready. All files are read and decoded on the loader
+     * threads at once, then every GPU upload shares one submit. Models are built once their mesh is
+     * uploaded, a mesh named by both a MESH and a MODEL entry is loaded once. Materials and pipelines are
+     * built in code, create them afterwards from the handles found with getHandle. Entries that fail are
+     * logged and skipped, returns how many entries are ready
+     */
+    uint32_t loadManifest(const std::vector<ManifestEntry>& manifest);
+
+    /** Finishes every decoded asynchronous load with one batched upload. Call once per frame, returns how many became ready */
+    uint32_t update();
+
+    uint32_t getPendingLoadCount() const;
+
+    /** Returned by operator[] for handles still loading. Textures default to a 1x1 white texture */
+    template<typename T>
+    void setPlaceholder(T&& placeholder);
+
+    /**
+     * Development aid. Textures and meshes loaded from here on are watched and, when their file changes,
+     * reloaded on a loader thread and swapped in place behind their handles by update. Materials sampling
+     * a reloaded texture are pointed at the new image view
+     */
+    void enableHotReload();
+
+    /**
+     * Rebuilds the pipeline in place whenever one of its SPIR-V files changes. shaderFiles lists every stage
+     * of the pipeline, config is kept with its shaders replaced. Does nothing unless hot reload is enabled
+     */
+    void watchPipeline(
+        Handle<PipelineResource> handle,
+        const PipelineResource::PipelineConfig& config,
+        const std::vector<std::pair<std::string, vk::ShaderStageFlagBits>>& shaderFiles
+    );
+
+    template<typename T>
+    bool isReady(Handle<T> handle);
+
     template<typename T>
     auto addResource(T&& resource, const std::string& resourceName) -> Handle<std::remove_reference_t<T>>; 
 
@@ -66,19 +285,90 @@ public:
     T& operator[](Handle<T> handle);
 
     template<typename T>
-    Handle<T> getHandle(const std::string& resourceName);
+    Handle<T> getHandle(ResourceId id);
 
+    /**
+     * Loading or adding a resource holds one reference, loading a name that is already loaded adds another
+     * and returns the same handle. The last release destroys the resource once frames in flight are done
+     */
     template<typename T>
     void release(Handle<T> handle);
 
+    template<typename T>
+    void retain(Handle<T> handle);
+
+    template<typename T>
+    uint32_t getRefCount(Handle<T> handle);
+
+    /** Removes every resource regardless of references, handles held elsewhere become invalid */
     void releaseAll();
 
+    template<typename T>
+    MemoryStats getMemoryStats();
+
+    /** Every pool's stats and the heap usage of the graphics context */
+    std::string exportMemoryReport(ReportFormat format);
+
+    /**
+     * Starts checking heap usage against the policy in update. Uses VK_EXT_memory_budget when the device
+     * has it, otherwise what this context allocated against the heap sizes
+     */
+    void setBudgetPolicy(BudgetPolicy policy);
+
+    /** Warns and evicts per the budget policy, called by update */
+    void checkBudget();
+
 private:
     static std::filesystem::path RESOURCE_PATH;
 
     static std::function<utils::FileData(const std::string&)> loadFileToMemory;
 
+    static std::vector<std::shared_ptr<const utils::AssetArchive>> ARCHIVES;
+
+    /** Checks the mounted archives, then falls back to the file loader */
+    static utils::FileData readFile(const std::string& path);
+
+    static std::shared_ptr<utils::DerivedDataCache> DERIVED_DATA_CACHE;
+
+    /** Reads and imports a model file, through the derived data cache when one is set */
+    static Mesh::ImportedModel importModel(const std::string& path);
+
+    template<typename T>
+    ResourcePool<T>& getPool();
+
+    /** Calls fn(name, pool) for every pool */
+    template<typename Fn>
+    void forEachPool(Fn&& fn);
+
+    // runs on a loader thread and returns the upload for the render thread
+    using LoadJob = std::function<std::function<void()>()>;
+
+    struct PendingLoad {
+        std::string name;
+        std::future<std::function<void()>> finish; // runs the upload on the render thread
+    };
+
+    struct ReloadJob {
+        std::string name;
+        std::function<bool()> isAlive;
+        LoadJob job;
+    };
+
+    template<typename T>
+    LoadJob makeLoadJob(Handle<T> handle, const std::string& path);
+
+    void submitLoad(const std::string& name, LoadJob job);
+
+    utils::ThreadPool& getLoaderThreads();
+
+    template<typename T>
+    void watchForReload(Handle<T> handle, const std::string& name, const std::string& path);
+
+    /** Queues a reload for every watched file that changed */
+    void submitReloads();
+
     BaseGraphicsContext& mGraphicsContext_;
+    GpuArena* mpArena_ = nullptr;
 
     ResourcePool<Mesh> mMeshesPool_;
     ResourcePool<Model> mModelsPool_;
@@ -88,6 +378,22 @@ private:
     ResourcePool<Material> mMaterialsPool_;
     ResourcePool<Audio> mAudiosPool_;
     ResourcePool<Font> mFontsPool_;
+
+    // declared after the pools so it lets go of their textures first
+    TextureStreamer mTextureStreamer_;
+
+    // mesh loaded for each model slot by loadResource<Model>
+    std::unordered_map<uint32_t, Handle<Mesh>> mModelMeshes_;
+
+    std::vector<PendingLoad> mPendingLoads_;
+    std::optional<BudgetPolicy> mBudgetPolicy_;
+    std::array<bool, VK_MAX_MEMORY_HEAPS> mHeapsOverWarning_{};
+
+    std::unique_ptr<utils::FileWatcher> mFileWatcher_;
+    // normalized file path -> resources to reload when it changes
+    std::unordered_map<std::string, std::vector<ReloadJob>> mReloadJobs_;
+    // started on the first asynchronous load, destroyed first so no worker outlives the pools
+    std::unique_ptr<utils::ThreadPool> mLoaderThreads_;
 };
 
 } // namespace clay
@@ -1,4 +1,6 @@
 #pragma once
+// standard lib
+#include <cstddef>
 // project
 #include "clay/utils/common/Utils.h"
 
@@ -20,6 +22,9 @@ public:
     /** Get the AL buffer id */
     int getId();
 
+    /** Bytes of PCM data held by the AL buffer */
+    std::size_t getMemorySize() const;
+
 private:
     /** AL audio id */
     unsigned int mId_;
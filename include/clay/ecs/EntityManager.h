@@ -44,6 +44,9 @@ public:
 
 
     // for now, have update/render in here?
+    /** See RenderSystem::cull, record before the render pass that calls render */
+    void cull(vk::CommandBuffer cmdBuffer, const glm::mat4& viewProjection, const glm::vec3& cameraPosition);
+
     void render(vk::CommandBuffer cmdBuffer);
 
     void update(float dt);
@@ -9,6 +9,8 @@
 #include <glm/gtc/quaternion.hpp>
 // clay
 #include "clay/application/common/Resources.h"
+#include "clay/graphics/common/ClusterCuller.h"
+#include "clay/graphics/common/TextureStreamer.h"
 
 namespace clay::ecs {
 
@@ -57,6 +59,8 @@ struct ModelRenderable {
     Resources::Handle<Model> modelHandle;
     glm::vec4 mColor_ = {1,1,1,1};
     glm::mat4 localModelMat = glm::identity<glm::mat4>();
+    ClusterCuller* mpCuller_ = nullptr; // built from the model's mesh, draws it through RenderSystem::cull
+    TextureStreamer::StreamId mStreamId_ = TextureStreamer::NO_STREAM; // streamed texture of the model's material
 };
 
 struct SpriteRenderable {
@@ -64,6 +68,7 @@ struct SpriteRenderable {
     Material* mpMaterial_;
     glm::vec4 mSpriteOffset_;
     glm::vec4 mColor_ = {1,1,1,1};
+    TextureStreamer::StreamId mStreamId_ = TextureStreamer::NO_STREAM; // streamed texture of the material
 };
 
 struct EntityMetadata {
@@ -15,7 +15,8 @@ public:
 
     TextRenderable();
 
-    void initialize(BaseGraphicsContext& gContext, const std::string& text, Font* font);
+    /** With batched set no vertex buffer is created, the text is drawn from mGlyphQuads_ by a TextBatcher */
+    void initialize(BaseGraphicsContext& gContext, const std::string& text, Font* font, bool batched = false);
 
     void createVertexBuffer(BaseGraphicsContext& gContext);
 
@@ -26,10 +27,13 @@ public:
     glm::mat4 getModelMatrix();
 
     std::string mText_;
+    std::u32string mCodepoints_; // mText_ decoded from UTF-8
+    std::u32string mPinnedCodepoints_; // glyphs acquireGlyph pinned, released in finalize
     Font* mpFont_;
     vk::Buffer mVertexBuffer_;
     vk::DeviceMemory mVertexBufferMemory_;
     std::vector<Font::FontVertex> mVertices_;
+    std::vector<Font::GlyphQuad> mGlyphQuads_;
     glm::vec3 mPosition_ = {0.0f, 0.0f, 0.0f};
     glm::quat mOrientation_ = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
     glm::vec3 mScale_ { 1.0f, 1.0f, 1.0f };;
@@ -1,5 +1,6 @@
 #pragma once
 #include "clay/graphics/common/BaseGraphicsContext.h"
+#include "clay/graphics/common/TextBatcher.h"
 #include "clay/application/common/Resources.h"
 
 
@@ -12,10 +13,17 @@ public:
 
     RenderSystem(BaseGraphicsContext& gContext, Resources& resources);
 
+    /** Records culling for models with a ClusterCuller. Must be recorded outside the render pass, before render */
+    void cull(EntityManager& entityManager, vk::CommandBuffer cmdBuffer, const glm::mat4& viewProjection, const glm::vec3& cameraPosition);
+
     void render(EntityManager& entityManager, vk::CommandBuffer cmdBuffer);
 
+    /** Text entities are drawn through the batcher, after every other entity, when one is set */
+    void setTextBatcher(TextBatcher* pTextBatcher);
+
     BaseGraphicsContext& mGContext_;
     Resources& mResources_;
+    TextBatcher* mpTextBatcher_ = nullptr;
 };
 
 } // namespace clay::ecs
\ No newline at end of file
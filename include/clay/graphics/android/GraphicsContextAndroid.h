@@ -35,8 +35,6 @@ public:
         std::vector<VkPresentModeKHR> presentModes;
     };
 
-    static constexpr int MAX_FRAMES_IN_FLIGHT = 2;
-
     GraphicsContextAndroid(android_app* pAndroidApp);
 
     ~GraphicsContextAndroid();
@@ -69,8 +67,6 @@ public:
 
     void pickPhysicalDevice();
 
-    void generateMipmaps(VkImage image, VkFormat imageFormat, int32_t texWidth, int32_t texHeight, uint32_t mipLevels);
-
     void createRenderPass();
 
     VkFormat findSupportedFormat(const std::vector<VkFormat>& candidates, VkImageTiling tiling, VkFormatFeatureFlags features);
@@ -1,6 +1,11 @@
 #pragma once
 // standard lib
+#include <array>
 #include <cstring> // memcpy
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 // third party
 #include <vulkan/vulkan.hpp>
 #include <vulkan/vulkan.h>
@@ -8,8 +13,29 @@
 
 namespace clay {
 
+class GpuArena;
+
 class BaseGraphicsContext {
 public:
+    static constexpr int MAX_FRAMES_IN_FLIGHT = 2;
+
+    /** Device memory of one heap, see getHeapUsage */
+    struct HeapUsage {
+        vk::DeviceSize size;
+        vk::DeviceSize budget;        // what this process can allocate, from VK_EXT_memory_budget or else the heap size
+        vk::DeviceSize usage;         // of this process, from VK_EXT_memory_budget or else allocated
+        vk::DeviceSize allocated;     // through this context
+        vk::DeviceSize peakAllocated; // through this context
+        bool deviceLocal;
+    };
+
+    /** Tightly packed pixels of one mip level, compressed formats are whole blocks */
+    struct ImageLevel {
+        const void* data;
+        vk::DeviceSize size;
+        uint32_t width;
+        uint32_t height;
+    };
 
     virtual ~BaseGraphicsContext();
 
@@ -23,6 +49,15 @@ public:
 
     void copyBuffer(vk::Buffer srcBuffer, vk::Buffer dstBuffer, vk::DeviceSize size);
 
+    /** Create a device local buffer and fill it with data through a staging buffer */
+    void createDeviceLocalBuffer(
+        const void* data,
+        vk::DeviceSize size,
+        vk::BufferUsageFlags usage,
+        vk::Buffer& buffer,
+        vk::DeviceMemory& bufferMemory
+    );
+
     void createImage(
         uint32_t width,
         uint32_t height,
@@ -36,8 +71,67 @@ public:
         vk::DeviceMemory& imageMemory
     );
 
+    /**
+     * Device local buffers and images created while an arena is active are placed in it, see GpuArena.
+     * Host visible memory is always allocated on its own since callers map it from offset 0
+     */
+    void setActiveArena(GpuArena* pArena);
+
+    GpuArena* getActiveArena() const;
+
+    /** Allocates memory counted against its heap in getHeapUsage, free it with freeMemory */
+    vk::DeviceMemory allocateMemory(const vk::MemoryAllocateInfo& allocInfo);
+
+    /** Frees memory from allocateMemory, createBuffer or createImage, memory placed in an arena is freed with the arena */
+    void freeMemory(vk::DeviceMemory memory);
+
+    /** One entry per memory heap. Budgets are refreshed by the driver about once per frame */
+    std::vector<HeapUsage> getHeapUsage() const;
+
+    /** Heap of the first memory type with all of properties */
+    uint32_t getMemoryHeapIndex(vk::MemoryPropertyFlags properties) const;
+
+    bool isMemoryBudgetEnabled() const;
+
     void populateImage(vk::Image image, utils::ImageData& imageData);
 
+    /**
+     * Uploads imageData to mip 0 and fills the other levels in the same command buffer, with a blit chain
+     * when the format supports linear blits and on the CPU with cpuFilter otherwise. Leaves every level in
+     * eShaderReadOnlyOptimal
+     */
+    void uploadImage(
+        vk::Image image,
+        vk::Format format,
+        const utils::ImageData& imageData,
+        uint32_t mipLevels,
+        utils::MipFilter cpuFilter = utils::MipFilter::BOX
+    );
+
+    /**
+     * Uploads levels (largest first) in one submit and leaves the image in eShaderReadOnlyOptimal. When
+     * mipLevels is larger than a single given level, the rest are generated with a blit chain
+     */
+    void uploadImageLevels(vk::Image image, vk::Format format, const std::vector<ImageLevel>& levels, uint32_t mipLevels);
+
+    /**
+     * Overwrites a rectangle of mip 0 of an image already in eShaderReadOnlyOptimal with tightly packed
+     * pixels. Earlier submissions that sample the image finish reading before the copy lands
+     */
+    void updateImageRegion(vk::Image image, const ImageLevel& region, vk::Offset2D offset);
+
+    /** Records a blit chain from mip 0. Every level must be in eTransferDstOptimal, all end in eShaderReadOnlyOptimal */
+    void recordGenerateMipmaps(vk::CommandBuffer commandBuffer, vk::Image image, int32_t texWidth, int32_t texHeight, uint32_t mipLevels);
+
+    void generateMipmaps(vk::Image image, vk::Format imageFormat, int32_t texWidth, int32_t texHeight, uint32_t mipLevels);
+
+    bool supportsLinearBlit(vk::Format format);
+
+    bool supportsSampledFormat(vk::Format format);
+
+    /** Trilinear sampler over every mip level, anisotropic when enabled on the device. Caller owns it */
+    vk::Sampler createTextureSampler(float maxAnisotropy = 16.0f, vk::SamplerAddressMode addressMode = vk::SamplerAddressMode::eRepeat);
+
     vk::ImageView createImageView(vk::Image image, vk::Format format, vk::ImageAspectFlags aspectFlags, uint32_t mipLevels);
 
     void transitionImageLayout(vk::Image image, vk::Format format, vk::ImageLayout oldLayout, vk::ImageLayout newLayout, uint32_t mipLevels);
@@ -50,24 +144,92 @@ public:
 
     void endSingleTimeCommands(vk::CommandBuffer commandBuffer);
 
+    /**
+     * Until endUploadBatch, every upload made through this context (buffers, images, mips) is recorded into
+     * one command buffer and its staging memory is kept, instead of one submit and queue wait each
+     */
+    void beginUploadBatch();
+
+    /** Submits everything recorded since beginUploadBatch, waits for it and frees the staging memory */
+    void endUploadBatch();
+
     vk::Device getDevice() const;
 
     vk::Instance getInstance() const;
 
     std::pair<int, int> getFrameDimensions() const;
 
+    /**
+     * Runs destroyFn once every frame that could still reference the object has finished on the GPU. Use
+     * for resources replaced while the application is running, instead of waiting for the device to idle
+     */
+    void deferDestroy(std::function<void()> destroyFn);
+
+    /** Called once per frame, after waiting on the fence of the frame about to be recorded */
+    void advanceFrame();
+
+    uint64_t getFrameIndex() const;
+
+    /** Waits for the device to idle and runs every pending deferDestroy, used on shutdown */
+    void flushDeferredDestroys();
+
 protected:
+    /** Called by the platform once the device is created with VK_EXT_memory_budget enabled */
+    void enableMemoryBudget();
+
+    /** Whether the instance offers name, platforms use it to enable optional extensions */
+    static bool isInstanceExtensionAvailable(const char* name);
+
     // initializer list instead
     vk::Device mDevice_ = nullptr;
     vk::Instance mInstance_ = nullptr;
 
     std::pair<int, int> mFrameDimensions_;
+
+private:
+    friend class GpuArena;
+
+    struct DeferredDestroy {
+        uint64_t frameIndex;
+        std::function<void()> destroyFn;
+    };
+
+    /** Frees a staging buffer now, or after the upload batch it was recorded into */
+    void releaseStagingBuffer(vk::Buffer buffer, vk::DeviceMemory memory);
+
+    vk::DeviceMemory allocateArenaBlock(vk::DeviceSize size, uint32_t memoryTypeIndex);
+
+    void freeArenaBlock(vk::DeviceMemory memory);
+
+    /** Forgets a tracked allocation and frees it */
+    void releaseMemory(vk::DeviceMemory memory);
+
+    struct TrackedAllocation {
+        vk::DeviceSize size;
+        uint32_t heapIndex;
+    };
+
+    uint64_t mFrameIndex_ = 0;
+    std::vector<DeferredDestroy> mDeferredDestroys_;
+
+    vk::CommandBuffer mUploadBatchCommands_ = nullptr;
+    std::vector<std::pair<vk::Buffer, vk::DeviceMemory>> mUploadBatchStaging_;
+
+    GpuArena* mpActiveArena_ = nullptr;
+    std::unordered_set<VkDeviceMemory> mArenaBlocks_;
+
+    std::unordered_map<VkDeviceMemory, TrackedAllocation> mAllocations_;
+    std::array<vk::DeviceSize, VK_MAX_MEMORY_HEAPS> mHeapAllocated_{};
+    std::array<vk::DeviceSize, VK_MAX_MEMORY_HEAPS> mHeapPeakAllocated_{};
+    PFN_vkGetPhysicalDeviceMemoryProperties2KHR mpGetMemoryProperties2_ = nullptr;
+
 public:
     vk::PhysicalDevice mPhysicalDevice_ = nullptr;
     vk::RenderPass mRenderPass_ = nullptr;
     vk::DescriptorPool mDescriptorPool_ = nullptr;
     vk::CommandPool mCommandPool_ = nullptr;
     vk::Queue mGraphicsQueue_ = nullptr;
+    vk::PhysicalDeviceFeatures mEnabledFeatures_{};
 };
 
 } // namespace clay
\ No newline at end of file
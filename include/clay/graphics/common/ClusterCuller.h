@@ -0,0 +1,83 @@
+#pragma once
+// standard lib
+#include <memory>
+#include <vector>
+// third party
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+// clay
+#include "clay/graphics/common/BaseGraphicsContext.h"
+#include "clay/graphics/common/Material.h"
+#include "clay/graphics/common/Mesh.h"
+#include "clay/graphics/common/Meshlet.h"
+#include "clay/graphics/common/PipelineResource.h"
+
+namespace clay {
+
+/**
+ * GPU meshlet culling for a Mesh. cull() dispatches a compute shader that tests each meshlet against the
+ * frustum and its normal cone and writes one vk::DrawIndexedIndirectCommand per meshlet, instanceCount 0
+ * when culled. draw() then submits every meshlet in one indirect draw.
+ *
+ * The meshlets must be built from the same index buffer the Mesh was created with. The culling shader is
+ * supplied by the application and uses:
+ *   binding 0: readonly buffer of GpuMeshlet
+ *   binding 1: buffer of VkDrawIndexedIndirectCommand, one per meshlet
+ *   push constants: CullPushConstants, local_size_x = WORKGROUP_SIZE
+ */
+class ClusterCuller {
+public:
+    static constexpr uint32_t WORKGROUP_SIZE = 64;
+
+    /** std430 meshlet record read by the culling shader */
+    struct GpuMeshlet {
+        glm::vec4 boundingSphere; // xyz center, w radius
+        glm::vec4 cone;           // xyz axis, w cutoff
+        uint32_t firstIndex;
+        uint32_t indexCount;
+        uint32_t padding[2];
+    };
+
+    /** Frustum and camera in model space so the shader does not need the model matrix */
+    struct CullPushConstants {
+        glm::vec4 frustumPlanes[6];
+        glm::vec3 cameraPosition;
+        uint32_t meshletCount;
+    };
+
+    static std::vector<vk::DescriptorSetLayoutBinding> getDescriptorSetLayoutBindings();
+
+    static vk::PushConstantRange getPushConstantRange();
+
+    ClusterCuller(BaseGraphicsContext& gContext, PipelineResource& cullPipeline, Mesh& mesh, const MeshletData& meshletData);
+
+    ClusterCuller(const ClusterCuller&) = delete;
+    ClusterCuller& operator=(const ClusterCuller&) = delete;
+
+    ~ClusterCuller();
+
+    /** Records the culling dispatch. Must be recorded outside of a render pass */
+    void cull(vk::CommandBuffer cmdBuffer, const glm::mat4& viewProjection, const glm::mat4& model, const glm::vec3& cameraPosition);
+
+    /** Binds the mesh and draws the meshlets that survived culling. The material must already be bound */
+    void draw(vk::CommandBuffer cmdBuffer);
+
+    uint32_t getMeshletCount() const;
+
+private:
+    void finalize();
+
+    BaseGraphicsContext& mGraphicsContext_;
+    Mesh& mMesh_;
+    uint32_t mMeshletCount_ = 0;
+
+    vk::Buffer mMeshletBuffer_{};
+    vk::DeviceMemory mMeshletBufferMemory_{};
+    vk::Buffer mDrawBuffer_{};
+    vk::DeviceMemory mDrawBufferMemory_{};
+
+    std::unique_ptr<Material> mCullMaterial_;
+};
+
+} // namespace clay
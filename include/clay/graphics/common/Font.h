@@ -8,26 +8,61 @@
 #include <glm/glm.hpp>
 // clay
 #include "clay/graphics/common/BaseGraphicsContext.h"
+#include "clay/utils/common/FlatHashMap.h"
 #include "clay/utils/common/Utils.h"
 #include "clay/graphics/common/PipelineResource.h"
 #include "clay/graphics/common/Material.h"
+#include "clay/graphics/common/Texture.h"
 #include "clay/graphics/common/UniformBuffer.h"
+#include "clay/graphics/common/VertexLayout.h"
+
+struct FT_LibraryRec_;
+struct FT_FaceRec_;
 
 namespace clay {
 
+/**
+ * Glyphs are rasterized on first use into a grid of line height cells in one atlas texture, keyed by
+ * Unicode codepoint. Text that keeps referencing atlas uvs pins its glyphs with acquireGlyph; once the
+ * atlas is full the least recently used unpinned glyph gives up its cell
+ */
 class Font {
 public:
+    enum class RenderMode : uint8_t {
+        BITMAP = 0, // coverage at pixelSize, sharp only near that size
+        SDF         // signed distance to the outline, 128 on the edge, resolution independent
+    };
+
+    /**
+     * In SDF mode the atlas is sampled linearly and the fragment shader thresholds the distance instead of
+     * using it as alpha, for example alpha = smoothstep(0.5 - w, 0.5 + w, d) with w = fwidth(d) * 0.7.
+     * One atlas then stays crisp at any TextRenderable scale, including world space text in XR
+     */
+    struct Config {
+        uint32_t pixelSize = 48;
+        RenderMode renderMode = RenderMode::BITMAP;
+        uint32_t sdfSpread = 8; // distance in pixels mapped to the full 0..255 range, FreeType allows 2 to 32
+        uint32_t atlasSize = 1024; // side of the glyph cache texture
+    };
+
     struct CharacterInfo {
         uint32_t width;        // glyph bitmap width in pixels
         uint32_t height;       // glyph bitmap height in pixels
         int32_t bitmapLeft;    // horizontal offset from pen position to left of glyph
         int32_t bitmapTop;     // vertical offset from pen baseline to top of glyph
         uint32_t advance;      // horizontal advance in pixels in 1/64th pixels
+        glm::vec4 uvRect;      // xy = top left uv in the atlas, zw = uv size
+    };
+
+    /** One laid out glyph of a text, consumed by TextBatcher */
+    struct GlyphQuad {
+        glm::vec4 rect;   // xy = bottom left in text space pixels, zw = size
+        glm::vec4 uvRect; // same as CharacterInfo::uvRect
     };
 
     struct FontVertex {
-        glm::vec4 vertex;    // xy = position, zw = texCoord
-        int glyphIndex;
+        glm::vec4 vertex;    // xy = position, zw = atlas texCoord
+        int glyphIndex;      // codepoint, no longer needed to pick a texture
 
         static vk::VertexInputBindingDescription getBindingDescription();
 
@@ -36,6 +71,8 @@ public:
 
     Font(BaseGraphicsContext& graphicsAPI, utils::FileData& fontFileData, ShaderModule& vertShader, ShaderModule& fragShader, UniformBuffer& uniformBuffer);
 
+    Font(BaseGraphicsContext& graphicsAPI, utils::FileData& fontFileData, ShaderModule& vertShader, ShaderModule& fragShader, UniformBuffer& uniformBuffer, const Config& config);
+
     // move constructor
     Font(Font&& other);
 
@@ -48,23 +85,107 @@ public:
 
     const Material& getMaterial() const;
 
-    const CharacterInfo& getCharacterInfo(char c) const;
+    /**
+     * Metrics of a codepoint, rasterizing it into the atlas on a miss. Codepoints the font lacks use its
+     * missing glyph box. The uvRect is only guaranteed until the glyph is evicted, see acquireGlyph
+     */
+    CharacterInfo getCharacterInfo(char32_t codepoint);
+
+    /**
+     * getCharacterInfo that also keeps the glyph in the atlas until a matching releaseGlyph. pinned is false
+     * when the glyph has no atlas cell (empty, oversized or the atlas is full), such glyphs must not be released
+     */
+    CharacterInfo acquireGlyph(char32_t codepoint, bool& pinned);
+
+    void releaseGlyph(char32_t codepoint);
+
+    /** Uploads every glyph rasterized since the last flush in a single transfer */
+    void flushAtlas();
+
+    uint32_t getCachedGlyphCount() const;
+
+    /** Single channel texture holding every glyph, bound as one sampler at binding 1 */
+    const Texture& getAtlas() const;
+
+    /** Bytes of the CPU copy of the atlas and the glyph tables */
+    std::size_t getCpuMemorySize() const;
+
+    const Config& getConfig() const;
 
 private:
+    static constexpr uint32_t kNoCell = UINT32_MAX;
+    /** Empty texels around each glyph so filtering never reaches a neighbour */
+    static constexpr uint32_t kGlyphPadding = 1;
+    /** Printable ASCII is rasterized up front so common text never waits on the rasterizer */
+    static constexpr char32_t kFirstPrewarmed = 0x20;
+    static constexpr char32_t kLastPrewarmed = 0x7E;
+
+    struct CachedGlyph {
+        CharacterInfo info;
+        uint32_t cell; // kNoCell for glyphs without pixels, such as space
+    };
+
+    struct Cell {
+        char32_t codepoint = 0;
+        uint32_t pinCount = 0;
+        // least recently used list of used, unpinned cells
+        uint32_t lruPrev = kNoCell;
+        uint32_t lruNext = kNoCell;
+    };
+
+    /** Copy of the cache entry, rasterizing on a miss */
+    CachedGlyph findOrRasterize(char32_t codepoint);
+
+    /** A free cell, or the least recently used unpinned one after evicting its glyph. kNoCell when all are pinned */
+    uint32_t allocateCell();
+
+    void lruRemove(uint32_t cell);
+
+    void lruPushBack(uint32_t cell);
+
+    void releaseFreeType();
+
     void createPipeline(ShaderModule& vertShader, ShaderModule& fragShader, UniformBuffer& uniformBuffer);
 
     BaseGraphicsContext& mGContext_;
 
-    vk::Sampler mSampler_;
+    Config mConfig_;
 
-    std::array<CharacterInfo, 128> mCharacterFrontInfo_;
+    vk::Sampler mSampler_;
 
-    std::array<vk::Image, 128> mCharacterImage_;
-    std::array<vk::DeviceMemory, 128> mCharacterMemory_;
-    std::array<vk::ImageView, 128> mCharacterImageView_;
+    // FreeType keeps reading the font file while glyphs are loaded on demand
+    std::unique_ptr<uint8_t[]> mFontData_;
+    FT_LibraryRec_* mFtLibrary_ = nullptr;
+    FT_FaceRec_* mFtFace_ = nullptr;
+
+    utils::FlatHashMap<char32_t, CachedGlyph> mGlyphs_;
+    std::vector<Cell> mCells_;
+    std::vector<uint32_t> mFreeCells_;
+    uint32_t mLruHead_ = kNoCell;
+    uint32_t mLruTail_ = kNoCell;
+    uint32_t mCellWidth_ = 0;
+    uint32_t mCellHeight_ = 0;
+    uint32_t mCellsPerRow_ = 0;
+
+    // CPU copy of the atlas and the part of it not yet uploaded
+    std::vector<uint8_t> mAtlasPixels_;
+    uint32_t mDirtyMinX_ = UINT32_MAX;
+    uint32_t mDirtyMinY_ = UINT32_MAX;
+    uint32_t mDirtyMaxX_ = 0;
+    uint32_t mDirtyMaxY_ = 0;
+
+    Texture mAtlas_;
 
     std::unique_ptr<PipelineResource> mPipeline_;
     std::unique_ptr<Material> mMaterial_;
 };
 
+template<>
+struct VertexTraits<Font::FontVertex> {
+    static constexpr std::array attributes = {
+        CLAY_VERTEX_ATTRIBUTE(Font::FontVertex, vertex),
+        CLAY_VERTEX_ATTRIBUTE(Font::FontVertex, glyphIndex)
+    };
+};
+
 } // namespace clay
\ No newline at end of file
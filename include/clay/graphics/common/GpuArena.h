@@ -0,0 +1,77 @@
+#pragma once
+// standard lib
+#include <cstdint>
+#include <vector>
+// third party
+#include <vulkan/vulkan.hpp>
+// clay
+#include "clay/graphics/common/BaseGraphicsContext.h"
+
+namespace clay {
+
+/**
+ * Linear allocator for the device local memory of one scene. While the arena is active in the
+ * BaseGraphicsContext, buffers and images are bound into a few large blocks instead of getting an
+ * allocation each, and BaseGraphicsContext::freeMemory leaves those blocks alone. Ranges are not reused
+ * until the arena is destroyed, which frees every block once the frames in flight are done with them.
+ *
+ * Buffers and optimally tiled images are kept in separate blocks so bufferImageGranularity never applies
+ */
+class GpuArena {
+public:
+    static constexpr vk::DeviceSize DEFAULT_BLOCK_SIZE = vk::DeviceSize{64} << 20;
+
+    struct Allocation {
+        vk::DeviceMemory memory;
+        vk::DeviceSize offset;
+    };
+
+    /** Makes the arena active for the lifetime of the scope, then restores the previous one. nullptr changes nothing */
+    class Scope {
+    public:
+        Scope(BaseGraphicsContext& gContext, GpuArena* pArena);
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        ~Scope();
+
+    private:
+        BaseGraphicsContext& mGraphicsContext_;
+        GpuArena* mpPrevious_;
+    };
+
+    explicit GpuArena(BaseGraphicsContext& gContext, vk::DeviceSize blockSize = DEFAULT_BLOCK_SIZE);
+
+    GpuArena(const GpuArena&) = delete;
+    GpuArena& operator=(const GpuArena&) = delete;
+
+    ~GpuArena();
+
+    /** linearResource is true for buffers and linearly tiled images */
+    Allocation allocate(const vk::MemoryRequirements& requirements, uint32_t memoryTypeIndex, bool linearResource);
+
+    /** Bytes handed out, alignment padding included */
+    vk::DeviceSize getAllocatedBytes() const;
+
+    /** Bytes of every block */
+    vk::DeviceSize getReservedBytes() const;
+
+    uint32_t getBlockCount() const;
+
+private:
+    struct Block {
+        vk::DeviceMemory memory;
+        vk::DeviceSize size;
+        vk::DeviceSize used;
+        uint32_t memoryTypeIndex;
+        bool linearResources;
+    };
+
+    BaseGraphicsContext& mGraphicsContext_;
+    vk::DeviceSize mBlockSize_;
+    std::vector<Block> mBlocks_;
+    vk::DeviceSize mAllocatedBytes_ = 0;
+};
+
+} // namespace clay
@@ -66,14 +66,25 @@ public:
     vk::DescriptorSetLayout getDescriptorSetLayout() const;
 
     const vk::DescriptorSet& getDescriptorSet() const;
+
+    /**
+     * Points every binding of oldView at newView. A new descriptor set is written since the current one may
+     * be in use by frames in flight, the old set is freed once they finish. Returns false if oldView is unused
+     */
+    bool replaceImageView(vk::ImageView oldView, vk::ImageView newView);
     
 private:
-    void createDescriptorSet(const MaterialConfig& config);
+    void createDescriptorSet();
 
     BaseGraphicsContext& mGraphicsContext_;
     PipelineResource& mPipelineResource_; // TODO i think this should be a handle?
     vk::DescriptorSet mDescriptorSet_;
 
+    // kept to rewrite the descriptor set when an image is replaced
+    std::vector<BufferBindingInfo> mBufferBindings_;
+    std::vector<ImageBindingInfo> mImageBindings_;
+    std::vector<ImageBindingInfo> mImageArrayBindings_;
+
     std::vector<UniformBuffer> mUniformBuffers_;
 };
 
@@ -4,17 +4,42 @@
 // third party
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/gtc/type_precision.hpp>
 // clay
 #include "clay/utils/common/Utils.h"
 #include "clay/graphics/common/Material.h"
 #include "clay/graphics/common/BaseGraphicsContext.h"
 #include "clay/graphics/common/Camera.h"
+#include "clay/graphics/common/VertexLayout.h"
 
 namespace clay {
 
-// TODO template with vertex type?
+/**
+ * Indexed geometry in a single vertex buffer. The vertex type is erased into a VertexLayout so any vertex
+ * struct with VertexTraits can be uploaded
+ */
 class Mesh {
 public:
+    /** Layout the vertices are encoded with when uploaded to the GPU */
+    enum class VertexEncoding : uint8_t {
+        FULL = 0,   // Vertex, 56 bytes
+        COMPACT,    // CompactVertex, 24 bytes
+        QUANTIZED,  // QuantizedVertex, 20 bytes
+        CUSTOM      // caller supplied VertexLayout, see getVertexLayout
+    };
+
+    /** Encoding of the texture coordinates for the COMPACT and QUANTIZED layouts */
+    enum class TexCoordEncoding : uint8_t {
+        HALF_FLOAT = 0, // any range
+        UNORM16         // must be within [0, 1]
+    };
+
+    struct VertexFormat {
+        VertexEncoding encoding = VertexEncoding::FULL;
+        TexCoordEncoding texCoordEncoding = TexCoordEncoding::HALF_FLOAT;
+    };
+
     struct Vertex {
         glm::vec3 position;
         glm::vec3 normal;
@@ -23,22 +48,100 @@ public:
         glm::vec3 bitangent;
 
         static vk::VertexInputBindingDescription getBindingDescription();
-        
+
         static std::array<vk::VertexInputAttributeDescription, 5> getAttributeDescriptions();
     };
 
-    static void parseObjFile(BaseGraphicsContext& gContext, utils::FileData& fileData, std::vector<Mesh>& meshList);
+    /**
+     * Normal and tangent are octahedral encoded snorm16 pairs. The bitangent sign is folded into the
+     * tangent y: sign = y >= 0 ? 1 : -1, octahedral y = abs(y) * 2 - 1. The shader rebuilds the
+     * bitangent as cross(normal, tangent) * sign
+     */
+    struct CompactVertex {
+        glm::vec3 position;
+        glm::i16vec2 normal;
+        glm::i16vec2 tangent;
+        glm::u16vec2 texCoord;
+    };
+
+    /** CompactVertex with unorm16 positions. Position = getDequantizeTransform() * position.xyz */
+    struct QuantizedVertex {
+        glm::u16vec4 position; // w is padding
+        glm::i16vec2 normal;
+        glm::i16vec2 tangent;
+        glm::u16vec2 texCoord;
+    };
+
+    /** Range of the index buffer imported from one mesh of a file, indices are relative to the whole buffer */
+    struct SubMesh {
+        uint32_t firstIndex;
+        uint32_t indexCount;
+        glm::mat4 transform; // node transform from the file
+    };
+
+    struct ImportOptions {
+        VertexFormat vertexFormat{};
+        // weld duplicate vertices and reorder for vertex cache, overdraw and vertex fetch. Off by default since
+        // it changes the vertex and index order callers may rely on
+        bool optimize = false;
+        // allowed vertex cache loss when sorting clusters for overdraw, 1.05 = 5%
+        float overdrawThreshold = 1.05f;
+        // use 16 bit indices for meshes with fewer than 65536 vertices
+        bool allowShortIndices = true;
+    };
+
+    /** CPU side result of importing a model file, safe to produce off the render thread */
+    struct ImportedModel {
+        std::vector<Vertex> vertices;
+        std::vector<unsigned int> indices;
+        std::vector<SubMesh> subMeshes;
+    };
+
+    /** Throws for CUSTOM, which has no fixed layout */
+    static vk::VertexInputBindingDescription getBindingDescription(const VertexFormat& format);
+
+    /**
+     * Attribute descriptions for a vertex format. Locations are 0 position, 1 normal, 2 texCoord, 3 tangent
+     * and 4 bitangent (FULL only). Throws for CUSTOM
+     */
+    static std::vector<vk::VertexInputAttributeDescription> getAttributeDescriptions(const VertexFormat& format);
+
+    static void parseObjFile(BaseGraphicsContext& gContext, utils::FileData& fileData, std::vector<Mesh>& meshList, const ImportOptions& options = {});
+
+    /** Imports every mesh in the file into one shared vertex and index buffer with one SubMesh each */
+    static Mesh parseModelFile(BaseGraphicsContext& gContext, utils::FileData& fileData, const ImportOptions& options = {});
+
+    /** The decoding half of parseModelFile, touches no GPU state */
+    static ImportedModel importModelFile(const utils::FileData& fileData, const ImportOptions& options = {});
+
+    /** The upload half of parseModelFile */
+    static Mesh createFromImport(BaseGraphicsContext& gContext, const ImportedModel& model, const ImportOptions& options = {});
+
+    /** Bump whenever importModelFile output changes so derived data cached by older versions is not used */
+    static constexpr uint32_t IMPORT_VERSION = 2;
+
+    /** Flattens an import for utils::DerivedDataCache */
+    static std::vector<uint8_t> serializeImport(const ImportedModel& model);
+
+    /** Inverse of serializeImport, throws on truncated data */
+    static ImportedModel deserializeImport(const utils::FileData& data);
 
     Mesh(BaseGraphicsContext& gContext);
 
-    Mesh(BaseGraphicsContext& gContext, const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices);
+    Mesh(BaseGraphicsContext& gContext, const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, const VertexFormat& format = {}, bool allowShortIndices = false);
+
+    Mesh(BaseGraphicsContext& gContext, const VertexLayout& layout, const void* vertexData, vk::DeviceSize vertexDataSize, const std::vector<unsigned int>& indices, bool allowShortIndices = false);
+
+    template<typename VertexT>
+    Mesh(BaseGraphicsContext& gContext, const std::vector<VertexT>& vertices, const std::vector<unsigned int>& indices, bool allowShortIndices = false)
+        : Mesh(gContext, VertexLayout::of<VertexT>(), vertices.data(), sizeof(VertexT) * vertices.size(), indices, allowShortIndices) {}
 
     // move constructor
     Mesh(Mesh&& other) noexcept;
 
     // move assignment
     Mesh& operator=(Mesh&& other) noexcept;
-    
+
     ~Mesh();
 
     void bindMesh(vk::CommandBuffer cmdBuffer);
@@ -49,11 +152,29 @@ public:
 
     uint32_t getIndicesCount() const;
 
+    vk::IndexType getIndexType() const;
+
+    const std::vector<SubMesh>& getSubMeshes() const;
+
+    uint32_t getVertexCount() const;
+
+    const VertexLayout& getVertexLayout() const;
+
+    /** CUSTOM when created from a caller supplied layout, pipelines must then use getVertexLayout */
+    const VertexFormat& getVertexFormat() const;
+
+    /** Maps quantized positions back to model space. Identity unless the encoding is QUANTIZED */
+    const glm::mat4& getDequantizeTransform() const;
+
+    /** Device memory held by the vertex and index buffers */
+    vk::DeviceSize getMemorySize() const;
 
 private:
     void createVertexBuffer(const std::vector<Vertex>& vertices);
 
-    void createIndexBuffer(const std::vector<unsigned int>& indices);
+    void createVertexBuffer(const void* vertexData, vk::DeviceSize bufferSize);
+
+    void createIndexBuffer(const std::vector<unsigned int>& indices, bool allowShortIndices);
 
     void finalize();
 
@@ -61,10 +182,49 @@ private:
     BaseGraphicsContext& mGraphicsContext_;
 
     uint32_t mIndicesCount_ = 0;
+    uint32_t mVertexCount_ = 0;
     vk::Buffer mVertexBuffer_{};
     vk::DeviceMemory mVertexBufferMemory_{};
     vk::Buffer mIndexBuffer_{};
     vk::DeviceMemory mIndexBufferMemory_{};
+    vk::IndexType mIndexType_ = vk::IndexType::eUint32;
+    std::vector<SubMesh> mSubMeshes_;
+
+    VertexLayout mVertexLayout_{};
+    VertexFormat mVertexFormat_{};
+    glm::mat4 mDequantizeTransform_ = glm::mat4(1.0f);
+};
+
+template<>
+struct VertexTraits<Mesh::Vertex> {
+    static constexpr std::array attributes = {
+        CLAY_VERTEX_ATTRIBUTE(Mesh::Vertex, position),
+        CLAY_VERTEX_ATTRIBUTE(Mesh::Vertex, normal),
+        CLAY_VERTEX_ATTRIBUTE(Mesh::Vertex, texCoord),
+        CLAY_VERTEX_ATTRIBUTE(Mesh::Vertex, tangent),
+        CLAY_VERTEX_ATTRIBUTE(Mesh::Vertex, bitangent)
+    };
+};
+
+// texCoord defaults to half float, Mesh::getAttributeDescriptions swaps in unorm16 when requested
+template<>
+struct VertexTraits<Mesh::CompactVertex> {
+    static constexpr std::array attributes = {
+        CLAY_VERTEX_ATTRIBUTE(Mesh::CompactVertex, position),
+        CLAY_VERTEX_ATTRIBUTE(Mesh::CompactVertex, normal),
+        CLAY_VERTEX_ATTRIBUTE_FORMAT(Mesh::CompactVertex, texCoord, vk::Format::eR16G16Sfloat),
+        CLAY_VERTEX_ATTRIBUTE(Mesh::CompactVertex, tangent)
+    };
+};
+
+template<>
+struct VertexTraits<Mesh::QuantizedVertex> {
+    static constexpr std::array attributes = {
+        CLAY_VERTEX_ATTRIBUTE(Mesh::QuantizedVertex, position),
+        CLAY_VERTEX_ATTRIBUTE(Mesh::QuantizedVertex, normal),
+        CLAY_VERTEX_ATTRIBUTE_FORMAT(Mesh::QuantizedVertex, texCoord, vk::Format::eR16G16Sfloat),
+        CLAY_VERTEX_ATTRIBUTE(Mesh::QuantizedVertex, tangent)
+    };
 };
 
-} // namespace clay
\ No newline at end of file
+} // namespace clay
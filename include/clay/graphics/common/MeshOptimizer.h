@@ -0,0 +1,72 @@
+#pragma once
+// standard lib
+#include <cstddef>
+#include <vector>
+// third party
+#include <glm/vec3.hpp>
+
+namespace clay::mesh_optimizer {
+
+/** Marks a vertex that is not referenced by any index in a remap table */
+constexpr unsigned int UNUSED_VERTEX = ~0u;
+
+/**
+ * Builds a remap table that merges bitwise identical vertices. remap[oldIndex] is the new index.
+ * The vertex type must not contain padding. Returns the number of unique vertices
+ */
+size_t generateWeldRemap(std::vector<unsigned int>& remap, const void* vertexData, size_t vertexCount, size_t vertexStride);
+
+/**
+ * Builds a remap table that orders vertices by first use in the index buffer so vertex fetch walks
+ * memory linearly. Unreferenced vertices map to UNUSED_VERTEX. Returns the number of referenced vertices
+ */
+size_t generateFetchRemap(std::vector<unsigned int>& remap, const std::vector<unsigned int>& indices, size_t vertexCount);
+
+void remapIndices(std::vector<unsigned int>& indices, const std::vector<unsigned int>& remap);
+
+template<typename VertexT>
+void remapVertices(std::vector<VertexT>& vertices, const std::vector<unsigned int>& remap, size_t newVertexCount) {
+    std::vector<VertexT> remapped(newVertexCount);
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        if (remap[i] != UNUSED_VERTEX) {
+            remapped[remap[i]] = vertices[i];
+        }
+    }
+    vertices = std::move(remapped);
+}
+
+/** Reorders triangles for post-transform vertex cache reuse (Forsyth's linear-speed algorithm) */
+void optimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount);
+
+/**
+ * Reorders clusters of a cache optimized index buffer so outward facing clusters draw first and occlude
+ * the rest. threshold is how much worse (1.05 = 5%) the vertex cache is allowed to get to gain more
+ * clusters to sort
+ */
+void optimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<glm::vec3>& positions, float threshold = 1.05f);
+
+/** Average cache misses per triangle for a FIFO cache, 0.5 is ideal and 3.0 is no reuse */
+float computeACMR(const std::vector<unsigned int>& indices, size_t vertexCount, size_t cacheSize = 16);
+
+/** Runs weld, vertex cache, overdraw and vertex fetch optimizations. VertexT needs a glm::vec3 position */
+template<typename VertexT>
+void optimizeMesh(std::vector<VertexT>& vertices, std::vector<unsigned int>& indices, float overdrawThreshold = 1.05f) {
+    std::vector<unsigned int> remap;
+    size_t vertexCount = generateWeldRemap(remap, vertices.data(), vertices.size(), sizeof(VertexT));
+    remapIndices(indices, remap);
+    remapVertices(vertices, remap, vertexCount);
+
+    optimizeVertexCache(indices, vertices.size());
+
+    std::vector<glm::vec3> positions(vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        positions[i] = vertices[i].position;
+    }
+    optimizeOverdraw(indices, positions, overdrawThreshold);
+
+    vertexCount = generateFetchRemap(remap, indices, vertices.size());
+    remapIndices(indices, remap);
+    remapVertices(vertices, remap, vertexCount);
+}
+
+} // namespace clay::mesh_optimizer
@@ -0,0 +1,54 @@
+#pragma once
+// standard lib
+#include <cstdint>
+#include <vector>
+// third party
+#include <glm/vec3.hpp>
+
+namespace clay {
+
+/**
+ * A small cluster of triangles. Triangles are taken from the index buffer in order, so a meshlet is also the
+ * contiguous index range [triangleOffset * 3, (triangleOffset + triangleCount) * 3) of the source mesh
+ */
+struct Meshlet {
+    static constexpr uint32_t MAX_VERTICES = 64;
+    static constexpr uint32_t MAX_TRIANGLES = 124;
+
+    uint32_t vertexOffset;   // into MeshletData::vertices
+    uint32_t triangleOffset; // in triangles, into MeshletData::triangles and the source index buffer
+    uint32_t vertexCount;
+    uint32_t triangleCount;
+};
+
+/**
+ * Culling bounds of a meshlet. The meshlet is backfacing from cameraPosition when
+ * dot(center - cameraPosition, coneAxis) >= coneCutoff * length(center - cameraPosition) + radius
+ */
+struct MeshletBounds {
+    glm::vec3 center;
+    float radius;
+    glm::vec3 coneAxis;
+    float coneCutoff; // 1 when the normals spread too wide to ever cull
+};
+
+struct MeshletData {
+    std::vector<Meshlet> meshlets;
+    std::vector<MeshletBounds> bounds;
+    // mesh vertex index of each meshlet vertex, for mesh shaders
+    std::vector<uint32_t> vertices;
+    // 3 meshlet local vertex indices per triangle, for mesh shaders
+    std::vector<uint8_t> triangles;
+};
+
+/** Splits an index buffer into meshlets. Run after mesh_optimizer::optimizeVertexCache for tight meshlets */
+MeshletData buildMeshlets(
+    const std::vector<unsigned int>& indices,
+    const std::vector<glm::vec3>& positions,
+    uint32_t maxVertices = Meshlet::MAX_VERTICES,
+    uint32_t maxTriangles = Meshlet::MAX_TRIANGLES
+);
+
+MeshletBounds computeMeshletBounds(const MeshletData& data, const Meshlet& meshlet, const std::vector<glm::vec3>& positions);
+
+} // namespace clay
@@ -2,6 +2,7 @@
 // standard lib
 #include <vector>
 // clay
+#include "clay/application/common/ResourceHandle.h"
 #include "clay/graphics/common/Material.h"
 #include "clay/graphics/common/BaseGraphicsContext.h"
 #include "clay/graphics/common/Camera.h"
@@ -10,13 +11,17 @@
 
 namespace clay {
 
+class Resources;
+class ClusterCuller;
+
 class Model {
 
 public:
     struct ModelElement {
-        Mesh* mesh; // TODO use id instead
+        ResourceHandle<Mesh> mesh; // resolved on every render, so reloads and pool growth are picked up
         Material* material; // TODO use id instead
         glm::mat4 localTransform = glm::mat4(1); // TODO maybe replace with instance data(mode, color) that is dynamically sized
+        uint32_t subMeshIndex = 0; // part of the mesh to draw, see Mesh::getSubMeshes
     };
 
     Model(BaseGraphicsContext& gContext);
@@ -31,7 +36,23 @@ public:
 
     void addElement(const ModelElement& element);
 
-    void render(vk::CommandBuffer cmdBuffer, const void* userPushData, uint32_t userPushSize);
+    /** One element per sub-mesh of mesh, using the sub-mesh node transforms */
+    void addSubMeshes(Resources& resources, ResourceHandle<Mesh> mesh, Material* material);
+
+    /** Sets the material of every element */
+    void setMaterial(Material* material);
+
+    /**
+     * Draws every element whose mesh is ready. Elements without a material, or whose sub-mesh no longer
+     * exists after a reload, are skipped
+     */
+    void render(Resources& resources, vk::CommandBuffer cmdBuffer, const void* userPushData, uint32_t userPushSize);
+
+    /**
+     * Draws the whole mesh through culler with the first drawable element's material. The culler covers
+     * every sub-mesh at once, so element transforms are not applied. Its cull must already be recorded
+     */
+    void render(Resources& resources, ClusterCuller& culler, vk::CommandBuffer cmdBuffer, const void* userPushData, uint32_t userPushSize);
 
 private:
     BaseGraphicsContext& mGraphicsContext_;
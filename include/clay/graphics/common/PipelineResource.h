@@ -22,6 +22,7 @@ public:
         vk::PipelineDepthStencilStateCreateInfo depthStencilState{};
         vk::PipelineRasterizationStateCreateInfo rasterizerState{};
         std::vector<vk::PushConstantRange> pushConstants;
+        bool premultipliedAlpha = false; // blend color with factor one, for premultiplied textures
     };
 
     struct PipelineConfig {
@@ -30,6 +31,7 @@ public:
         DescriptorSetLayoutInfo bindingLayoutInfo;
     };
 
+    /** Creates a compute pipeline when the only shader is a compute shader, otherwise a graphics pipeline */
     PipelineResource(const PipelineConfig& config);
 
     // move constructor
@@ -46,17 +48,24 @@ public:
 
     const vk::DescriptorSetLayout& getDescriptorSetLayout() const;
 
+    vk::PipelineBindPoint getBindPoint() const;
+
 private:
     void createDescriptorSetLayout(const PipelineConfig& config);
 
+    void createPipelineLayout(const PipelineConfig& config);
+
     void createPipeline(const PipelineConfig& config);
 
+    void createComputePipeline(const PipelineConfig& config);
+
     void finalize();
 
     BaseGraphicsContext& mGraphicsContext_;
     vk::PipelineLayout mPipelineLayout_;
     vk::Pipeline mPipeline_;
     vk::DescriptorSetLayout mDescriptorSetLayout_;
+    vk::PipelineBindPoint mBindPoint_ = vk::PipelineBindPoint::eGraphics;
 };
 
 } // namespace clay
\ No newline at end of file
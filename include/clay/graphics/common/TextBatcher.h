@@ -0,0 +1,105 @@
+#pragma once
+// standard lib
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+// third party
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+#include <glm/gtc/type_precision.hpp>
+// clay
+#include "clay/graphics/common/BaseGraphicsContext.h"
+#include "clay/graphics/common/Font.h"
+#include "clay/graphics/common/Material.h"
+#include "clay/graphics/common/PipelineResource.h"
+#include "clay/graphics/common/ShaderModule.h"
+#include "clay/graphics/common/UniformBuffer.h"
+#include "clay/graphics/common/VertexLayout.h"
+
+namespace clay {
+
+/**
+ * Collects the glyphs of every text drawn in a frame and records one instanced draw per font. Each glyph
+ * is a single instance holding its world space corner and edges, so texts with different transforms share
+ * a draw and no text needs a vertex buffer of its own. Instances are written to a persistently mapped
+ * buffer with one region per frame in flight. Fonts drawn through the batcher must outlive it.
+ *
+ * The shaders are supplied by the application and use:
+ *   binding 0: the camera uniform buffer, vertex stage
+ *   binding 1: the font atlas, fragment stage, sampled as for Font
+ *   per instance inputs: GlyphInstance, locations 0 to 4
+ *   6 vertices per instance, gl_VertexIndex 0..5 at corners (0,0) (1,0) (1,1) (0,0) (1,1) (0,1),
+ *   position = origin + corner.x * axisX + corner.y * axisY,
+ *   uv = uvRect.xy + vec2(corner.x, 1 - corner.y) * uvRect.zw
+ */
+class TextBatcher {
+public:
+    struct GlyphInstance {
+        glm::vec4 origin; // world space bottom left, w = 1
+        glm::vec4 axisX;  // world space bottom edge
+        glm::vec4 axisY;  // world space left edge
+        glm::vec4 uvRect;
+        glm::u8vec4 color; // unorm
+
+        static vk::VertexInputBindingDescription getBindingDescription();
+
+        static std::array<vk::VertexInputAttributeDescription, 5> getAttributeDescriptions();
+    };
+
+    TextBatcher(BaseGraphicsContext& gContext, ShaderModule& vertShader, ShaderModule& fragShader, UniformBuffer& uniformBuffer);
+
+    TextBatcher(const TextBatcher&) = delete;
+    TextBatcher& operator=(const TextBatcher&) = delete;
+
+    ~TextBatcher();
+
+    /** Queues the glyphs of one text for the next draw. modelMatrix maps text space pixels to world space */
+    void add(const Font& font, const std::vector<Font::GlyphQuad>& glyphs, const glm::mat4& modelMatrix, const glm::vec4& color);
+
+    /** Writes the queued glyphs to this frame's region and records one draw per font, then clears the queue */
+    void draw(vk::CommandBuffer cmdBuffer);
+
+    /** Glyphs drawn by the last draw call */
+    uint32_t getDrawnGlyphCount() const;
+
+private:
+    static constexpr uint32_t kInitialCapacity = 4096;
+
+    struct FontBatch {
+        std::unique_ptr<Material> material;
+        std::vector<GlyphInstance> instances;
+    };
+
+    /** Grows every frame region to hold glyphCount instances past what this frame already wrote */
+    void reserve(uint32_t glyphCount);
+
+    BaseGraphicsContext& mGraphicsContext_;
+    UniformBuffer& mUniformBuffer_;
+    std::unique_ptr<PipelineResource> mPipeline_;
+
+    std::unordered_map<const Font*, FontBatch> mBatches_;
+
+    vk::Buffer mInstanceBuffer_;
+    vk::DeviceMemory mInstanceMemory_;
+    GlyphInstance* mpMapped_ = nullptr;
+    uint32_t mCapacity_ = 0; // instances per frame region
+
+    // several draws in one frame, such as one per eye, append after each other
+    uint64_t mLastFrameIndex_ = UINT64_MAX;
+    uint32_t mFrameUsed_ = 0;
+    uint32_t mDrawnGlyphCount_ = 0;
+};
+
+template<>
+struct VertexTraits<TextBatcher::GlyphInstance> {
+    static constexpr std::array attributes = {
+        CLAY_VERTEX_ATTRIBUTE(TextBatcher::GlyphInstance, origin),
+        CLAY_VERTEX_ATTRIBUTE(TextBatcher::GlyphInstance, axisX),
+        CLAY_VERTEX_ATTRIBUTE(TextBatcher::GlyphInstance, axisY),
+        CLAY_VERTEX_ATTRIBUTE(TextBatcher::GlyphInstance, uvRect),
+        CLAY_VERTEX_ATTRIBUTE(TextBatcher::GlyphInstance, color)
+    };
+};
+
+} // namespace clay
@@ -17,23 +17,59 @@ public:
 
     ~Texture();
 
-    void initialize(utils::ImageData& imageData);
+    /** Uploads the image as R8G8B8A8 sRGB, expanding it in place if needed, with a full mip chain unless generateMipmaps is false */
+    void initialize(utils::ImageData& imageData, bool generateMipmaps = true);
+
+    /**
+     * Uploads precomputed, possibly block compressed, levels as is starting at firstLevel, blitting the rest
+     * of the chain when textureData.generateMipmaps is set and the format allows it. When the texture
+     * already has an image it is swapped for the new one and the old one is destroyed once no frame in
+     * flight can sample it. Materials holding the old image view must be rebuilt, see Material::replaceImageView
+     */
+    void initialize(const utils::TextureData& textureData, uint32_t firstLevel = 0);
+
+    /**
+     * Shares the image of source through an image view of its own, which is all this texture destroys.
+     * source must outlive this texture
+     */
+    void initializeView(const Texture& source);
+
+    /** Overwrites part of mip 0 with tightly packed texels of the texture's uncompressed format */
+    void updateRegion(const void* pixels, uint32_t x, uint32_t y, uint32_t width, uint32_t height);
 
     void setSampler(vk::Sampler sampler);
 
     vk::ImageView getImageView() const;
 
     vk::Sampler getSampler() const;
-    
+
+    uint32_t getMipLevels() const;
+
+    vk::Format getFormat() const;
+
+    /** Set from TextureData, pipelines drawing the texture blend with PipelineLayoutInfo::premultipliedAlpha */
+    bool isPremultipliedAlpha() const;
+
+    /** Device memory held by the image */
+    vk::DeviceSize getMemorySize() const;
+
     void finalize();
 
 private:
+    /** Hands the current image to deferDestroy before a re-initialization, frames in flight may still sample it */
+    void retireImage();
+
     BaseGraphicsContext& mGraphicsContext_;
 
     vk::Image mImage_;
     vk::DeviceMemory mImageMemory_;
     vk::ImageView mImageView_;
     vk::Sampler mSampler_; // does not own
+    uint32_t mMipLevels_ = 1;
+    vk::Format mFormat_ = vk::Format::eR8G8B8A8Srgb;
+    vk::DeviceSize mMemorySize_ = 0;
+    bool mPremultipliedAlpha_ = false;
+    bool mOwnsImage_ = true; // false for views made by initializeView
 
 };
 
@@ -0,0 +1,75 @@
+#pragma once
+// standard lib
+#include <cstdint>
+#include <vector>
+// third party
+#include <glm/vec4.hpp>
+// clay
+#include "clay/graphics/common/BaseGraphicsContext.h"
+#include "clay/graphics/common/Texture.h"
+#include "clay/utils/common/RectPacker.h"
+#include "clay/utils/common/Utils.h"
+
+namespace clay {
+
+/**
+ * Packs many small images into a few shared textures at load time. Sprites that use regions of the same
+ * page can share one Material and so one descriptor set, and the RenderSystem skips rebinding it between
+ * them. Images that do not fit in the current page start a new one.
+ *
+ * Each region is surrounded by padding filled with its own edge pixels so bilinear filtering and small mips
+ * do not pick up a neighbour.
+ */
+class TextureAtlas {
+public:
+    using RegionId = uint32_t;
+
+    struct Config {
+        uint32_t pageSize = 2048;
+        uint32_t padding = 2;
+        bool generateMipmaps = false; // mips past log2(padding) bleed between regions
+    };
+
+    struct Region {
+        uint32_t page;
+        glm::vec4 uvRect; // xy = top left uv, zw = uv size, the SpriteRenderable::mSpriteOffset_ layout
+        uint32_t x;
+        uint32_t y;
+        uint32_t width;
+        uint32_t height;
+    };
+
+    TextureAtlas(BaseGraphicsContext& gContext, const Config& config);
+
+    TextureAtlas(const TextureAtlas&) = delete;
+    TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+    /** Queues an image, any channel count. The region is valid after build() */
+    RegionId add(utils::ImageData&& image);
+
+    /** Packs every queued image, tallest first, uploads the pages and releases the CPU copies */
+    void build();
+
+    const Region& getRegion(RegionId id) const;
+
+    uint32_t getPageCount() const;
+
+    Texture& getPage(uint32_t page);
+
+    /** Fraction of each page covered by images, padding excluded */
+    float getOccupancy(uint32_t page) const;
+
+private:
+    void blit(const utils::ImageData& image, const Region& region, uint8_t* pagePixels) const;
+
+    BaseGraphicsContext& mGraphicsContext_;
+    Config mConfig_;
+    bool mBuilt_ = false;
+
+    std::vector<utils::ImageData> mPendingImages_;
+    std::vector<Region> mRegions_;
+    std::vector<Texture> mPages_;
+    std::vector<float> mOccupancy_;
+};
+
+} // namespace clay
@@ -0,0 +1,121 @@
+#pragma once
+// standard lib
+#include <cstdint>
+#include <vector>
+// third party
+#include <glm/mat4x4.hpp>
+// clay
+#include "clay/graphics/common/BaseGraphicsContext.h"
+#include "clay/graphics/common/Material.h"
+#include "clay/graphics/common/Texture.h"
+#include "clay/utils/common/Utils.h"
+
+namespace clay {
+
+/**
+ * Keeps registered textures resident at the mip level the renderer asks for, within a device memory budget.
+ *
+ * Registration uploads only the mip tail (levels no larger than Config::tailSize). Each frame the renderer
+ * reports how many pixels a texture covers on screen, and update() picks a target first level per texture:
+ * the level whose size matches the coverage, lowered for the least recently used and smallest on screen
+ * textures until the total fits the budget. Textures not reported for Config::idleFrames drop back to the
+ * tail. Changing the level rebuilds the image from the CPU copy of the levels, swaps it into the Texture
+ * and rewrites the registered Materials; the old image is released once no frame in flight uses it.
+ */
+class TextureStreamer {
+public:
+    using StreamId = uint32_t;
+
+    /** Components use it for a texture that is not streamed */
+    static constexpr StreamId NO_STREAM = UINT32_MAX;
+
+    struct Config {
+        vk::DeviceSize budgetBytes = 256ull * 1024 * 1024;
+        uint32_t tailSize = 64;          // levels this size and smaller are always resident
+        uint32_t maxUploadsPerFrame = 4; // upgrades per update(), evictions are not limited
+        uint32_t idleFrames = 60;
+    };
+
+    TextureStreamer(BaseGraphicsContext& gContext, const Config& config);
+
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    /** Uploads the mip tail of source into texture. texture must outlive the registration */
+    StreamId registerTexture(Texture& texture, utils::TextureData&& source);
+
+    /** The texture keeps its current image */
+    void unregisterTexture(StreamId id);
+
+    /** material's bindings of the texture are rewritten whenever its image is swapped */
+    void addMaterial(StreamId id, Material& material);
+
+    /** Renderer feedback, screenPixels is the texture's footprint along its larger axis. Keeps the largest per frame */
+    void reportUsage(StreamId id, float screenPixels);
+
+    /**
+     * reportUsage from the footprint of a unit sized object drawn with model under the view set by setView.
+     * Objects behind the camera are not reported
+     */
+    void reportUsage(StreamId id, const glm::mat4& model);
+
+    /** Camera the model matrix overload of reportUsage measures against, set once per frame before drawing */
+    void setView(const glm::mat4& view, const glm::mat4& projection, float viewportHeight);
+
+    /**
+     * Evicts and uploads mips to follow the reported usage. Call once per frame outside of command recording.
+     * Replaced images stay allocated until no frame in flight uses them, so an upload is postponed while
+     * it would push the resident and not yet freed bytes over the budget
+     */
+    void update();
+
+    uint32_t getResidentLevel(StreamId id) const;
+
+    vk::DeviceSize getResidentBytes() const;
+
+    vk::DeviceSize getBudget() const;
+
+    void setBudget(vk::DeviceSize budgetBytes);
+
+private:
+    struct Entry {
+        Texture* texture = nullptr;
+        utils::TextureData source;
+        std::vector<Material*> materials;
+        uint32_t tailLevel = 0;     // first level of the always resident tail
+        uint32_t residentLevel = 0; // first level currently in the image
+        float screenPixels = 0.0f;
+        uint64_t lastUsedFrame = 0;
+        bool active = false;
+    };
+
+    /** An image replaced by makeResident, its memory is freed MAX_FRAMES_IN_FLIGHT frames later */
+    struct PendingFree {
+        uint64_t frameIndex = 0;
+        vk::DeviceSize bytes = 0;
+    };
+
+    Entry& getEntry(StreamId id);
+
+    const Entry& getEntry(StreamId id) const;
+
+    /** Bytes of levels [firstLevel, end), a close estimate of the image allocation */
+    static vk::DeviceSize levelBytes(const Entry& entry, uint32_t firstLevel);
+
+    uint32_t wantedLevel(const Entry& entry) const;
+
+    void makeResident(Entry& entry, uint32_t firstLevel);
+
+    BaseGraphicsContext& mGraphicsContext_;
+    Config mConfig_;
+    std::vector<Entry> mEntries_;
+    std::vector<StreamId> mFreeIds_;
+    vk::DeviceSize mResidentBytes_ = 0;
+    std::vector<PendingFree> mPendingFrees_;
+    vk::DeviceSize mPendingBytes_ = 0;
+    glm::mat4 mView_ = glm::mat4(1.0f);
+    glm::mat4 mProjection_ = glm::mat4(1.0f);
+    float mViewportHeight_ = 0.0f;
+};
+
+} // namespace clay
@@ -0,0 +1,104 @@
+#pragma once
+// standard lib
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+// third party
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <glm/gtc/type_precision.hpp>
+#include <vulkan/vulkan.hpp>
+
+namespace clay {
+
+/**
+ * Vulkan format for a vertex attribute C++ type. Small integer vectors are treated as normalized since
+ * integer vertex inputs are rare, use CLAY_VERTEX_ATTRIBUTE_FORMAT to override
+ */
+template<typename T>
+struct VertexAttributeFormat;
+
+template<> struct VertexAttributeFormat<float> { static constexpr vk::Format value = vk::Format::eR32Sfloat; };
+template<> struct VertexAttributeFormat<glm::vec2> { static constexpr vk::Format value = vk::Format::eR32G32Sfloat; };
+template<> struct VertexAttributeFormat<glm::vec3> { static constexpr vk::Format value = vk::Format::eR32G32B32Sfloat; };
+template<> struct VertexAttributeFormat<glm::vec4> { static constexpr vk::Format value = vk::Format::eR32G32B32A32Sfloat; };
+template<> struct VertexAttributeFormat<int32_t> { static constexpr vk::Format value = vk::Format::eR32Sint; };
+template<> struct VertexAttributeFormat<glm::ivec2> { static constexpr vk::Format value = vk::Format::eR32G32Sint; };
+template<> struct VertexAttributeFormat<glm::ivec4> { static constexpr vk::Format value = vk::Format::eR32G32B32A32Sint; };
+template<> struct VertexAttributeFormat<uint32_t> { static constexpr vk::Format value = vk::Format::eR32Uint; };
+template<> struct VertexAttributeFormat<glm::uvec2> { static constexpr vk::Format value = vk::Format::eR32G32Uint; };
+template<> struct VertexAttributeFormat<glm::uvec4> { static constexpr vk::Format value = vk::Format::eR32G32B32A32Uint; };
+template<> struct VertexAttributeFormat<glm::i16vec2> { static constexpr vk::Format value = vk::Format::eR16G16Snorm; };
+template<> struct VertexAttributeFormat<glm::i16vec4> { static constexpr vk::Format value = vk::Format::eR16G16B16A16Snorm; };
+template<> struct VertexAttributeFormat<glm::u16vec2> { static constexpr vk::Format value = vk::Format::eR16G16Unorm; };
+template<> struct VertexAttributeFormat<glm::u16vec4> { static constexpr vk::Format value = vk::Format::eR16G16B16A16Unorm; };
+template<> struct VertexAttributeFormat<glm::i8vec4> { static constexpr vk::Format value = vk::Format::eR8G8B8A8Snorm; };
+template<> struct VertexAttributeFormat<glm::u8vec4> { static constexpr vk::Format value = vk::Format::eR8G8B8A8Unorm; };
+
+struct VertexAttribute {
+    vk::Format format;
+    uint32_t offset;
+};
+
+/**
+ * Specialize for each vertex struct with a constexpr std::array<VertexAttribute, N> named attributes.
+ * The shader location of an attribute is its index in the array
+ */
+template<typename VertexT>
+struct VertexTraits;
+
+#define CLAY_VERTEX_ATTRIBUTE(VertexT, member)                                          \
+    ::clay::VertexAttribute{                                                            \
+        ::clay::VertexAttributeFormat<decltype(VertexT::member)>::value,                \
+        static_cast<uint32_t>(offsetof(VertexT, member))                                \
+    }
+
+#define CLAY_VERTEX_ATTRIBUTE_FORMAT(VertexT, member, vkFormat)                         \
+    ::clay::VertexAttribute{                                                            \
+        vkFormat,                                                                       \
+        static_cast<uint32_t>(offsetof(VertexT, member))                                \
+    }
+
+template<typename VertexT>
+constexpr vk::VertexInputBindingDescription makeBindingDescription(vk::VertexInputRate inputRate = vk::VertexInputRate::eVertex) {
+    return {
+        .binding = 0,
+        .stride = sizeof(VertexT),
+        .inputRate = inputRate
+    };
+}
+
+template<typename VertexT>
+constexpr auto makeAttributeDescriptions() {
+    constexpr auto attributes = VertexTraits<VertexT>::attributes;
+    std::array<vk::VertexInputAttributeDescription, attributes.size()> attributeDescriptions{};
+
+    for (uint32_t i = 0; i < attributes.size(); ++i) {
+        attributeDescriptions[i] = {
+            .location = i,
+            .binding = 0,
+            .format = attributes[i].format,
+            .offset = attributes[i].offset
+        };
+    }
+    return attributeDescriptions;
+}
+
+/** Runtime description of a vertex buffer, lets geometry be stored without knowing its vertex type */
+struct VertexLayout {
+    vk::VertexInputBindingDescription binding{};
+    std::vector<vk::VertexInputAttributeDescription> attributes;
+
+    template<typename VertexT>
+    static VertexLayout of(vk::VertexInputRate inputRate = vk::VertexInputRate::eVertex) {
+        const auto attributeDescriptions = makeAttributeDescriptions<VertexT>();
+        return {
+            .binding = makeBindingDescription<VertexT>(inputRate),
+            .attributes = {attributeDescriptions.begin(), attributeDescriptions.end()}
+        };
+    }
+};
+
+} // namespace clay
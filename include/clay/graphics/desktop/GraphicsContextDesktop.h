@@ -33,9 +33,6 @@ struct SwapChainSupportDetails {
 
 class GraphicsContextDesktop : public BaseGraphicsContext {
 public:
-    
-    static constexpr int MAX_FRAMES_IN_FLIGHT = 2;
-
     GraphicsContextDesktop(Window& window);
 
     ~GraphicsContextDesktop();
@@ -72,8 +69,6 @@ public:
 
     vk::ShaderModule createShaderModule(const utils::FileData& file);
 
-    void generateMipmaps(vk::Image image, vk::Format imageFormat, int32_t texWidth, int32_t texHeight, uint32_t mipLevels);
-
     void createRenderPass();
 
     vk::Format findSupportedFormat(const std::vector<vk::Format>& candidates, vk::ImageTiling tiling, vk::FormatFeatureFlags features);
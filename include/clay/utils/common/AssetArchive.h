@@ -0,0 +1,84 @@
+#pragma once
+// standard lib
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+// clay
+#include "clay/utils/common/Utils.h"
+
+namespace clay::utils {
+
+/**
+ * Clay packed asset archive (.cpak), written offline by tools/asset_packer. Many files are served from one
+ * open, usually memory mapped, file. Little endian layout:
+ *   header  AssetArchiveHeader
+ *   index   entryCount x AssetArchiveEntry, sorted by pathHash
+ *   blobs   each starts at a multiple of ASSET_ARCHIVE_ALIGNMENT
+ * Paths are hashed with hashString after normalizing to forward slashes, relative to the packed directory
+ */
+constexpr uint32_t ASSET_ARCHIVE_MAGIC = 0x4B504C43; // "CLPK"
+constexpr uint32_t ASSET_ARCHIVE_VERSION = 1;
+constexpr uint32_t ASSET_ARCHIVE_ALIGNMENT = 4096;
+
+enum class AssetCompression : uint32_t {
+    NONE = 0,
+    LZ4 = 1 // LZ4 block, see Lz4.h
+};
+
+struct AssetArchiveHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t reserved;
+};
+
+struct AssetArchiveEntry {
+    uint64_t pathHash;
+    uint64_t offset;
+    uint64_t storedSize; // bytes in the archive
+    uint64_t size;       // bytes once decompressed
+    AssetCompression compression;
+    uint32_t reserved;
+};
+
+class AssetArchive {
+public:
+    /** Validates the header and index, the archive bytes are kept for the lifetime of the object */
+    explicit AssetArchive(FileData&& archive);
+
+    AssetArchive(const AssetArchive&) = delete;
+    AssetArchive& operator=(const AssetArchive&) = delete;
+
+    static uint64_t hashPath(std::string_view path);
+
+    bool contains(std::string_view path) const;
+
+    /**
+     * Uncompressed entries are views into the archive with no copy, each keeps the archive bytes alive until
+     * it is freed, so it may outlive the archive. Compressed entries are decoded into a new buffer. Safe to
+     * call from several threads
+     */
+    FileData load(std::string_view path) const;
+
+    uint32_t getEntryCount() const;
+
+private:
+    const AssetArchiveEntry* find(uint64_t pathHash) const;
+
+    // shared with the views returned by load
+    std::shared_ptr<const FileData> mArchive_;
+    std::vector<AssetArchiveEntry> mEntries_;
+};
+
+struct AssetArchiveInput {
+    std::string path; // relative, forward or back slashes
+    std::vector<uint8_t> data;
+    bool compress = false; // stored raw anyway when LZ4 does not make it smaller
+};
+
+/** Serializes files into an archive, throws when two paths share a hash */
+std::vector<uint8_t> writeAssetArchive(const std::vector<AssetArchiveInput>& inputs);
+
+} // namespace clay::utils
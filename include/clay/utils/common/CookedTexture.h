@@ -0,0 +1,53 @@
+#pragma once
+// standard lib
+#include <cstdint>
+#include <vector>
+// clay
+#include "clay/utils/common/Utils.h"
+
+namespace clay::utils {
+
+/**
+ * Clay cooked texture (.ctex), written offline by tools/texture_cooker. Every mip level is stored in its
+ * final VkFormat so loading is a copy into staging with no decode. Little endian layout:
+ *   header      CookedTextureHeader
+ *   level index levelCount x { uint64 offset, uint64 size }, largest level first
+ *   level data  each level starts at a multiple of COOKED_TEXTURE_ALIGNMENT
+ */
+constexpr uint32_t COOKED_TEXTURE_MAGIC = 0x58544C43; // "CLTX"
+constexpr uint32_t COOKED_TEXTURE_VERSION = 1;
+constexpr uint32_t COOKED_TEXTURE_ALIGNMENT = 16;
+
+enum CookedTextureFlags : uint32_t {
+    COOKED_TEXTURE_PREMULTIPLIED_ALPHA = 1 << 0
+};
+
+struct CookedTextureHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t vkFormat;
+    uint32_t width;
+    uint32_t height;
+    uint32_t levelCount;
+    uint32_t flags;
+    uint32_t reserved;
+};
+
+bool isCookedTextureFile(const FileData& fileData);
+
+/**
+ * Validates the header and level index, the levels point into the file which the result takes ownership of.
+ * Throws when the level count or any level size does not fit the format and dimensions
+ */
+TextureData parseCookedTexture(FileData&& fileData);
+
+/** Serializes already encoded levels, largest first */
+std::vector<uint8_t> writeCookedTexture(
+    uint32_t vkFormat,
+    uint32_t width,
+    uint32_t height,
+    uint32_t flags,
+    const std::vector<std::vector<uint8_t>>& levels
+);
+
+} // namespace clay::utils
@@ -0,0 +1,81 @@
+#pragma once
+// standard lib
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+// clay
+#include "clay/utils/common/Utils.h"
+
+namespace clay::utils {
+
+/**
+ * On disk cache of import results so later runs skip the import. Entries are keyed by makeKey, which
+ * covers the source bytes, the importer version and its options, so a stale entry is never found rather
+ * than invalidated. Each entry is one LZ4 compressed file named after its key. Once the cache grows past
+ * its size cap the least recently used entries are deleted. Safe to use from several threads
+ *
+ * Little endian entry layout:
+ *   header DerivedDataHeader
+ *   data   storedSize bytes, an LZ4 block unless storedSize == size
+ */
+constexpr uint32_t DERIVED_DATA_MAGIC = 0x44444C43; // "CLDD"
+constexpr uint32_t DERIVED_DATA_VERSION = 1;
+
+struct DerivedDataHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint64_t size;       // bytes once decompressed
+    uint64_t storedSize; // bytes following the header
+};
+
+class DerivedDataCache {
+public:
+    /** Creates directory if needed and indexes the entries already in it */
+    DerivedDataCache(const std::filesystem::path& directory, uint64_t maxBytes);
+
+    DerivedDataCache(const DerivedDataCache&) = delete;
+    DerivedDataCache& operator=(const DerivedDataCache&) = delete;
+
+    /**
+     * Bump importerVersion whenever the importer output changes. options is any byte string that
+     * determines the output, serialize fields one by one rather than copying a struct with padding
+     */
+    static uint64_t makeKey(std::string_view importer, uint32_t importerVersion, const FileData& source, std::string_view options);
+
+    /** Missing and unreadable entries return nothing, a corrupt entry is also deleted */
+    std::optional<FileData> load(uint64_t key);
+
+    /** Failures are logged and otherwise ignored, the cache is only an optimization */
+    void store(uint64_t key, const std::vector<uint8_t>& data);
+
+    /** Bytes on disk, headers included */
+    uint64_t getSize() const;
+
+private:
+    struct Entry {
+        uint64_t size;
+        std::filesystem::file_time_type lastUse;
+    };
+
+    std::filesystem::path pathFor(uint64_t key) const;
+
+    /** Deletes least recently used entries until under the cap, called with mMutex_ held */
+    void evict();
+
+    /** Forgets an entry, called with mMutex_ held */
+    void erase(uint64_t key);
+
+    std::filesystem::path mDirectory_;
+    uint64_t mMaxBytes_;
+
+    mutable std::mutex mMutex_;
+    std::unordered_map<uint64_t, Entry> mEntries_;
+    uint64_t mTotalBytes_ = 0;
+};
+
+} // namespace clay::utils
@@ -0,0 +1,63 @@
+#pragma once
+// standard lib
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace clay::utils {
+
+/**
+ * Reports files that were written since they were last reported. On Linux the directories of the watched
+ * files are watched with inotify, elsewhere, or when inotify is unavailable, a background thread compares
+ * modification times every poll interval. Meant for development, such as hot reloading assets
+ */
+class FileWatcher {
+public:
+    explicit FileWatcher(std::chrono::milliseconds pollInterval = std::chrono::milliseconds(250));
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    ~FileWatcher();
+
+    /** Absolute and lexically normal, the form takeChanged returns */
+    static std::string normalize(const std::filesystem::path& path);
+
+    void watch(const std::filesystem::path& path);
+
+    /** Each changed file once, in no particular order */
+    std::vector<std::string> takeChanged();
+
+    bool isUsingInotify() const;
+
+private:
+    void run();
+
+    void pollTimestamps();
+
+    void readInotifyEvents();
+
+    const std::chrono::milliseconds mPollInterval_;
+
+    std::mutex mMutex_;
+    std::condition_variable mStopCondition_;
+    bool mStopping_ = false;
+
+    // watched file -> last seen modification time, only compared when polling
+    std::unordered_map<std::string, std::filesystem::file_time_type> mFiles_;
+    std::unordered_set<std::string> mChanged_;
+
+    int mInotifyFd_ = -1;
+    // inotify watch descriptor -> directory
+    std::unordered_map<int, std::string> mDirectories_;
+
+    std::thread mThread_;
+};
+
+} // namespace clay::utils
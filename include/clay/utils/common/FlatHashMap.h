@@ -0,0 +1,172 @@
+#pragma once
+// standard lib
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace clay::utils {
+
+/**
+ * Open addressing hash map with linear probing. Keys and values live in one contiguous array so a lookup
+ * is a hash and usually a single cache line, unlike the node per entry of std::unordered_map. Erase shifts
+ * later entries back instead of leaving tombstones, so probe lengths stay short under churn.
+ *
+ * Pointers returned by find and insert are invalidated by any later insert or erase
+ */
+template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class FlatHashMap {
+public:
+    FlatHashMap() = default;
+
+    explicit FlatHashMap(std::size_t capacity) {
+        reserve(capacity);
+    }
+
+    Value* find(const Key& key) {
+        const std::size_t index = findIndex(key);
+        return index == kNotFound ? nullptr : &mSlots_[index].value;
+    }
+
+    const Value* find(const Key& key) const {
+        const std::size_t index = findIndex(key);
+        return index == kNotFound ? nullptr : &mSlots_[index].value;
+    }
+
+    bool contains(const Key& key) const {
+        return findIndex(key) != kNotFound;
+    }
+
+    /** Inserts or overwrites, returns the stored value */
+    Value& insert(const Key& key, Value value) {
+        if ((mSize_ + 1) * kMaxLoadDenominator > mSlots_.size() * kMaxLoadNumerator) {
+            rehash(mSlots_.empty() ? kMinCapacity : mSlots_.size() * 2);
+        }
+        std::size_t index = bucketFor(key);
+        while (mSlots_[index].occupied) {
+            if (mKeyEqual_(mSlots_[index].key, key)) {
+                mSlots_[index].value = std::move(value);
+                return mSlots_[index].value;
+            }
+            index = (index + 1) & mMask_;
+        }
+        mSlots_[index] = {key, std::move(value), true};
+        ++mSize_;
+        return mSlots_[index].value;
+    }
+
+    /** Returns false when key was not present */
+    bool erase(const Key& key) {
+        std::size_t hole = findIndex(key);
+        if (hole == kNotFound) {
+            return false;
+        }
+
+        // pull back every later entry of the probe run that may sit past the hole
+        std::size_t index = (hole + 1) & mMask_;
+        while (mSlots_[index].occupied) {
+            const std::size_t home = bucketFor(mSlots_[index].key);
+            if (((index - home) & mMask_) >= ((index - hole) & mMask_)) {
+                mSlots_[hole] = std::move(mSlots_[index]);
+                hole = index;
+            }
+            index = (index + 1) & mMask_;
+        }
+        mSlots_[hole] = Slot{};
+        --mSize_;
+        return true;
+    }
+
+    void clear() {
+        for (Slot& slot : mSlots_) {
+            slot = Slot{};
+        }
+        mSize_ = 0;
+    }
+
+    /** Grows so count entries fit without a rehash */
+    void reserve(std::size_t count) {
+        std::size_t capacity = kMinCapacity;
+        while (count * kMaxLoadDenominator > capacity * kMaxLoadNumerator) {
+            capacity *= 2;
+        }
+        if (capacity > mSlots_.size()) {
+            rehash(capacity);
+        }
+    }
+
+    std::size_t size() const {
+        return mSize_;
+    }
+
+    bool empty() const {
+        return mSize_ == 0;
+    }
+
+    /** Calls fn(key, value) for every entry, in no particular order */
+    template<typename Fn>
+    void forEach(Fn&& fn) const {
+        for (const Slot& slot : mSlots_) {
+            if (slot.occupied) {
+                fn(slot.key, slot.value);
+            }
+        }
+    }
+
+private:
+    struct Slot {
+        Key key{};
+        Value value{};
+        bool occupied = false;
+    };
+
+    static constexpr std::size_t kNotFound = static_cast<std::size_t>(-1);
+    static constexpr std::size_t kMinCapacity = 16;
+    // rehash past 7/8 full
+    static constexpr std::size_t kMaxLoadNumerator = 7;
+    static constexpr std::size_t kMaxLoadDenominator = 8;
+
+    std::size_t bucketFor(const Key& key) const {
+        // fold the high bits in, integer keys often hash to themselves
+        std::size_t hash = mHash_(key);
+        hash ^= hash >> 17;
+        hash *= static_cast<std::size_t>(0x9E3779B97F4A7C15ull);
+        hash ^= hash >> 29;
+        return hash & mMask_;
+    }
+
+    std::size_t findIndex(const Key& key) const {
+        if (mSize_ == 0) {
+            return kNotFound;
+        }
+        std::size_t index = bucketFor(key);
+        while (mSlots_[index].occupied) {
+            if (mKeyEqual_(mSlots_[index].key, key)) {
+                return index;
+            }
+            index = (index + 1) & mMask_;
+        }
+        return kNotFound;
+    }
+
+    void rehash(std::size_t capacity) {
+        std::vector<Slot> oldSlots = std::move(mSlots_);
+        mSlots_ = std::vector<Slot>(capacity);
+        mMask_ = capacity - 1;
+        mSize_ = 0;
+        for (Slot& slot : oldSlots) {
+            if (slot.occupied) {
+                insert(slot.key, std::move(slot.value));
+            }
+        }
+    }
+
+    std::vector<Slot> mSlots_;
+    std::size_t mMask_ = 0;
+    std::size_t mSize_ = 0;
+    [[no_unique_address]] Hash mHash_{};
+    [[no_unique_address]] KeyEqual mKeyEqual_{};
+};
+
+} // namespace clay::utils
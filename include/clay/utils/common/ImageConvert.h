@@ -0,0 +1,58 @@
+#pragma once
+// standard lib
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Bulk 8 bit pixel converters. Each entry point dispatches once to an AVX2, SSE4.1, NEON or scalar kernel,
+ * picked from the running CPU, so they are meant for whole images rather than single pixels. Source and
+ * destination must not overlap unless stated otherwise
+ */
+namespace clay::utils::image_convert {
+
+enum class SimdLevel : uint8_t {
+    SCALAR = 0,
+    SSE4,
+    AVX2,
+    NEON
+};
+
+/** Best level supported by this CPU and build */
+SimdLevel getSupportedSimdLevel();
+
+/** Level the converters currently dispatch to */
+SimdLevel getSimdLevel();
+
+/** Forces a dispatch level, for benchmarks and comparisons. Throws if the CPU does not support it */
+void setSimdLevel(SimdLevel level);
+
+const char* toString(SimdLevel level);
+
+/** 3 bytes per pixel to 4, alpha set to 255 */
+void rgbToRgba(const uint8_t* src, uint8_t* dst, std::size_t pixelCount);
+
+/** Swaps the 1st and 3rd byte of every pixel, so it converts both ways. src may equal dst */
+void swapRedBlue(const uint8_t* src, uint8_t* dst, std::size_t pixelCount);
+
+/** Gray replicated to RGB, alpha set to 255 */
+void grayToRgba(const uint8_t* src, uint8_t* dst, std::size_t pixelCount);
+
+/** Gray + alpha pairs to RGBA */
+void grayAlphaToRgba(const uint8_t* src, uint8_t* dst, std::size_t pixelCount);
+
+/** Multiplies RGB by alpha in place, rounded. With srgb set the product is taken on linear values */
+void premultiplyAlpha(uint8_t* rgba, std::size_t pixelCount, bool srgb);
+
+/** Decodes sRGB encoded bytes to linear floats in [0, 1] */
+void srgbToLinear(const uint8_t* src, float* dst, std::size_t count);
+
+/** Encodes linear floats to sRGB bytes, clamped to [0, 1] and within 1 of the exact rounding */
+void linearToSrgb(const float* src, uint8_t* dst, std::size_t count);
+
+/**
+ * 2x2 box filter of an RGBA image into max(width / 2, 1) x max(height / 2, 1). An odd last row or column is
+ * dropped. With srgb set the color channels are averaged in linear space and alpha is averaged as is
+ */
+void downsampleBoxRgba(const uint8_t* src, int width, int height, uint8_t* dst, bool srgb);
+
+} // namespace clay::utils::image_convert
@@ -0,0 +1,17 @@
+#pragma once
+// clay
+#include "clay/utils/common/Utils.h"
+
+namespace clay::utils {
+
+bool isKtx2File(const FileData& fileData);
+
+/**
+ * Reads a 2D KTX2 texture without decoding it, the levels point into the file which the result takes
+ * ownership of. Supercompressed (zstd, zlib) and Basis Universal files are rejected since there is no
+ * transcoder in this build; cook them to a GPU format (BCn on desktop, ASTC/ETC2 on mobile) instead.
+ * Throws when the level count or any level size does not fit the format and dimensions
+ */
+TextureData parseKtx2File(FileData&& fileData);
+
+} // namespace clay::utils
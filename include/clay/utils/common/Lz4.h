@@ -0,0 +1,18 @@
+#pragma once
+// standard lib
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace clay::utils {
+
+/**
+ * LZ4 block format, without the frame header. Blocks are compatible with the reference LZ4 library, the
+ * compressor is a single pass greedy matcher tuned for offline packing rather than ratio
+ */
+std::vector<uint8_t> compressLz4Block(const uint8_t* source, std::size_t sourceSize);
+
+/** Decodes exactly destinationSize bytes, throws on malformed or truncated input */
+void decompressLz4Block(const uint8_t* source, std::size_t sourceSize, uint8_t* destination, std::size_t destinationSize);
+
+} // namespace clay::utils
@@ -0,0 +1,55 @@
+#pragma once
+// standard lib
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace clay::utils {
+
+/**
+ * Skyline bottom-left rectangle packer. The free space is the area above a list of horizontal segments;
+ * each rectangle goes where its top edge ends lowest, ties broken by the narrower fit. Fast enough to run
+ * at load time and keeps shelves of similar heights tight, which suits sprites and glyphs
+ */
+class RectPacker {
+public:
+    struct Rect {
+        uint32_t x;
+        uint32_t y;
+        uint32_t width;
+        uint32_t height;
+    };
+
+    RectPacker(uint32_t width, uint32_t height);
+
+    /** Returns where a width x height rectangle was placed, or nullopt when it does not fit */
+    std::optional<Rect> pack(uint32_t width, uint32_t height);
+
+    void reset();
+
+    uint32_t getWidth() const;
+
+    uint32_t getHeight() const;
+
+    /** Fraction of the area covered by packed rectangles */
+    float getOccupancy() const;
+
+private:
+    struct Segment {
+        uint32_t x;
+        uint32_t y; // top of the used space below this segment
+        uint32_t width;
+    };
+
+    /** Lowest y a rectangle of the given size can sit at starting on segment index, nullopt if it does not fit */
+    std::optional<uint32_t> fitAt(size_t index, uint32_t width, uint32_t height) const;
+
+    void addSegment(size_t index, const Rect& rect);
+
+    uint32_t mWidth_;
+    uint32_t mHeight_;
+    uint64_t mUsedArea_ = 0;
+    std::vector<Segment> mSkyline_;
+};
+
+} // namespace clay::utils
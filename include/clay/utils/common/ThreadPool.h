@@ -0,0 +1,55 @@
+#pragma once
+// standard lib
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace clay::utils {
+
+/** Fixed set of worker threads running submitted tasks in FIFO order */
+class ThreadPool {
+public:
+    /** threadCount 0 uses one thread per hardware thread, less one for the caller, and at least one */
+    explicit ThreadPool(uint32_t threadCount = 0);
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /** Runs every task already queued, then joins the workers */
+    ~ThreadPool();
+
+    /** Queues fn; the future holds its result or rethrows what it threw */
+    template<typename Fn>
+    auto submit(Fn&& fn) -> std::future<std::invoke_result_t<std::decay_t<Fn>>> {
+        using Result = std::invoke_result_t<std::decay_t<Fn>>;
+        // std::function needs a copyable target, the packaged task is not
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Fn>(fn));
+        std::future<Result> future = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mMutex_);
+            mTasks_.emplace_back([task]() { (*task)(); });
+        }
+        mCondition_.notify_one();
+        return future;
+    }
+
+    uint32_t getThreadCount() const;
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> mWorkers_;
+    std::deque<std::function<void()>> mTasks_;
+    std::mutex mMutex_;
+    std::condition_variable mCondition_;
+    bool mStopping_ = false;
+};
+
+} // namespace clay::utils
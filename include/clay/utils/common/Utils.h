@@ -2,11 +2,44 @@
 // standard lib
 #include <cstdint>
 #include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
 
 namespace clay::utils {
 
+/**
+ * Frees FileData bytes the way they were obtained. Heap buffers from make_unique convert to it and are
+ * deleted as before, memory mapped files and Android asset buffers set release to unmap or close instead
+ */
+struct FileDataDeleter {
+    using ReleaseFn = void (*)(uint8_t* data, std::size_t size, void* context);
+
+    FileDataDeleter() = default;
+
+    FileDataDeleter(std::default_delete<uint8_t[]>) {}
+
+    FileDataDeleter(ReleaseFn releaseFn, std::size_t mappedSize, void* releaseContext)
+        : release(releaseFn),
+          size(mappedSize),
+          context(releaseContext) {}
+
+    void operator()(uint8_t* data) const {
+        if (release != nullptr) {
+            release(data, size, context);
+        } else {
+            delete[] data;
+        }
+    }
+
+    ReleaseFn release = nullptr;
+    std::size_t size = 0;
+    void* context = nullptr;
+};
+
+/** Bytes of a whole file, possibly mapped. Treat them as read only, Android asset buffers are not writable */
 struct FileData {
-    std::unique_ptr<uint8_t[]> data;
+    std::unique_ptr<uint8_t[], FileDataDeleter> data;
     std::size_t size;
 };
 
@@ -17,6 +50,63 @@ struct ImageData {
     int channels;
 };
 
+/** GPU ready texture, possibly block compressed, with its mip levels already computed */
+struct TextureData {
+    struct Level {
+        std::size_t offset; // into storage
+        std::size_t size;
+        uint32_t width;
+        uint32_t height;
+    };
+
+    FileData storage;      // owns the level bytes
+    uint32_t vkFormat = 0; // VkFormat value
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<Level> levels; // largest first
+    bool premultipliedAlpha = false; // color is multiplied by alpha, blend with PipelineLayoutInfo::premultipliedAlpha
+    bool generateMipmaps = false; // levels holds mip 0 only, the rest are to be generated on upload
+};
+
+/** Width or height past which texture files are rejected, beyond maxImageDimension2D of any device */
+constexpr uint32_t MAX_TEXTURE_DIMENSION = 1u << 16;
+
+enum class MipFilter : uint8_t {
+    BOX = 0, // 2x2 average
+    KAISER   // Kaiser windowed sinc, sharper at the cost of a wider kernel
+};
+
 void convertRGBtoRGBA(ImageData& image);
 
+/** Expands 1 (gray), 2 (gray, alpha) and 3 channel images to RGBA in place */
+void convertToRGBA(ImageData& image);
+
+/** Number of levels in a full mip chain down to 1x1 */
+uint32_t calculateMipLevels(int width, int height);
+
+/** Bytes of one tightly packed level of a VkFormat image, whole texel blocks. 0 for formats without a single plane 2D block */
+uint64_t calculateLevelSize(uint32_t vkFormat, uint32_t width, uint32_t height);
+
+/**
+ * Halves each dimension of an 8 bit image (down to 1). With srgb set the color channels are filtered in
+ * linear space, the 4th channel is always treated as linear alpha
+ */
+ImageData downsampleImage(const ImageData& image, MipFilter filter, bool srgb);
+
+/** Multiplies color by alpha in place for 2 and 4 channel images, in linear space when srgb is set */
+void premultiplyAlpha(ImageData& image, bool srgb);
+
+/** 64 bit FNV-1a, usable at compile time */
+constexpr uint64_t hashString(std::string_view text) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (const char c : text) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+/** Decodes UTF-8 to codepoints. Malformed, overlong and surrogate sequences become U+FFFD */
+std::u32string decodeUtf8(std::string_view text);
+
 } // namespace clay::utils
\ No newline at end of file
@@ -7,8 +7,12 @@
 
 namespace clay::utils {
 
+/** Maps the file into memory, empty files and files that cannot be mapped are read with readFileToMemory_desktop */
 FileData loadFileToMemory_desktop(const std::filesystem::path& filePath);
 
+/** Reads the whole file into a heap buffer */
+FileData readFileToMemory_desktop(const std::filesystem::path& filePath);
+
 ImageData loadImageFileToMemory_desktop(const std::filesystem::path& filePath);
 
 } // namespace clay::utils
@@ -29,13 +29,16 @@ void AppAndroid::update() {
     mLastTime_ = std::chrono::steady_clock::now();
 
     if (mSceneBuffer_[1]) {
-        vkDeviceWaitIdle(mpGraphicsContext_->getDevice()); // wait to allow deleteing current scene
-        // switch to scene in back buffer
+        // switch to scene in back buffer, the old one may still be drawn by frames in flight
+        retireScene(std::move(mSceneBuffer_[0]));
         mSceneBuffer_[0] = std::move(mSceneBuffer_[1]);
     }
 
     if (mSceneBuffer_[0] != nullptr) {
         mSceneBuffer_[0]->update(dt.count());
+        mSceneBuffer_[0]->streamTextures(
+            static_cast<float>(((GraphicsContextAndroid*)mpGraphicsContext_.get())->mSwapChainExtent_.height)
+        );
     }
 }
 
@@ -60,6 +63,7 @@ void AppAndroid::render() {
 //    }
 
     vkResetFences(mpGraphicsContext_->getDevice(), 1, &((GraphicsContextAndroid*)mpGraphicsContext_.get())->mInFlightFences_[((GraphicsContextAndroid*)mpGraphicsContext_.get())->mCurrentFrame_]);
+    mpGraphicsContext_->advanceFrame();
 
     vkResetCommandBuffer(((GraphicsContextAndroid*)mpGraphicsContext_.get())->mCommandBuffers_[((GraphicsContextAndroid*)mpGraphicsContext_.get())->mCurrentFrame_], /*VkCommandBufferResetFlagBits*/ 0);
     recordCommandBuffer(((GraphicsContextAndroid*)mpGraphicsContext_.get())->mCommandBuffers_[((GraphicsContextAndroid*)mpGraphicsContext_.get())->mCurrentFrame_], imageIndex);
@@ -130,6 +134,11 @@ void AppAndroid::recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t ima
     renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
     renderPassInfo.pClearValues = clearValues.data();
 
+    if (mSceneBuffer_[0] != nullptr) {
+        const Camera* pCamera = mSceneBuffer_[0]->getFocusCamera();
+        mSceneBuffer_[0]->record(commandBuffer, pCamera->getViewMatrix(), pCamera->getProjectionMatrix());
+    }
+
     vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
     {
         VkViewport viewport{};
@@ -170,6 +179,17 @@ utils::FileData AppAndroid::loadFileToMemory(const std::filesystem::path& filePa
     }
     size_t fileSize = AAsset_getLength(asset);
 
+    // uncompressed assets are mapped straight from the apk, the asset stays open while the bytes are used
+    const void* assetBuffer = AAsset_getBuffer(asset);
+    if (assetBuffer != nullptr) {
+        utils::FileDataDeleter closeAsset(
+            [](uint8_t*, std::size_t, void* context) { AAsset_close(static_cast<AAsset*>(context)); },
+            fileSize,
+            asset
+        );
+        return {{static_cast<uint8_t*>(const_cast<void*>(assetBuffer)), closeAsset}, fileSize};
+    }
+
     auto buffer = std::make_unique<unsigned char[]>(fileSize);
     AAsset_read(asset, buffer.get(), fileSize);
     AAsset_close(asset);
@@ -1,3 +1,6 @@
+// clay
+#include "clay/application/common/BaseScene.h"
+// class
 #include "clay/application/common/BaseApp.h"
 
 namespace clay {
@@ -10,6 +13,17 @@ BaseApp::~BaseApp() {};
 
 void BaseApp::loadResources() {}
 
+void BaseApp::retireScene(std::unique_ptr<BaseScene> pScene) {
+    if (pScene == nullptr) {
+        return;
+    }
+    // the scene's own resources and arena defer their GPU frees again when it is destroyed
+    std::shared_ptr<BaseScene> retired = std::move(pScene);
+    mpGraphicsContext_->deferDestroy([retired]() mutable {
+        retired.reset();
+    });
+}
+
 BaseGraphicsContext& BaseApp::getGraphicsContext() {
     return *mpGraphicsContext_;
 }
@@ -1,5 +1,6 @@
 // clay
 #include "clay/application/common/BaseApp.h"
+#include "clay/ecs/EntityManager.h"
 // class
 #include "clay/application/common/BaseScene.h"
 
@@ -7,11 +8,20 @@ namespace clay {
 
 BaseScene::BaseScene(BaseApp& app) 
     : mApp_(app),
+      mArena_(app.getGraphicsContext()),
       mResources_(app.getGraphicsContext()),
-      mpFocusCamera_(&mCamera_) {}
+      mpFocusCamera_(&mCamera_) {
+    mResources_.setArena(&mArena_);
+}
 
 BaseScene::~BaseScene() {}
 
+void BaseScene::record(vk::CommandBuffer cmdBuffer, const glm::mat4& view, const glm::mat4& projection) {
+    if (mpEntityManager_ != nullptr) {
+        mpEntityManager_->cull(cmdBuffer, projection * view, glm::vec3(glm::inverse(view)[3]));
+    }
+}
+
 BaseApp& BaseScene::getApp() {
     return mApp_;
 }
@@ -20,8 +30,22 @@ Resources& BaseScene::getResources() {
     return mResources_;
 }
 
+GpuArena& BaseScene::getArena() {
+    return mArena_;
+}
+
 Camera* BaseScene::getFocusCamera() {
     return mpFocusCamera_;
 }
 
+void BaseScene::setEntityManager(ecs::EntityManager* pEntityManager) {
+    mpEntityManager_ = pEntityManager;
+}
+
+void BaseScene::streamTextures(float viewportHeight) {
+    TextureStreamer& streamer = mResources_.getTextureStreamer();
+    streamer.update();
+    streamer.setView(mpFocusCamera_->getViewMatrix(), mpFocusCamera_->getProjectionMatrix(), viewportHeight);
+}
+
 } // namespace clay
@@ -1,3 +1,16 @@
+// standard lib
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <numeric>
+#include <sstream>
+#include <string>
+// clay
+#include "clay/utils/common/CookedTexture.h"
+#include "clay/utils/common/Ktx2.h"
+#include "clay/utils/common/Logger.h"
 // class
 #include "clay/application/common/Resources.h"
 
@@ -19,13 +32,68 @@ template auto
 template Type& Resources::operator[](Handle<Type> handle);                      \
                                                                                 \
 template Resources::Handle<Type>                                                \
-    Resources::getHandle(const std::string& resourceName);                      \
+    Resources::loadResourceAsync<Type>(                                         \
+        const std::vector<std::string>& resourcePath,                           \
+        const std::string& resourceName                                         \
+    );                                                                          \
+                                                                                \
+template void Resources::setPlaceholder<Type>(Type&&);                          \
+                                                                                \
+template bool Resources::isReady<Type>(Handle<Type> handle);                    \
+                                                                                \
+template Resources::Handle<Type>                                                \
+    Resources::getHandle<Type>(ResourceId id);                                  \
+                                                                                \
+template void Resources::release<Type>(Handle<Type> handle);                    \
                                                                                 \
-template void Resources::release<Type>(Handle<Type> handle);
+template void Resources::retain<Type>(Handle<Type> handle);                     \
+                                                                                \
+template uint32_t Resources::getRefCount<Type>(Handle<Type> handle);             \
+                                                                                \
+template Resources::MemoryStats Resources::getMemoryStats<Type>();
 
 
 namespace clay {
 
+namespace {
+
+utils::TextureData decodeTextureFile(utils::FileData&& loadedFile) {
+    if (utils::isCookedTextureFile(loadedFile)) {
+        return utils::parseCookedTexture(std::move(loadedFile));
+    } else if (utils::isKtx2File(loadedFile)) {
+        return utils::parseKtx2File(std::move(loadedFile));
+    }
+    throw std::runtime_error("Texture load only supports cooked (.ctex) and KTX2 files, decode other images and use Texture::initialize");
+}
+
+// CPU bytes of the object and the device local bytes it holds
+template<typename T>
+std::pair<uint64_t, vk::DeviceSize> measureResource(const T& resource) {
+    if constexpr (std::is_same_v<T, Mesh>) {
+        return {sizeof(Mesh) + resource.getSubMeshes().capacity() * sizeof(Mesh::SubMesh), resource.getMemorySize()};
+    } else if constexpr (std::is_same_v<T, Texture>) {
+        return {sizeof(Texture), resource.getMemorySize()};
+    } else if constexpr (std::is_same_v<T, Font>) {
+        return {sizeof(Font) + resource.getCpuMemorySize(), resource.getAtlas().getMemorySize()};
+    } else if constexpr (std::is_same_v<T, Audio>) {
+        // OpenAL keeps the samples in host memory
+        return {sizeof(Audio) + resource.getMemorySize(), 0};
+    } else {
+        return {sizeof(T), 0};
+    }
+}
+
+// every field that changes the import output, in a fixed layout
+std::string importOptionsKey(const Mesh::ImportOptions& options) {
+    return std::to_string(static_cast<int>(options.vertexFormat.encoding)) + ";" +
+        std::to_string(static_cast<int>(options.vertexFormat.texCoordEncoding)) + ";" +
+        std::to_string(options.optimize) + ";" +
+        std::to_string(options.overdrawThreshold) + ";" +
+        std::to_string(options.allowShortIndices);
+}
+
+} // namespace
+
 void Resources::setFileLoader(std::function<utils::FileData(const std::string&)> loader) {
     loadFileToMemory = std::move(loader);
 }
@@ -42,32 +110,96 @@ std::filesystem::path Resources::RESOURCE_PATH = "";
 
 std::function<utils::FileData(const std::string&)> Resources::loadFileToMemory;
 
+std::vector<std::shared_ptr<const utils::AssetArchive>> Resources::ARCHIVES;
+
+void Resources::mountArchive(std::shared_ptr<const utils::AssetArchive> archive) {
+    ARCHIVES.push_back(std::move(archive));
+}
+
+void Resources::unmountArchives() {
+    ARCHIVES.clear();
+}
+
+utils::FileData Resources::readFile(const std::string& path) {
+    if (!ARCHIVES.empty()) {
+        std::filesystem::path archivePath(path);
+        if (!RESOURCE_PATH.empty()) {
+            std::filesystem::path relative = archivePath.lexically_relative(RESOURCE_PATH);
+            if (!relative.empty() && *relative.begin() != "..") {
+                archivePath = relative;
+            }
+        }
+        const std::string archiveKey = archivePath.generic_string();
+        for (auto it = ARCHIVES.rbegin(); it != ARCHIVES.rend(); ++it) {
+            if ((*it)->contains(archiveKey)) {
+                return (*it)->load(archiveKey);
+            }
+        }
+    }
+    return loadFileToMemory(path);
+}
+
+std::shared_ptr<utils::DerivedDataCache> Resources::DERIVED_DATA_CACHE;
+
+void Resources::setDerivedDataCache(std::shared_ptr<utils::DerivedDataCache> cache) {
+    DERIVED_DATA_CACHE = std::move(cache);
+}
+
+Mesh::ImportedModel Resources::importModel(const std::string& path) {
+    utils::FileData source = readFile(path);
+    if (!DERIVED_DATA_CACHE) {
+        return Mesh::importModelFile(source);
+    }
+
+    const uint64_t key = utils::DerivedDataCache::makeKey("mesh", Mesh::IMPORT_VERSION, source, importOptionsKey({}));
+    if (std::optional<utils::FileData> cached = DERIVED_DATA_CACHE->load(key)) {
+        try {
+            return Mesh::deserializeImport(*cached);
+        } catch (const std::runtime_error& e) {
+            LOG_E("Ignoring cached import of %s: %s", path.c_str(), e.what());
+        }
+    }
+    Mesh::ImportedModel model = Mesh::importModelFile(source);
+    DERIVED_DATA_CACHE->store(key, Mesh::serializeImport(model));
+    return model;
+}
+
 // START ResourcePool
 
 template<typename T>
 Resources::ResourcePool<T>::ResourcePool(BaseGraphicsContext& graphicsContext)
     : mGraphicsContext_(graphicsContext) {}
 
+template<typename T>
+Resources::ResourcePool<T>::~ResourcePool() {
+    for (std::atomic<Slot*>& chunk : chunks) {
+        delete[] chunk.load(std::memory_order_relaxed);
+    }
+}
+
 template<typename T>
 Resources::Handle<T> Resources::ResourcePool<T>::loadResource(const std::vector<std::string>& resourcePaths, const std::string& resourceName) {
+    if (std::optional<Handle<T>> loaded = acquire(resourceName)) {
+        return *loaded;
+    }
+
     if constexpr (std::is_same_v<T, Mesh>) {
-        utils::FileData loadedFile = loadFileToMemory(resourcePaths[0]);
-        std::vector<clay::Mesh> loadedMeshes;
-        Mesh::parseObjFile(mGraphicsContext_, loadedFile, loadedMeshes);
-        // TODO confirm there is only 1 mesh here // TODO mesh clean up seems wrong. There is delete happening due to the std::vector<clay::Mesh> being passed?
-        return add(std::move(loadedMeshes[0]), resourceName);
+        // every mesh in the file is packed into one buffer, see Mesh::getSubMeshes
+        return add(Mesh::createFromImport(mGraphicsContext_, importModel(resourcePaths[0])), resourceName);
     } else if constexpr(std::is_same_v<T, vk::Sampler>) {
         throw std::runtime_error("Load not implemented for vk::Sampler");
     } else if constexpr(std::is_same_v<T, Model>) {
         throw std::runtime_error("Load not implemented for Model");
     } else if constexpr(std::is_same_v<T, Texture>) {
-        throw std::runtime_error("Load not implemented for Texture");
+        Texture texture(mGraphicsContext_);
+        texture.initialize(decodeTextureFile(readFile(resourcePaths[0])));
+        return add(std::move(texture), resourceName);
     } else if constexpr(std::is_same_v<T, PipelineResource>) {
         throw std::runtime_error("Load not implemented for PipelineResource");
     } else if constexpr(std::is_same_v<T, Material>) {
         throw std::runtime_error("Load not implemented for Material");
     } else if constexpr (std::is_same_v<T, Audio>) {
-        utils::FileData loadedFile = loadFileToMemory(resourcePaths[0]);
+        utils::FileData loadedFile = readFile(resourcePaths[0]);
         return add(Audio(loadedFile), resourceName);
         throw std::runtime_error("Load not implemented for Audio");
     }
@@ -78,49 +210,291 @@ Resources::Handle<T> Resources::ResourcePool<T>::loadResource(const std::vector<
     }
 }
 
+template<typename T>
+typename Resources::ResourcePool<T>::Slot* Resources::ResourcePool<T>::findSlot(uint32_t index) const {
+    if (index >= slotCount.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    return chunks[index / kChunkSize].load(std::memory_order_acquire) + index % kChunkSize;
+}
+
 template<typename T>
 Resources::Handle<T> Resources::ResourcePool<T>::add(T&& obj, const std::string& name) {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    return insertLocked(std::move(obj), name, SLOT_READY);
+}
+
+template<typename T>
+Resources::Handle<T> Resources::ResourcePool<T>::insertLocked(T&& obj, const std::string& name, SlotState state) {
+    const uint64_t id = utils::hashString(name);
+    if (const Handle<T>* named = ids.find(id)) {
+        const Slot* other = findSlot(named->index);
+        if (other->generation.load(std::memory_order_relaxed) == named->gen && other->name != name) {
+            throw std::runtime_error("Resource names " + other->name + " and " + name + " share a hash, rename one");
+        }
+    }
+
     uint32_t idx;
+    bool published = true;
     if (!freeList.empty()) {
         idx = freeList.back();
         freeList.pop_back();
-        resources[idx] = std::move(obj);
     } else {
-        idx = static_cast<uint32_t>(resources.size());
-        resources.emplace_back(std::move(obj));
-        generations.push_back(0);
+        idx = slotCount.load(std::memory_order_relaxed);
+        if (idx == kChunkSize * kMaxChunks) {
+            throw std::runtime_error("Resource pool is full");
+        }
+        if (idx % kChunkSize == 0) {
+            chunks[idx / kChunkSize].store(new Slot[kChunkSize], std::memory_order_release);
+        }
+        published = false;
+    }
+
+    Slot& slot = chunks[idx / kChunkSize].load(std::memory_order_relaxed)[idx % kChunkSize];
+    slot.object.emplace(std::move(obj));
+    slot.refCount = 1;
+    slot.name = name;
+    // readers that see the state also see the object
+    slot.state.store(state, std::memory_order_release);
+    if (!published) {
+        slotCount.store(idx + 1, std::memory_order_release);
     }
-    name2Handle[name] = Handle<T>{ idx, generations[idx] };
-    return Handle<T>{ idx, generations[idx] };
+
+    account(slot);
+
+    const Handle<T> handle{ idx, slot.generation.load(std::memory_order_relaxed) };
+    ids.insert(id, handle);
+    return handle;
+}
+
+template<typename T>
+std::optional<Resources::Handle<T>> Resources::ResourcePool<T>::acquire(const std::string& name) {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    const Handle<T>* named = ids.find(utils::hashString(name));
+    if (named == nullptr || !isValid(*named)) {
+        return std::nullopt;
+    }
+    ++findSlot(named->index)->refCount;
+    return *named;
+}
+
+template<typename T>
+bool Resources::ResourcePool<T>::isValid(Handle<T> handle) const {
+    const Slot* slot = findSlot(handle.index);
+    return slot != nullptr &&
+        slot->generation.load(std::memory_order_acquire) == handle.gen &&
+        slot->state.load(std::memory_order_acquire) != SLOT_FREE;
+}
+
+template<typename T>
+void Resources::ResourcePool<T>::retain(Handle<T> handle) {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    if (isValid(handle)) {
+        ++findSlot(handle.index)->refCount;
+    }
+}
+
+template<typename T>
+void Resources::ResourcePool<T>::release(Handle<T> handle) {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    if (isValid(handle) && --findSlot(handle.index)->refCount == 0) {
+        removeLocked(handle);
+    }
+}
+
+template<typename T>
+uint32_t Resources::ResourcePool<T>::getRefCount(Handle<T> handle) const {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    return isValid(handle) ? findSlot(handle.index)->refCount : 0;
+}
+
+template<typename T>
+void Resources::ResourcePool<T>::retire(std::optional<T>& object) {
+    // frames still in flight may use the object, destroy it once their fences have passed
+    if constexpr (std::is_same_v<T, vk::Sampler>) {
+        mGraphicsContext_.deferDestroy([device = mGraphicsContext_.getDevice(), sampler = *object]() {
+            device.destroySampler(sampler);
+        });
+    } else {
+        auto doomed = std::make_shared<T>(std::move(*object));
+        mGraphicsContext_.deferDestroy([doomed]() mutable {
+            doomed.reset();
+        });
+    }
+    object.reset();
+}
+
+template<typename T>
+void Resources::ResourcePool<T>::removeAll() {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    const uint32_t count = slotCount.load(std::memory_order_relaxed);
+    for (uint32_t idx = 0; idx < count; ++idx) {
+        const Slot& slot = *findSlot(idx);
+        if (slot.state.load(std::memory_order_relaxed) != SLOT_FREE) {
+            removeLocked(Handle<T>{ idx, slot.generation.load(std::memory_order_relaxed) });
+        }
+    }
+    // the pool may outlive the device, the deferred destroys are flushed before it goes away
+    if (placeholder.has_value()) {
+        retire(placeholder);
+    }
+}
+
+template<typename T>
+Resources::Handle<T> Resources::ResourcePool<T>::reserve(const std::string& name) {
+    if constexpr (std::is_constructible_v<T, BaseGraphicsContext&>) {
+        // the empty object keeps the slot layout identical to add until fulfill replaces it
+        std::lock_guard<std::mutex> lock(writeMutex);
+        return insertLocked(T(mGraphicsContext_), name, SLOT_LOADING);
+    } else {
+        throw std::runtime_error("Asynchronous load not supported for this resource type");
+    }
+}
+
+template<typename T>
+Resources::Handle<T> Resources::ResourcePool<T>::reserve(const std::string& name, T&& standIn) {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    return insertLocked(std::move(standIn), name, SLOT_STAND_IN);
+}
+
+template<typename T>
+bool Resources::ResourcePool<T>::hasStandIn(Handle<T> handle) const {
+    return isValid(handle) && findSlot(handle.index)->state.load(std::memory_order_acquire) == SLOT_STAND_IN;
+}
+
+template<typename T>
+void Resources::ResourcePool<T>::fulfill(Handle<T> handle, T&& obj) {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    if (!isValid(handle)) {
+        // released while loading
+        return;
+    }
+    Slot& slot = *findSlot(handle.index);
+    unaccount(slot);
+    if (slot.state.load(std::memory_order_relaxed) != SLOT_LOADING) {
+        // a stand in or a reload, frames in flight may still use the previous version
+        retire(slot.object);
+    }
+    slot.object.emplace(std::move(obj));
+    account(slot);
+    slot.state.store(SLOT_READY, std::memory_order_release);
+}
+
+template<typename T>
+bool Resources::ResourcePool<T>::isReady(Handle<T> handle) const {
+    return isValid(handle) && findSlot(handle.index)->state.load(std::memory_order_acquire) == SLOT_READY;
+}
+
+template<typename T>
+void Resources::ResourcePool<T>::setPlaceholder(T&& obj) {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    if (placeholder.has_value()) {
+        retire(placeholder);
+    }
+    placeholder.emplace(std::move(obj));
+}
+
+template<typename T>
+bool Resources::ResourcePool<T>::hasPlaceholder() const {
+    return placeholder.has_value();
+}
+
+template<typename T>
+const T& Resources::ResourcePool<T>::getPlaceholder() const {
+    return *placeholder;
 }
 
 template<typename T>
 void Resources::ResourcePool<T>::remove(Handle<T> handle) {
-    if (handle.index >= resources.size()) return; 
-    if (generations[handle.index] != handle.gen) return;
+    std::lock_guard<std::mutex> lock(writeMutex);
+    removeLocked(handle);
+}
 
-    // Destroy the object explicitly
-    resources[handle.index].~T(); // or std::destroy_at()
+template<typename T>
+void Resources::ResourcePool<T>::removeLocked(Handle<T> handle) {
+    if (!isValid(handle)) return;
 
-    // Mark slot free
-    generations[handle.index]++;
+    Slot& slot = *findSlot(handle.index);
+    // stale handles stop resolving before the object goes away
+    slot.generation.fetch_add(1, std::memory_order_release);
+    slot.state.store(SLOT_FREE, std::memory_order_release);
+    unaccount(slot);
+    retire(slot.object);
+
+    const uint64_t id = utils::hashString(slot.name);
+    const Handle<T>* named = ids.find(id);
+    if (named != nullptr && named->index == handle.index && named->gen == handle.gen) {
+        ids.erase(id);
+    }
+    slot.name.clear();
+    slot.refCount = 0;
     freeList.push_back(handle.index);
 }
 
 template<typename T>
 T& Resources::ResourcePool<T>::operator[](Handle<T> handle) {
-    assert(handle.index < resources.size());
-    assert(generations[handle.index] == handle.gen);
-    return resources[handle.index];
+    assert(isValid(handle));
+    Slot& slot = *findSlot(handle.index);
+    const uint8_t state = slot.state.load(std::memory_order_acquire);
+    if (state != SLOT_READY && state != SLOT_STAND_IN) {
+        if (!placeholder.has_value()) {
+            throw std::runtime_error("Resource is still loading and has no placeholder");
+        }
+        return *placeholder;
+    }
+    return *slot.object;
 }
 
 template<typename T>
-Resources::Handle<T> Resources::ResourcePool<T>::getHandle(const std::string& name) const {
-    auto it = name2Handle.find(name);
-    if (it == name2Handle.end()) {
-        throw std::runtime_error("Unknown resource: " + name);
+Resources::Handle<T> Resources::ResourcePool<T>::getHandle(ResourceId id) const {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    const Handle<T>* named = ids.find(id.value);
+    if (named == nullptr) {
+        char hex[17];
+        std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(id.value));
+        throw std::runtime_error(std::string("Unknown resource id ") + hex);
     }
-    return it->second;
+    return *named;
+}
+
+template<typename T>
+void Resources::ResourcePool<T>::account(Slot& slot) {
+    if (deviceHeapIndex == UINT32_MAX) {
+        deviceHeapIndex = mGraphicsContext_.getMemoryHeapIndex(vk::MemoryPropertyFlagBits::eDeviceLocal);
+    }
+    const auto [cpuBytes, deviceBytes] = measureResource(*slot.object);
+    slot.cpuBytes = cpuBytes;
+    slot.deviceBytes = deviceBytes;
+
+    ++stats.count;
+    stats.cpuBytes += cpuBytes;
+    stats.deviceBytes[deviceHeapIndex] += deviceBytes;
+    stats.peakCpuBytes = std::max(stats.peakCpuBytes, stats.cpuBytes);
+    const vk::DeviceSize totalDeviceBytes = std::accumulate(stats.deviceBytes.begin(), stats.deviceBytes.end(), vk::DeviceSize{0});
+    stats.peakDeviceBytes = std::max(stats.peakDeviceBytes, totalDeviceBytes);
+}
+
+template<typename T>
+void Resources::ResourcePool<T>::unaccount(Slot& slot) {
+    --stats.count;
+    stats.cpuBytes -= slot.cpuBytes;
+    stats.deviceBytes[deviceHeapIndex] -= slot.deviceBytes;
+    slot.cpuBytes = 0;
+    slot.deviceBytes = 0;
+}
+
+template<typename T>
+Resources::MemoryStats Resources::ResourcePool<T>::getMemoryStats() {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    const uint32_t count = slotCount.load(std::memory_order_relaxed);
+    for (uint32_t idx = 0; idx < count; ++idx) {
+        Slot& slot = *findSlot(idx);
+        if (slot.state.load(std::memory_order_relaxed) != SLOT_FREE) {
+            unaccount(slot);
+            account(slot);
+        }
+    }
+    return stats;
 }
 
 // END ResourcePool
@@ -136,22 +510,89 @@ Resources::Resources(BaseGraphicsContext& graphicsContext) :
     mPipePool_(mGraphicsContext_),
     mMaterialsPool_(mGraphicsContext_),
     mAudiosPool_(mGraphicsContext_),
-    mFontsPool_(mGraphicsContext_) {};
+    mFontsPool_(mGraphicsContext_),
+    mTextureStreamer_(mGraphicsContext_, TextureStreamer::Config{}) {};
 
 Resources::~Resources() {
     releaseAll();
 }
 
+void Resources::setArena(GpuArena* pArena) {
+    mpArena_ = pArena;
+}
+
+TextureStreamer& Resources::getTextureStreamer() {
+    return mTextureStreamer_;
+}
+
+template<typename T>
+Resources::ResourcePool<T>& Resources::getPool() {
+    if constexpr (std::is_same_v<T, Mesh>) {
+        return mMeshesPool_;
+    } else if constexpr (std::is_same_v<T, Model>) {
+        return mModelsPool_;
+    } else if constexpr (std::is_same_v<T, vk::Sampler>) {
+        return mSamplersPool_;
+    } else if constexpr (std::is_same_v<T, Texture>) {
+        return mTexturesPool_;
+    } else if constexpr (std::is_same_v<T, PipelineResource>) {
+        return mPipePool_;
+    } else if constexpr (std::is_same_v<T, Material>) {
+        return mMaterialsPool_;
+    } else if constexpr (std::is_same_v<T, Audio>) {
+        return mAudiosPool_;
+    } else if constexpr (std::is_same_v<T, Font>) {
+        return mFontsPool_;
+    }
+}
+
+template<typename Fn>
+void Resources::forEachPool(Fn&& fn) {
+    fn("mesh", mMeshesPool_);
+    fn("model", mModelsPool_);
+    fn("sampler", mSamplersPool_);
+    fn("texture", mTexturesPool_);
+    fn("pipeline", mPipePool_);
+    fn("material", mMaterialsPool_);
+    fn("audio", mAudiosPool_);
+    fn("font", mFontsPool_);
+}
+
 template<typename T>
 Resources::Handle<T> Resources::loadResource(const std::vector<std::string>& resourcePaths, const std::string& resourceName) {
+    GpuArena::Scope arenaScope(mGraphicsContext_, mpArena_);
     if constexpr (std::is_same_v<T, Mesh>) {
-        return mMeshesPool_.loadResource(resourcePaths, resourceName);
+        Handle<Mesh> handle = mMeshesPool_.loadResource(resourcePaths, resourceName);
+        if (mFileWatcher_) {
+            watchForReload(handle, resourceName, resourcePaths[0]);
+        }
+        return handle;
     } else if constexpr(std::is_same_v<T, vk::Sampler>) {
         throw std::runtime_error("Load not implemented for vk::Sampler");
     } else if constexpr(std::is_same_v<T, Model>) {
-        throw std::runtime_error("Load not implemented for Model");
+        if (std::optional<Handle<Model>> loaded = mModelsPool_.acquire(resourceName)) {
+            return *loaded;
+        }
+        // the mesh gets a name of its own so it cannot collide with a mesh loaded separately under the model's
+        // name, materials are not imported yet so set them with Model::setMaterial
+        const std::string meshName = resourceName + "#mesh";
+        Handle<Mesh> meshHandle = mMeshesPool_.loadResource(resourcePaths, meshName);
+        if (mFileWatcher_) {
+            // the model resolves its mesh handle on every render, so it draws the reloaded mesh
+            watchForReload(meshHandle, meshName, resourcePaths[0]);
+        }
+        Model model(mGraphicsContext_);
+        model.addSubMeshes(*this, meshHandle, nullptr);
+        Handle<Model> modelHandle = mModelsPool_.add(std::move(model), resourceName);
+        // the model holds a reference on its mesh until it is released
+        mModelMeshes_[modelHandle.index] = meshHandle;
+        return modelHandle;
     } else if constexpr(std::is_same_v<T, Texture>) {
-        throw std::runtime_error("Load not implemented for Texture");
+        Handle<Texture> handle = mTexturesPool_.loadResource(resourcePaths, resourceName);
+        if (mFileWatcher_) {
+            watchForReload(handle, resourceName, resourcePaths[0]);
+        }
+        return handle;
     } else if constexpr(std::is_same_v<T, PipelineResource>) {
         throw std::runtime_error("Load not implemented for PipelineResource");
     } else if constexpr(std::is_same_v<T, Material>) {
@@ -167,139 +608,487 @@ Resources::Handle<T> Resources::loadResource(const std::vector<std::string>& res
 }
 
 template<typename T>
-auto Resources::addResource(T&& resource, const std::string& resourceName) -> Handle<std::remove_reference_t<T>> {
-    using U = std::remove_reference_t<T>;
+Resources::Handle<T> Resources::loadResourceAsync(const std::vector<std::string>& resourcePaths, const std::string& resourceName) {
+    if constexpr (std::is_same_v<T, Texture> || std::is_same_v<T, Mesh>) {
+        if (std::optional<Handle<T>> loaded = getPool<T>().acquire(resourceName)) {
+            return *loaded;
+        }
+        const std::string path = resourcePaths[0];
 
-    if constexpr (std::is_same_v<U, Mesh>)
-        return mMeshesPool_.add(std::forward<T>(resource), resourceName);
+        if constexpr (std::is_same_v<T, Texture>) {
+            if (!mTexturesPool_.hasPlaceholder()) {
+                utils::ImageData white{std::make_unique<uint8_t[]>(4), 1, 1, 4};
+                std::memset(white.pixels.get(), 0xFF, 4);
+                Texture placeholder(mGraphicsContext_);
+                placeholder.initialize(white, false);
+                mTexturesPool_.setPlaceholder(std::move(placeholder));
+            }
+        }
+        Handle<T> handle;
+        if constexpr (std::is_same_v<T, Texture>) {
+            // a view of its own lets the finisher tell materials built on this load apart from other loads
+            Texture standIn(mGraphicsContext_);
+            standIn.initializeView(mTexturesPool_.getPlaceholder());
+            handle = mTexturesPool_.reserve(resourceName, std::move(standIn));
+        } else {
+            handle = getPool<T>().reserve(resourceName);
+        }
+        submitLoad(resourceName, makeLoadJob(handle, path));
+        if (mFileWatcher_) {
+            watchForReload(handle, resourceName, path);
+        }
+        return handle;
+    } else {
+        throw std::runtime_error("Asynchronous load only implemented for Texture and Mesh");
+    }
+}
 
-    else if constexpr (std::is_same_v<U, Model>)
-        return mModelsPool_.add(std::forward<T>(resource), resourceName);
+template<typename T>
+Resources::LoadJob Resources::makeLoadJob(Handle<T> handle, const std::string& path) {
+    // decoded data is shared so the finisher stays copyable as a std::function
+    if constexpr (std::is_same_v<T, Texture>) {
+        return [this, handle, path]() -> std::function<void()> {
+            auto textureData = std::make_shared<utils::TextureData>(decodeTextureFile(readFile(path)));
+            return [this, handle, textureData]() {
+                Texture texture(mGraphicsContext_);
+                texture.initialize(*textureData);
+                const vk::ImageView newView = texture.getImageView();
+                // materials built while loading sample the stand in, after a reload the previous image
+                const bool hasView = mTexturesPool_.isReady(handle) || mTexturesPool_.hasStandIn(handle);
+                const vk::ImageView oldView = hasView ? mTexturesPool_[handle].getImageView() : vk::ImageView{};
+                mTexturesPool_.fulfill(handle, std::move(texture));
+                if (oldView) {
+                    mMaterialsPool_.forEach([oldView, newView](Material& material) {
+                        material.replaceImageView(oldView, newView);
+                    });
+                }
+            };
+        };
+    } else {
+        return [this, handle, path]() -> std::function<void()> {
+            auto model = std::make_shared<Mesh::ImportedModel>(importModel(path));
+            return [this, handle, model]() {
+                mMeshesPool_.fulfill(handle, Mesh::createFromImport(mGraphicsContext_, *model));
+            };
+        };
+    }
+}
 
-    else if constexpr (std::is_same_v<U, vk::Sampler>)
-        return mSamplersPool_.add(std::forward<T>(resource), resourceName);
+void Resources::submitLoad(const std::string& name, LoadJob job) {
+    mPendingLoads_.push_back({name, getLoaderThreads().submit(std::move(job))});
+}
+
+utils::ThreadPool& Resources::getLoaderThreads() {
+    if (!mLoaderThreads_) {
+        mLoaderThreads_ = std::make_unique<utils::ThreadPool>();
+    }
+    return *mLoaderThreads_;
+}
 
-    else if constexpr (std::is_same_v<U, Texture>)
-        return mTexturesPool_.add(std::forward<T>(resource), resourceName);
+uint32_t Resources::loadManifest(const std::vector<ManifestEntry>& manifest) {
+    struct ManifestLoad {
+        std::string name;
+        std::future<std::function<void()>> finish;
+        std::function<void()> discard; // frees the reserved slot when the load fails
+        uint32_t entryCount;           // manifest entries made ready by this load alone
+    };
+    struct SharedMesh {
+        Handle<Mesh> handle;
+        size_t loadIndex; // into loads, SIZE_MAX when it was already loaded
+    };
 
-    else if constexpr (std::is_same_v<U, PipelineResource>)
-        return mPipePool_.add(std::forward<T>(resource), resourceName);
+    std::vector<ManifestLoad> loads;
+    std::unordered_map<std::string, SharedMesh> meshes;
+    std::vector<std::pair<const ManifestEntry*, Handle<Mesh>>> models;
+    uint32_t readyCount = 0;
 
-    else if constexpr (std::is_same_v<U, Material>)
-        return mMaterialsPool_.add(std::forward<T>(resource), resourceName);
+    // start every read and decode before waiting on any of them
+    for (const ManifestEntry& entry : manifest) {
+        if (entry.paths.empty()) {
+            LOG_E("Manifest entry %s has no path", entry.name.c_str());
+            continue;
+        }
+        const std::string& path = entry.paths[0];
+
+        if (entry.type == ManifestEntry::Type::TEXTURE) {
+            if (mTexturesPool_.acquire(entry.name)) {
+                ++readyCount;
+                continue;
+            }
+            const Handle<Texture> handle = mTexturesPool_.reserve(entry.name);
+            loads.push_back({
+                entry.name,
+                getLoaderThreads().submit(makeLoadJob(handle, path)),
+                [this, handle]() { mTexturesPool_.remove(handle); },
+                1
+            });
+            if (mFileWatcher_) {
+                watchForReload(handle, entry.name, path);
+            }
+        } else if (entry.type == ManifestEntry::Type::AUDIO) {
+            if (mAudiosPool_.acquire(entry.name)) {
+                ++readyCount;
+                continue;
+            }
+            const std::string name = entry.name;
+            loads.push_back({
+                name,
+                getLoaderThreads().submit([this, path, name]() -> std::function<void()> {
+                    auto fileData = std::make_shared<utils::FileData>(readFile(path));
+                    return [this, name, fileData]() {
+                        mAudiosPool_.add(Audio(*fileData), name);
+                    };
+                }),
+                nullptr,
+                1
+            });
+        } else {
+            const bool isModel = entry.type == ManifestEntry::Type::MODEL;
+            if (isModel && mModelsPool_.acquire(entry.name)) {
+                ++readyCount;
+                continue;
+            }
+
+            // every entry naming the mesh holds its own reference
+            const std::string meshName = isModel ? entry.name + "#mesh" : entry.name;
+            auto it = meshes.find(meshName);
+            if (it != meshes.end()) {
+                mMeshesPool_.retain(it->second.handle);
+                if (!isModel && it->second.loadIndex != SIZE_MAX) {
+                    ++loads[it->second.loadIndex].entryCount;
+                } else if (!isModel) {
+                    ++readyCount;
+                }
+            } else if (std::optional<Handle<Mesh>> loaded = mMeshesPool_.acquire(meshName)) {
+                it = meshes.emplace(meshName, SharedMesh{*loaded, SIZE_MAX}).first;
+                readyCount += isModel ? 0 : 1;
+            } else {
+                const Handle<Mesh> handle = mMeshesPool_.reserve(meshName);
+                it = meshes.emplace(meshName, SharedMesh{handle, loads.size()}).first;
+                loads.push_back({
+                    meshName,
+                    getLoaderThreads().submit(makeLoadJob(handle, path)),
+                    [this, handle]() { mMeshesPool_.remove(handle); },
+                    isModel ? 0u : 1u
+                });
+                if (mFileWatcher_) {
+                    watchForReload(handle, meshName, path);
+                }
+            }
+            if (isModel) {
+                models.emplace_back(&entry, it->second.handle);
+            }
+        }
+    }
 
-    else if constexpr (std::is_same_v<U, Audio>)
-        return mAudiosPool_.add(std::forward<T>(resource), resourceName);
+    for (ManifestLoad& load : loads) {
+        load.finish.wait();
+    }
 
-    else if constexpr (std::is_same_v<U, Font>)
-        return mFontsPool_.add(std::forward<T>(resource), resourceName);
+    // one submit and one wait for the whole manifest
+    GpuArena::Scope arenaScope(mGraphicsContext_, mpArena_);
+    mGraphicsContext_.beginUploadBatch();
+    for (ManifestLoad& load : loads) {
+        try {
+            load.finish.get()();
+            readyCount += load.entryCount;
+        } catch (const std::exception& e) {
+            LOG_E("Failed to load %s: %s", load.name.c_str(), e.what());
+            if (load.discard) {
+                load.discard();
+            }
+        }
+    }
+    mGraphicsContext_.endUploadBatch();
 
-    else
-        static_assert(std::is_same_v<U, void>,
-                      "addResource: unsupported resource type");
+    for (const auto& [entry, meshHandle] : models) {
+        if (!mMeshesPool_.isReady(meshHandle)) {
+            LOG_E("Skipping model %s, its mesh failed to load", entry->name.c_str());
+            continue;
+        }
+        if (mModelsPool_.acquire(entry->name)) {
+            // named twice in the manifest
+            mMeshesPool_.release(meshHandle);
+            ++readyCount;
+            continue;
+        }
+        Model model(mGraphicsContext_);
+        model.addSubMeshes(*this, meshHandle, nullptr);
+        Handle<Model> modelHandle = mModelsPool_.add(std::move(model), entry->name);
+        mModelMeshes_[modelHandle.index] = meshHandle;
+        ++readyCount;
+    }
+    return readyCount;
 }
 
-template<typename T>
-T& Resources::operator[](Handle<T> handle) {
-    if constexpr (std::is_same_v<T, Mesh>) {
-        return mMeshesPool_[handle];
-    } else if constexpr (std::is_same_v<T, Model>) {
-        return mModelsPool_[handle];
-    } else if constexpr (std::is_same_v<T, vk::Sampler>) {
-        return mSamplersPool_[handle];
-    } else if constexpr (std::is_same_v<T, Texture>) {
-        return mTexturesPool_[handle];
-    } else if constexpr (std::is_same_v<T, PipelineResource>) {
-        return mPipePool_[handle];
-    } else if constexpr (std::is_same_v<T, Material>) {
-        return mMaterialsPool_[handle];
-    } else if constexpr (std::is_same_v<T, Audio>) {
-        return mAudiosPool_[handle];
-    } else if constexpr (std::is_same_v<T, Font>) {
-        return mFontsPool_[handle];
+void Resources::enableHotReload() {
+    if (!mFileWatcher_) {
+        mFileWatcher_ = std::make_unique<utils::FileWatcher>();
     }
 }
 
 template<typename T>
-Resources::Handle<T> Resources::getHandle(const std::string& resourceName) {
-    if constexpr (std::is_same_v<T, Mesh>) {
-        return mMeshesPool_.getHandle(resourceName);
-    } else if constexpr (std::is_same_v<T, Model>) {
-        return mModelsPool_.getHandle(resourceName);
-    } else if constexpr (std::is_same_v<T, vk::Sampler>) {
-        return mSamplersPool_.getHandle(resourceName);
-    } else if constexpr (std::is_same_v<T, Texture>) {
-        return mTexturesPool_.getHandle(resourceName);
-    } else if constexpr (std::is_same_v<T, PipelineResource>) {
-        return mPipePool_.getHandle(resourceName);
-    } else if constexpr (std::is_same_v<T, Material>) {
-        return mMaterialsPool_.getHandle(resourceName);
-    } else if constexpr (std::is_same_v<T, Audio>) {
-        return mAudiosPool_.getHandle(resourceName);
-    } else if constexpr (std::is_same_v<T, Font>) {
-        return mFontsPool_.getHandle(resourceName);
+void Resources::watchForReload(Handle<T> handle, const std::string& name, const std::string& path) {
+    std::vector<ReloadJob>& jobs = mReloadJobs_[utils::FileWatcher::normalize(path)];
+    for (const ReloadJob& job : jobs) {
+        if (job.name == name && job.isAlive()) {
+            // loaded again by name, the handle is shared
+            return;
+        }
+    }
+    mFileWatcher_->watch(path);
+    jobs.push_back({
+        name,
+        [this, handle]() { return getPool<T>().isValid(handle); },
+        makeLoadJob(handle, path)
+    });
+}
+
+void Resources::watchPipeline(
+    Handle<PipelineResource> handle,
+    const PipelineResource::PipelineConfig& config,
+    const std::vector<std::pair<std::string, vk::ShaderStageFlagBits>>& shaderFiles
+) {
+    if (!mFileWatcher_) {
+        return;
+    }
+    const std::string name = "pipeline " + std::to_string(handle.index);
+    LoadJob job = [this, handle, config, shaderFiles]() -> std::function<void()> {
+        auto spirv = std::make_shared<std::vector<utils::FileData>>();
+        for (const auto& [path, stage] : shaderFiles) {
+            spirv->push_back(readFile(path));
+        }
+        return [this, handle, config, shaderFiles, spirv]() {
+            // the pipeline keeps nothing from its shader modules once created
+            std::vector<std::unique_ptr<ShaderModule>> shaders;
+            PipelineResource::PipelineConfig rebuilt = config;
+            rebuilt.pipelineLayoutInfo.shaders.clear();
+            for (size_t i = 0; i < shaderFiles.size(); ++i) {
+                shaders.push_back(std::make_unique<ShaderModule>(mGraphicsContext_.getDevice(), shaderFiles[i].second, (*spirv)[i]));
+                rebuilt.pipelineLayoutInfo.shaders.push_back(shaders.back().get());
+            }
+            mPipePool_.fulfill(handle, PipelineResource(rebuilt));
+        };
+    };
+    for (const auto& [path, stage] : shaderFiles) {
+        mFileWatcher_->watch(path);
+        mReloadJobs_[utils::FileWatcher::normalize(path)].push_back({
+            name,
+            [this, handle]() { return mPipePool_.isValid(handle); },
+            job
+        });
+    }
+}
+
+void Resources::submitReloads() {
+    for (const std::string& file : mFileWatcher_->takeChanged()) {
+        auto it = mReloadJobs_.find(file);
+        if (it == mReloadJobs_.end()) {
+            continue;
+        }
+        std::vector<ReloadJob>& jobs = it->second;
+        jobs.erase(std::remove_if(jobs.begin(), jobs.end(), [](const ReloadJob& job) { return !job.isAlive(); }), jobs.end());
+        for (const ReloadJob& job : jobs) {
+            LOG_I("Reloading %s", job.name.c_str());
+            submitLoad(job.name, job.job);
+        }
     }
 }
 
+uint32_t Resources::update() {
+    if (mFileWatcher_) {
+        submitReloads();
+    }
+    checkBudget();
+
+    auto firstPending = std::partition(mPendingLoads_.begin(), mPendingLoads_.end(), [](const PendingLoad& load) {
+        return load.finish.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    });
+    if (firstPending == mPendingLoads_.begin()) {
+        return 0;
+    }
+
+    // every upload finished this frame shares one submit and one wait
+    uint32_t finishedCount = 0;
+    GpuArena::Scope arenaScope(mGraphicsContext_, mpArena_);
+    mGraphicsContext_.beginUploadBatch();
+    for (auto it = mPendingLoads_.begin(); it != firstPending; ++it) {
+        try {
+            it->finish.get()();
+            ++finishedCount;
+        } catch (const std::exception& e) {
+            LOG_E("Failed to load %s: %s", it->name.c_str(), e.what());
+        }
+    }
+    mGraphicsContext_.endUploadBatch();
+
+    mPendingLoads_.erase(mPendingLoads_.begin(), firstPending);
+    return finishedCount;
+}
+
+uint32_t Resources::getPendingLoadCount() const {
+    return static_cast<uint32_t>(mPendingLoads_.size());
+}
+
+template<typename T>
+void Resources::setPlaceholder(T&& placeholder) {
+    getPool<T>().setPlaceholder(std::move(placeholder));
+}
+
+template<typename T>
+bool Resources::isReady(Handle<T> handle) {
+    return getPool<T>().isReady(handle);
+}
+
+template<typename T>
+void Resources::retain(Handle<T> handle) {
+    getPool<T>().retain(handle);
+}
+
+template<typename T>
+uint32_t Resources::getRefCount(Handle<T> handle) {
+    return getPool<T>().getRefCount(handle);
+}
+
+template<typename T>
+auto Resources::addResource(T&& resource, const std::string& resourceName) -> Handle<std::remove_reference_t<T>> {
+    return getPool<std::remove_reference_t<T>>().add(std::forward<T>(resource), resourceName);
+}
+
+template<typename T>
+T& Resources::operator[](Handle<T> handle) {
+    return getPool<T>()[handle];
+}
+
+template<typename T>
+Resources::Handle<T> Resources::getHandle(ResourceId id) {
+    return getPool<T>().getHandle(id);
+}
+
 template<typename T>
 void Resources::release(Handle<T> handle) {
-    // if constexpr (std::is_same_v<T, Mesh>) {
-    //     // auto it = mMeshes_.find(resourceName);
-    //     // if (it != mMeshes_.end()) {
-    //     //     mMeshes_.erase(it);
-    //     // }
-    //     mMeshesPool_.remove(handle);
-    // } else if constexpr (std::is_same_v<T, Model>) {
-    //     auto it = mModels_.find(resourceName);
-    //     if (it != mModels_.end()) {
-    //         mModels_.erase(it);
-    //     }
-    // } else if constexpr(std::is_same_v<T, vk::Sampler>) {
-    //     auto it = mSamplers_.find(resourceName);
-    //     if (it != mSamplers_.end()) {
-    //         mSamplers_.erase(it);
-    //     }
-    // } else if constexpr(std::is_same_v<T, Texture>) {
-    //     auto it = mTextures_.find(resourceName);
-    //     if (it != mTextures_.end()) {
-    //         mTextures_.erase(it);
-    //     }
-    // } else if constexpr(std::is_same_v<T, PipelineResource>) {
-    //     auto it = mPipelineResources_.find(resourceName);
-    //     if (it != mPipelineResources_.end()) {
-    //         mPipelineResources_.erase(it);
-    //     }
-    // } else if constexpr(std::is_same_v<T, Material>) {
-    //     auto it = mMaterials_.find(resourceName);
-    //     if (it != mMaterials_.end()) {
-    //         mMaterials_.erase(it);
-    //     }
-    // } else if constexpr (std::is_same_v<T, Audio>) {
-    //     auto it = mAudios_.find(resourceName);
-    //     if (it != mAudios_.end()) {
-    //         mAudios_.erase(it);
-    //     }
-    // }
-    // else if constexpr (std::is_same_v<T, Font>) {
-    //     auto it = mFonts_.find(resourceName);
-    //     if (it != mFonts_.end()) {
-    //         mFonts_.erase(it);
-    //     }
-    // }
+    if constexpr (std::is_same_v<T, Model>) {
+        if (mModelsPool_.getRefCount(handle) == 1) {
+            auto it = mModelMeshes_.find(handle.index);
+            if (it != mModelMeshes_.end()) {
+                const Handle<Mesh> meshHandle = it->second;
+                mModelMeshes_.erase(it);
+                mModelsPool_.release(handle);
+                mMeshesPool_.release(meshHandle);
+                return;
+            }
+        }
+    }
+    getPool<T>().release(handle);
+}
+
+template<typename T>
+Resources::MemoryStats Resources::getMemoryStats() {
+    return getPool<T>().getMemoryStats();
+}
+
+std::string Resources::exportMemoryReport(ReportFormat format) {
+    const std::vector<BaseGraphicsContext::HeapUsage> heaps = mGraphicsContext_.getHeapUsage();
+    std::vector<std::pair<const char*, MemoryStats>> pools;
+    forEachPool([&pools](const char* name, auto& pool) {
+        pools.emplace_back(name, pool.getMemoryStats());
+    });
+
+    std::ostringstream out;
+    if (format == ReportFormat::JSON) {
+        out << "{\n  \"pools\": [";
+        for (size_t i = 0; i < pools.size(); ++i) {
+            const MemoryStats& stats = pools[i].second;
+            out << (i == 0 ? "\n" : ",\n")
+                << "    {\"type\": \"" << pools[i].first << "\", \"count\": " << stats.count
+                << ", \"cpuBytes\": " << stats.cpuBytes << ", \"peakCpuBytes\": " << stats.peakCpuBytes
+                << ", \"deviceBytes\": [";
+            for (size_t heap = 0; heap < heaps.size(); ++heap) {
+                out << (heap == 0 ? "" : ", ") << stats.deviceBytes[heap];
+            }
+            out << "], \"peakDeviceBytes\": " << stats.peakDeviceBytes << "}";
+        }
+        out << "\n  ],\n  \"memoryBudget\": " << (mGraphicsContext_.isMemoryBudgetEnabled() ? "true" : "false")
+            << ",\n  \"heaps\": [";
+        for (size_t heap = 0; heap < heaps.size(); ++heap) {
+            const BaseGraphicsContext::HeapUsage& usage = heaps[heap];
+            out << (heap == 0 ? "\n" : ",\n")
+                << "    {\"index\": " << heap << ", \"deviceLocal\": " << (usage.deviceLocal ? "true" : "false")
+                << ", \"size\": " << usage.size << ", \"budget\": " << usage.budget << ", \"usage\": " << usage.usage
+                << ", \"allocated\": " << usage.allocated << ", \"peakAllocated\": " << usage.peakAllocated << "}";
+        }
+        out << "\n  ]\n}\n";
+    } else {
+        // two tables, pools then heaps, separated by an empty line
+        out << "type,count,cpuBytes,peakCpuBytes";
+        for (size_t heap = 0; heap < heaps.size(); ++heap) {
+            out << ",deviceBytesHeap" << heap;
+        }
+        out << ",peakDeviceBytes\n";
+        for (const auto& [name, stats] : pools) {
+            out << name << "," << stats.count << "," << stats.cpuBytes << "," << stats.peakCpuBytes;
+            for (size_t heap = 0; heap < heaps.size(); ++heap) {
+                out << "," << stats.deviceBytes[heap];
+            }
+            out << "," << stats.peakDeviceBytes << "\n";
+        }
+        out << "\nheap,deviceLocal,size,budget,usage,allocated,peakAllocated\n";
+        for (size_t heap = 0; heap < heaps.size(); ++heap) {
+            const BaseGraphicsContext::HeapUsage& usage = heaps[heap];
+            out << heap << "," << (usage.deviceLocal ? 1 : 0) << "," << usage.size << "," << usage.budget << ","
+                << usage.usage << "," << usage.allocated << "," << usage.peakAllocated << "\n";
+        }
+    }
+    return out.str();
+}
+
+void Resources::setBudgetPolicy(BudgetPolicy policy) {
+    mBudgetPolicy_ = std::move(policy);
+    mHeapsOverWarning_ = {};
+}
+
+void Resources::checkBudget() {
+    if (!mBudgetPolicy_) {
+        return;
+    }
+    const std::vector<BaseGraphicsContext::HeapUsage> heaps = mGraphicsContext_.getHeapUsage();
+    for (uint32_t heap = 0; heap < heaps.size(); ++heap) {
+        const BaseGraphicsContext::HeapUsage& usage = heaps[heap];
+        if (usage.budget == 0) {
+            continue;
+        }
+        const double fraction = static_cast<double>(usage.usage) / static_cast<double>(usage.budget);
+        if (fraction < mBudgetPolicy_->warnFraction) {
+            mHeapsOverWarning_[heap] = false;
+            continue;
+        }
+        if (!mHeapsOverWarning_[heap]) {
+            LOG_W(
+                "Memory heap %u is at %.0f%% of its %llu MiB budget",
+                heap,
+                fraction * 100.0,
+                static_cast<unsigned long long>(usage.budget >> 20)
+            );
+            mHeapsOverWarning_[heap] = true;
+        }
+        if (fraction >= mBudgetPolicy_->evictFraction && mBudgetPolicy_->evict) {
+            const vk::DeviceSize target = static_cast<vk::DeviceSize>(static_cast<double>(usage.budget) * mBudgetPolicy_->warnFraction);
+            mBudgetPolicy_->evict(heap, usage.usage - target);
+        }
+    }
 }
 
 void Resources::releaseAll() {
-    // mMeshes_.clear();
-    // mModels_.clear();
-    // for (auto& [_, eachSampler]: mSamplers_) {
-    //     vkDestroySampler(mGraphicsContext_.getDevice(), *eachSampler, nullptr);
-    // }
-    // mSamplers_.clear(); // free all
-    // mTextures_.clear();
-    // mPipelineResources_.clear();
-    // mMaterials_.clear();
-    // mAudios_.clear();
-    // mFonts_.clear();
+    // materials and models point at the other resources, drop them first
+    mModelsPool_.removeAll();
+    mModelMeshes_.clear();
+    mMaterialsPool_.removeAll();
+    mPipePool_.removeAll();
+    mMeshesPool_.removeAll();
+    mTexturesPool_.removeAll();
+    mSamplersPool_.removeAll();
+    mFontsPool_.removeAll();
+    mAudiosPool_.removeAll();
 }
 
 // END Resources
@@ -57,13 +57,14 @@ void AppDesktop::update() {
     }
 
     if (mSceneBuffer_[1]) {
-        mpGraphicsContext_->getDevice().waitIdle(); // wait to allow deleteing current scene
-        // switch to scene in back buffer
+        // switch to scene in back buffer, the old one may still be drawn by frames in flight
+        retireScene(std::move(mSceneBuffer_[0]));
         mSceneBuffer_[0] = std::move(mSceneBuffer_[1]);
     }
 
     if (mSceneBuffer_[0] != nullptr) {
         mSceneBuffer_[0]->update(dt.count());
+        mSceneBuffer_[0]->streamTextures(static_cast<float>(mGraphicsContextDesktop_.mSwapChainExtent_.height));
     }
 }
 
@@ -99,6 +100,8 @@ void AppDesktop::render() {
     }
 
     mpGraphicsContext_->getDevice().resetFences(1, &mGraphicsContextDesktop_.mInFlightFences_[mGraphicsContextDesktop_.mCurrentFrame_]);
+    // the fence of this frame slot has been waited on, so work from MAX_FRAMES_IN_FLIGHT frames ago is done
+    mGraphicsContextDesktop_.advanceFrame();
     mGraphicsContextDesktop_.mCommandBuffers_[mGraphicsContextDesktop_.mCurrentFrame_].reset();
 
     recordCommandBuffer(mGraphicsContextDesktop_.mCommandBuffers_[mGraphicsContextDesktop_.mCurrentFrame_], imageIndex);
@@ -179,6 +182,9 @@ void AppDesktop::recordCommandBuffer(vk::CommandBuffer commandBuffer, uint32_t i
     renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
     renderPassInfo.pClearValues = clearValues.data();
 
+    const Camera* pCamera = mSceneBuffer_[0]->getFocusCamera();
+    mSceneBuffer_[0]->record(commandBuffer, pCamera->getViewMatrix(), pCamera->getProjectionMatrix());
+
     commandBuffer.beginRenderPass(renderPassInfo, vk::SubpassContents::eInline);
     {
         vk::Viewport viewport{
@@ -58,6 +58,17 @@ utils::FileData AppXR::loadFileToMemory_XR(const std::string &filePath) {
     }
     size_t fileSize = AAsset_getLength(asset);
 
+    // uncompressed assets are mapped straight from the apk, the asset stays open while the bytes are used
+    const void* assetBuffer = AAsset_getBuffer(asset);
+    if (assetBuffer != nullptr) {
+        utils::FileDataDeleter closeAsset(
+            [](uint8_t*, std::size_t, void* context) { AAsset_close(static_cast<AAsset*>(context)); },
+            fileSize,
+            asset
+        );
+        return {{static_cast<uint8_t*>(const_cast<void*>(assetBuffer)), closeAsset}, fileSize};
+    }
+
     auto buffer = std::make_unique<unsigned char[]>(fileSize);
     AAsset_read(asset, buffer.get(), fileSize);
     AAsset_close(asset);
@@ -180,10 +191,16 @@ bool AppXR::RenderLayer(XRSystem::RenderLayerInfo &renderLayerInfo) {
 
     // TODO use real time
     if (mScenes_.size() > 1) {
-        mScenes_.erase(mScenes_.begin(), std::prev(mScenes_.end()));
+        while (mScenes_.size() > 1) {
+            retireScene(std::move(mScenes_.front()));
+            mScenes_.pop_front();
+        }
         mScenes_.front()->initialize();
     }
     mScenes_.front()->update(0);
+    mScenes_.front()->streamTextures(
+        static_cast<float>(mXRSystem_->m_viewConfigurationViews[0].recommendedImageRectHeight)
+    );
     // draw imgui onto a different frame buffer
 
     vkWaitForFences(mXRSystem_->mpGraphicsContext_->getDevice(), 1, &mXRSystem_->mpGraphicsContext_->fence, true, UINT64_MAX);
@@ -285,8 +302,22 @@ bool AppXR::RenderLayer(XRSystem::RenderLayerInfo &renderLayerInfo) {
         renderLayerInfo.layerProjectionViews[i].subImage.imageRect.extent.height = static_cast<int32_t>(height);
         renderLayerInfo.layerProjectionViews[i].subImage.imageArrayIndex = 0;  // Useful for multiview rendering.
 
+        // Compute the view-projection transform.
+        const Camera* pCamera = mScenes_.front()->getFocusCamera();
+        const glm::mat4 glmProj = utils::computeProjectionMatrix(views[i].fov, pCamera->getNear(), pCamera->getFar());
+
+        const glm::mat4 glmViewWorldLocked = utils::computeWorldLockViewMatrix(
+            views[i].pose,
+            pCamera->getPosition(),
+            pCamera->getOrientation(),
+            mInputHandler_.getHeadPose()
+        );
+        const glm::mat4 glmViewHeadLocked = utils::computeHeadLockViewMatrix(views[i].pose);
+
         // Rendering code to clear the color and depth image views.
         mXRSystem_->mpGraphicsContext_->BeginRendering();
+        // each eye culls against its own frustum before its render pass
+        mScenes_.front()->record(mXRSystem_->mpGraphicsContext_->cmdBuffer, glmViewWorldLocked, glmProj);
 
         if (mXRSystem_->m_environmentBlendMode == XR_ENVIRONMENT_BLEND_MODE_OPAQUE) {
             // VR mode use a background color.
@@ -309,18 +340,6 @@ bool AppXR::RenderLayer(XRSystem::RenderLayerInfo &renderLayerInfo) {
         mXRSystem_->mpGraphicsContext_->SetViewports(&viewport, 1);
         mXRSystem_->mpGraphicsContext_->SetScissors(&scissor, 1);
 
-        // Compute the view-projection transform.
-        const Camera* pCamera = mScenes_.front()->getFocusCamera();
-        const glm::mat4 glmProj = utils::computeProjectionMatrix(views[i].fov, pCamera->getNear(), pCamera->getFar());
-
-        const glm::mat4 glmViewWorldLocked = utils::computeWorldLockViewMatrix(
-            views[i].pose,
-            pCamera->getPosition(),
-            pCamera->getOrientation(),
-            mInputHandler_.getHeadPose()
-        );
-        const glm::mat4 glmViewHeadLocked = utils::computeHeadLockViewMatrix(views[i].pose);
-
         struct {
             glm::mat4 view;
             glm::mat4 proj;
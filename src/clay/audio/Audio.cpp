@@ -166,4 +166,12 @@ int Audio::getId() {
     return mId_;
 }
 
+std::size_t Audio::getMemorySize() const {
+    ALint size = 0;
+    if (mId_ != 0) {
+        alGetBufferi(mId_, AL_SIZE, &size);
+    }
+    return static_cast<std::size_t>(size);
+}
+
 } // namespace clay
\ No newline at end of file
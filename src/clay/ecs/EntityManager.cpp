@@ -62,6 +62,10 @@ void EntityManager::addSpriteRenderable(Entity e, const SpriteRenderable& comp)
     mSignatures[e].set(ComponentType::SPRITE);
 }
 
+void EntityManager::cull(vk::CommandBuffer cmdBuffer, const glm::mat4& viewProjection, const glm::vec3& cameraPosition) {
+    mRenderSystem_.cull(*this, cmdBuffer, viewProjection, cameraPosition);
+}
+
 void EntityManager::render(vk::CommandBuffer cmdBuffer) {
     mRenderSystem_.render(*this, cmdBuffer);
 }
@@ -4,20 +4,47 @@ namespace clay::ecs {
 
 TextRenderable::TextRenderable() {}
 
-void TextRenderable::initialize(BaseGraphicsContext& gContext, const std::string& text, Font* font) {
+void TextRenderable::initialize(BaseGraphicsContext& gContext, const std::string& text, Font* font, bool batched) {
+    // a re-initialized text gives up the pins of its previous glyphs, possibly on another font
+    for (char32_t codepoint : mPinnedCodepoints_) {
+        mpFont_->releaseGlyph(codepoint);
+    }
+    mPinnedCodepoints_.clear();
+    // a frame in flight may still draw the previous text
+    if (mVertexBuffer_ != nullptr) {
+        gContext.deferDestroy([&gContext, buffer = mVertexBuffer_, memory = mVertexBufferMemory_]() {
+            gContext.getDevice().destroyBuffer(buffer);
+            gContext.freeMemory(memory);
+        });
+        mVertexBuffer_ = nullptr;
+        mVertexBufferMemory_ = nullptr;
+    }
+
     mText_ = text;
     mpFont_ = font;
+    mCodepoints_ = utils::decodeUtf8(mText_);
+    mVertices_.clear();
+    mGlyphQuads_.clear();
+
+    // pinned until finalize so the atlas never evicts a glyph this text draws
+    std::vector<Font::CharacterInfo> glyphs;
+    glyphs.reserve(mCodepoints_.size());
     float totalWidth = 0.0f;
-    for (const char& c : mText_) {
-        const Font::CharacterInfo& glyph = mpFont_->getCharacterInfo(c);
-        totalWidth += (glyph.advance >> 6);
+    for (char32_t codepoint : mCodepoints_) {
+        bool pinned = false;
+        glyphs.push_back(mpFont_->acquireGlyph(codepoint, pinned));
+        if (pinned) {
+            mPinnedCodepoints_.push_back(codepoint);
+        }
+        totalWidth += (glyphs.back().advance >> 6);
     }
+    mpFont_->flushAtlas();
 
     float x =  -totalWidth / 2.0f; // starting x position
     float y = 0.0f; // baseline y position
 
-    for (char c : mText_) {
-        const Font::CharacterInfo& glyph = mpFont_->getCharacterInfo(c);
+    for (size_t i = 0; i < glyphs.size(); ++i) {
+        const Font::CharacterInfo& glyph = glyphs[i];
         if (glyph.width == 0 || glyph.height == 0) {
             x += glyph.advance / 64.0f; // Skip empty glyphs
             continue;
@@ -29,11 +56,17 @@ void TextRenderable::initialize(BaseGraphicsContext& gContext, const std::string
         float w = static_cast<float>(glyph.width);
         float h = static_cast<float>(glyph.height);
 
-        // Normalized tex coords for full glyph image
-        float u0 = 0.0f, v0 = 1.0f;
-        float u1 = 1.0f, v1 = 0.0f;
+        mGlyphQuads_.push_back({ glm::vec4(xpos, ypos, w, h), glyph.uvRect });
+        if (batched) {
+            x += glyph.advance / 64.0f;
+            continue;
+        }
 
-        int glyphIndex = static_cast<int>(c);
+        // glyph rect in the font atlas, bitmap rows run top down
+        float u0 = glyph.uvRect.x, v0 = glyph.uvRect.y + glyph.uvRect.w;
+        float u1 = glyph.uvRect.x + glyph.uvRect.z, v1 = glyph.uvRect.y;
+
+        int glyphIndex = static_cast<int>(mCodepoints_[i]);
 
         // Triangle 1
         mVertices_.push_back({ glm::vec4(xpos,     ypos + h, u0, v1), glyphIndex });
@@ -48,47 +81,33 @@ void TextRenderable::initialize(BaseGraphicsContext& gContext, const std::string
         x += glyph.advance / 64.0f; // advance in pixels
     }
 
-    createVertexBuffer(gContext);
+    if (!batched) {
+        createVertexBuffer(gContext);
+    }
 }
 
 void TextRenderable::createVertexBuffer(BaseGraphicsContext& gContext) {
-    vk::DeviceSize bufferSize = sizeof(mVertices_[0]) * mVertices_.size();
-
-    vk::Buffer stagingBuffer;
-    vk::DeviceMemory stagingBufferMemory;
-    gContext.createBuffer(
-        bufferSize,
-        vk::BufferUsageFlagBits::eTransferSrc,
-        vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
-        stagingBuffer,
-        stagingBufferMemory
-    );
-
-    void* data = gContext.getDevice().mapMemory(
-        stagingBufferMemory, 
-        0,
-        bufferSize
-    );
-    std::memcpy(data, mVertices_.data(), static_cast<size_t>(bufferSize));
-    gContext.getDevice().unmapMemory(stagingBufferMemory);
-
-    gContext.createBuffer(
-        bufferSize,
-        vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer ,
-        vk::MemoryPropertyFlagBits::eDeviceLocal,
+    gContext.createDeviceLocalBuffer(
+        mVertices_.data(),
+        sizeof(mVertices_[0]) * mVertices_.size(),
+        vk::BufferUsageFlagBits::eVertexBuffer,
         mVertexBuffer_,
         mVertexBufferMemory_
     );
-
-    gContext.copyBuffer(stagingBuffer, mVertexBuffer_, bufferSize);
-
-    gContext.getDevice().destroyBuffer(stagingBuffer);
-    gContext.getDevice().freeMemory(stagingBufferMemory);
 }
 
 void TextRenderable::finalize(BaseGraphicsContext& gContext) {
-    gContext.getDevice().destroyBuffer(mVertexBuffer_);
-    gContext.getDevice().freeMemory(mVertexBufferMemory_);
+    for (char32_t codepoint : mPinnedCodepoints_) {
+        mpFont_->releaseGlyph(codepoint);
+    }
+    mPinnedCodepoints_.clear();
+    mCodepoints_.clear();
+    if (mVertexBuffer_ != nullptr) {
+        gContext.getDevice().destroyBuffer(mVertexBuffer_);
+        gContext.freeMemory(mVertexBufferMemory_);
+        mVertexBuffer_ = nullptr;
+        mVertexBufferMemory_ = nullptr;
+    }
 }
 
 void TextRenderable::render(vk::CommandBuffer cmdBuffer, const glm::mat4& parentModelMat) {
@@ -7,7 +7,38 @@ namespace clay::ecs {
 RenderSystem::RenderSystem(BaseGraphicsContext& gContext, Resources& resources)
     : mGContext_(gContext), mResources_(resources) {}
 
+void RenderSystem::cull(EntityManager& entityManager, vk::CommandBuffer cmdBuffer, const glm::mat4& viewProjection, const glm::vec3& cameraPosition) {
+    for (clay::ecs::Entity e: entityManager.mCurrentEntities_) {
+        if (entityManager.mSignatures[e][clay::ecs::ComponentType::METADATA] && !entityManager.mMetaData[e].enabled) {
+            continue;
+        }
+        if (!entityManager.mSignatures[e][clay::ecs::ComponentType::TRANSFORM] || !entityManager.mSignatures[e][clay::ecs::ComponentType::MODEL]) {
+            continue;
+        }
+        clay::ecs::ModelRenderable& model = entityManager.mModelRenderable[e];
+        if (model.mpCuller_ == nullptr) {
+            continue;
+        }
+        clay::ecs::Transform& transform = entityManager.mTransforms[e];
+
+        glm::mat4 translationMat = glm::translate(glm::mat4(1.0f), transform.mPosition_);
+        const glm::mat4 rotationMatrix = glm::mat4_cast(transform.mOrientation_);
+        glm::mat4 scaleMat = glm::scale(glm::mat4(1.0f), transform.mScale_);
+
+        model.mpCuller_->cull(
+            cmdBuffer,
+            viewProjection,
+            translationMat * rotationMatrix * scaleMat * model.localModelMat,
+            cameraPosition
+        );
+    }
+}
+
 void RenderSystem::render(EntityManager& entityManager, vk::CommandBuffer cmdBuffer) {
+    // sprites sharing an atlas page share a material, so consecutive ones skip the rebind
+    const Material* pBoundSpriteMaterial = nullptr;
+    Mesh* pBoundSpriteMesh = nullptr;
+
     // TODO for (auto chunk : view<MeshHandle, Transform>()) {
     for (clay::ecs::Entity e: entityManager.mCurrentEntities_) {
         if (entityManager.mSignatures[e][clay::ecs::ComponentType::METADATA] && !entityManager.mMetaData[e].enabled) {
@@ -29,7 +60,17 @@ void RenderSystem::render(EntityManager& entityManager, vk::CommandBuffer cmdBuf
             push.model = translationMat * rotationMatrix * scaleMat * model.localModelMat;
             push.color = model.mColor_;
 
-            mResources_[model.modelHandle].render(cmdBuffer, &push, sizeof(push));
+            if (model.mStreamId_ != TextureStreamer::NO_STREAM) {
+                mResources_.getTextureStreamer().reportUsage(model.mStreamId_, push.model);
+            }
+
+            if (model.mpCuller_ != nullptr) {
+                mResources_[model.modelHandle].render(mResources_, *model.mpCuller_, cmdBuffer, &push, sizeof(push));
+            } else {
+                mResources_[model.modelHandle].render(mResources_, cmdBuffer, &push, sizeof(push));
+            }
+            pBoundSpriteMaterial = nullptr;
+            pBoundSpriteMesh = nullptr;
         } else if (entityManager.mSignatures[e][clay::ecs::ComponentType::TRANSFORM] && entityManager.mSignatures[e][clay::ecs::ComponentType::TEXT]) {
             clay::ecs::Transform& transform = entityManager.mTransforms[e];
             clay::ecs::TextRenderable& text = entityManager.mTextRenderables[e];
@@ -38,6 +79,16 @@ void RenderSystem::render(EntityManager& entityManager, vk::CommandBuffer cmdBuf
             const glm::mat4 rotationMatrix = glm::mat4_cast(transform.mOrientation_);
             glm::mat4 scaleMat = glm::scale(glm::mat4(1.0f), transform.mScale_);
 
+            if (mpTextBatcher_ != nullptr) {
+                mpTextBatcher_->add(
+                    *text.mpFont_,
+                    text.mGlyphQuads_,
+                    translationMat * rotationMatrix * scaleMat * glm::scale(glm::mat4(1.0f), text.mScale_),
+                    text.mColor_
+                );
+                continue;
+            }
+
             text.mpFont_->getMaterial().bindMaterial(cmdBuffer);
 
             struct PushConstants {
@@ -55,12 +106,17 @@ void RenderSystem::render(EntityManager& entityManager, vk::CommandBuffer cmdBuf
 
             cmdBuffer.bindVertexBuffers(0, 1, vertexBuffers, offsets);
             cmdBuffer.draw(static_cast<uint32_t>(text.mVertices_.size()), 1, 0, 0);
+            pBoundSpriteMaterial = nullptr;
+            pBoundSpriteMesh = nullptr;
 
         } else if (entityManager.mSignatures[e][clay::ecs::ComponentType::TRANSFORM] && entityManager.mSignatures[e][clay::ecs::ComponentType::SPRITE]) {
             clay::ecs::Transform& transform = entityManager.mTransforms[e];
             clay::ecs::SpriteRenderable& sprite = entityManager.mSpriteRenderables[e];
 
-            sprite.mpMaterial_->bindMaterial(cmdBuffer);
+            if (sprite.mpMaterial_ != pBoundSpriteMaterial) {
+                sprite.mpMaterial_->bindMaterial(cmdBuffer);
+                pBoundSpriteMaterial = sprite.mpMaterial_;
+            }
 
             glm::mat4 translationMat = glm::translate(glm::mat4(1.0f), transform.mPosition_);
             const glm::mat4 rotationMatrix = glm::mat4_cast(transform.mOrientation_);
@@ -76,6 +132,10 @@ void RenderSystem::render(EntityManager& entityManager, vk::CommandBuffer cmdBuf
             push.color = sprite.mColor_;
             push.offsets = sprite.mSpriteOffset_;
 
+            if (sprite.mStreamId_ != TextureStreamer::NO_STREAM) {
+                mResources_.getTextureStreamer().reportUsage(sprite.mStreamId_, push.model);
+            }
+
             sprite.mpMaterial_->pushConstants(
                 cmdBuffer,
                 &push,
@@ -83,10 +143,21 @@ void RenderSystem::render(EntityManager& entityManager, vk::CommandBuffer cmdBuf
                 vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment
             );
 
-            sprite.mpMesh_->bindMesh(cmdBuffer);
+            if (sprite.mpMesh_ != pBoundSpriteMesh) {
+                sprite.mpMesh_->bindMesh(cmdBuffer);
+                pBoundSpriteMesh = sprite.mpMesh_;
+            }
             cmdBuffer.drawIndexed(sprite.mpMesh_->getIndicesCount(), 1, 0, 0, 0);
         }
     }
+
+    if (mpTextBatcher_ != nullptr) {
+        mpTextBatcher_->draw(cmdBuffer);
+    }
+}
+
+void RenderSystem::setTextBatcher(TextBatcher* pTextBatcher) {
+    mpTextBatcher_ = pTextBatcher;
 }
 
 } // namespace clay::ecs
\ No newline at end of file
@@ -1,5 +1,11 @@
 // standard lib
+#include <algorithm>
+#include <iterator>
+#include <numeric>
 #include <stdexcept>
+#include <vector>
+// clay
+#include "clay/graphics/common/GpuArena.h"
 // class
 #include "clay/graphics/common/BaseGraphicsContext.h"
 
@@ -39,8 +45,402 @@ void BaseGraphicsContext::populateImage(vk::Image image, utils::ImageData& image
         static_cast<uint32_t>(imageData.height)
     );
 
-    mDevice_.destroyBuffer(stagingBuffer);
-    mDevice_.freeMemory(stagingBufferMemory);
+    releaseStagingBuffer(stagingBuffer, stagingBufferMemory);
+}
+
+namespace {
+
+bool isSrgbFormat(vk::Format format) {
+    switch (format) {
+        case vk::Format::eR8Srgb:
+        case vk::Format::eR8G8Srgb:
+        case vk::Format::eR8G8B8Srgb:
+        case vk::Format::eB8G8R8Srgb:
+        case vk::Format::eR8G8B8A8Srgb:
+        case vk::Format::eB8G8R8A8Srgb:
+            return true;
+        default:
+            return false;
+    }
+}
+
+} // namespace
+
+void BaseGraphicsContext::uploadImage(
+    vk::Image image,
+    vk::Format format,
+    const utils::ImageData& imageData,
+    uint32_t mipLevels,
+    utils::MipFilter cpuFilter
+) {
+    const bool gpuMipmaps = mipLevels > 1 && supportsLinearBlit(format);
+
+    // the CPU fallback uploads every level, the blit path only the first
+    std::vector<utils::ImageData> cpuLevels;
+    if (mipLevels > 1 && !gpuMipmaps) {
+        const bool srgb = isSrgbFormat(format);
+        const utils::ImageData* previous = &imageData;
+        cpuLevels.reserve(mipLevels - 1);
+        for (uint32_t level = 1; level < mipLevels; ++level) {
+            cpuLevels.push_back(utils::downsampleImage(*previous, cpuFilter, srgb));
+            previous = &cpuLevels.back();
+        }
+    }
+
+    std::vector<ImageLevel> levels;
+    auto addLevel = [&levels](const utils::ImageData& levelData) {
+        levels.push_back({
+            levelData.pixels.get(),
+            static_cast<vk::DeviceSize>(levelData.width) * levelData.height * levelData.channels,
+            static_cast<uint32_t>(levelData.width),
+            static_cast<uint32_t>(levelData.height)
+        });
+    };
+    addLevel(imageData);
+    for (const utils::ImageData& eachLevel : cpuLevels) {
+        addLevel(eachLevel);
+    }
+
+    uploadImageLevels(image, format, levels, mipLevels);
+}
+
+void BaseGraphicsContext::uploadImageLevels(vk::Image image, vk::Format format, const std::vector<ImageLevel>& levels, uint32_t mipLevels) {
+    if (levels.empty()) {
+        throw std::runtime_error("uploadImageLevels: no levels to upload");
+    }
+    mipLevels = std::max(mipLevels, static_cast<uint32_t>(levels.size()));
+    const bool blitRemaining = mipLevels > levels.size();
+    if (blitRemaining && levels.size() != 1) {
+        throw std::runtime_error("uploadImageLevels: missing levels can only be generated from a single level");
+    }
+
+    // offsets must be a multiple of both the texel block size and 4, 3, 6 and 12 byte texels included
+    const vk::DeviceSize offsetAlignment = std::lcm(vk::DeviceSize(vk::blockSize(format)), vk::DeviceSize(4));
+    std::vector<vk::BufferImageCopy> regions;
+    vk::DeviceSize stagingSize = 0;
+    for (uint32_t level = 0; level < levels.size(); ++level) {
+        stagingSize = (stagingSize + offsetAlignment - 1) / offsetAlignment * offsetAlignment;
+        regions.push_back({
+            .bufferOffset = stagingSize,
+            .bufferRowLength = 0,
+            .bufferImageHeight = 0,
+            .imageSubresource = {
+                .aspectMask = vk::ImageAspectFlagBits::eColor,
+                .mipLevel = level,
+                .baseArrayLayer = 0,
+                .layerCount = 1,
+            },
+            .imageOffset = {0, 0, 0},
+            .imageExtent = {
+                levels[level].width,
+                levels[level].height,
+                1
+            }
+        });
+        stagingSize += levels[level].size;
+    }
+
+    vk::Buffer stagingBuffer;
+    vk::DeviceMemory stagingBufferMemory;
+    createBuffer(
+        stagingSize,
+        vk::BufferUsageFlagBits::eTransferSrc,
+        vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+        stagingBuffer,
+        stagingBufferMemory
+    );
+
+    uint8_t* data = static_cast<uint8_t*>(mDevice_.mapMemory(stagingBufferMemory, 0, stagingSize));
+    for (uint32_t level = 0; level < levels.size(); ++level) {
+        memcpy(data + regions[level].bufferOffset, levels[level].data, static_cast<size_t>(levels[level].size));
+    }
+    mDevice_.unmapMemory(stagingBufferMemory);
+
+    vk::CommandBuffer commandBuffer = beginSingleTimeCommands();
+
+    vk::ImageMemoryBarrier barrier{
+        .srcAccessMask = vk::AccessFlagBits::eNone,
+        .dstAccessMask = vk::AccessFlagBits::eTransferWrite,
+        .oldLayout = vk::ImageLayout::eUndefined,
+        .newLayout = vk::ImageLayout::eTransferDstOptimal,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = image,
+        .subresourceRange = {
+            .aspectMask = vk::ImageAspectFlagBits::eColor,
+            .baseMipLevel = 0,
+            .levelCount = mipLevels,
+            .baseArrayLayer = 0,
+            .layerCount = 1
+        }
+    };
+    commandBuffer.pipelineBarrier(
+        vk::PipelineStageFlagBits::eTopOfPipe,
+        vk::PipelineStageFlagBits::eTransfer,
+        {},
+        nullptr,
+        nullptr,
+        { barrier }
+    );
+
+    commandBuffer.copyBufferToImage(
+        stagingBuffer,
+        image,
+        vk::ImageLayout::eTransferDstOptimal,
+        static_cast<uint32_t>(regions.size()),
+        regions.data()
+    );
+
+    if (blitRemaining) {
+        recordGenerateMipmaps(
+            commandBuffer,
+            image,
+            static_cast<int32_t>(levels[0].width),
+            static_cast<int32_t>(levels[0].height),
+            mipLevels
+        );
+    } else {
+        barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+        barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+        barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+        barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+        commandBuffer.pipelineBarrier(
+            vk::PipelineStageFlagBits::eTransfer,
+            vk::PipelineStageFlagBits::eFragmentShader,
+            {},
+            nullptr,
+            nullptr,
+            { barrier }
+        );
+    }
+
+    endSingleTimeCommands(commandBuffer);
+
+    releaseStagingBuffer(stagingBuffer, stagingBufferMemory);
+}
+
+void BaseGraphicsContext::updateImageRegion(vk::Image image, const ImageLevel& region, vk::Offset2D offset) {
+    vk::Buffer stagingBuffer;
+    vk::DeviceMemory stagingBufferMemory;
+    createBuffer(
+        region.size,
+        vk::BufferUsageFlagBits::eTransferSrc,
+        vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+        stagingBuffer,
+        stagingBufferMemory
+    );
+
+    void* data = mDevice_.mapMemory(stagingBufferMemory, 0, region.size);
+    memcpy(data, region.data, static_cast<size_t>(region.size));
+    mDevice_.unmapMemory(stagingBufferMemory);
+
+    vk::CommandBuffer commandBuffer = beginSingleTimeCommands();
+
+    vk::ImageMemoryBarrier barrier{
+        .srcAccessMask = vk::AccessFlagBits::eShaderRead,
+        .dstAccessMask = vk::AccessFlagBits::eTransferWrite,
+        .oldLayout = vk::ImageLayout::eShaderReadOnlyOptimal,
+        .newLayout = vk::ImageLayout::eTransferDstOptimal,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = image,
+        .subresourceRange = {
+            .aspectMask = vk::ImageAspectFlagBits::eColor,
+            .baseMipLevel = 0,
+            .levelCount = 1,
+            .baseArrayLayer = 0,
+            .layerCount = 1
+        }
+    };
+    commandBuffer.pipelineBarrier(
+        vk::PipelineStageFlagBits::eFragmentShader,
+        vk::PipelineStageFlagBits::eTransfer,
+        {},
+        nullptr,
+        nullptr,
+        { barrier }
+    );
+
+    const vk::BufferImageCopy copyRegion{
+        .bufferOffset = 0,
+        .bufferRowLength = 0,
+        .bufferImageHeight = 0,
+        .imageSubresource = {
+            .aspectMask = vk::ImageAspectFlagBits::eColor,
+            .mipLevel = 0,
+            .baseArrayLayer = 0,
+            .layerCount = 1,
+        },
+        .imageOffset = {offset.x, offset.y, 0},
+        .imageExtent = {region.width, region.height, 1}
+    };
+    commandBuffer.copyBufferToImage(stagingBuffer, image, vk::ImageLayout::eTransferDstOptimal, 1, &copyRegion);
+
+    barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+    barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+    barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+    barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+    commandBuffer.pipelineBarrier(
+        vk::PipelineStageFlagBits::eTransfer,
+        vk::PipelineStageFlagBits::eFragmentShader,
+        {},
+        nullptr,
+        nullptr,
+        { barrier }
+    );
+
+    endSingleTimeCommands(commandBuffer);
+
+    releaseStagingBuffer(stagingBuffer, stagingBufferMemory);
+}
+
+void BaseGraphicsContext::recordGenerateMipmaps(vk::CommandBuffer commandBuffer, vk::Image image, int32_t texWidth, int32_t texHeight, uint32_t mipLevels) {
+    vk::ImageMemoryBarrier barrier{
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = image,
+        .subresourceRange = {
+            .aspectMask =  vk::ImageAspectFlagBits::eColor,
+            .levelCount = 1,
+            .baseArrayLayer = 0,
+            .layerCount = 1,
+        }
+    };
+
+    int32_t mipWidth = texWidth;
+    int32_t mipHeight = texHeight;
+
+    for (uint32_t i = 1; i < mipLevels; i++) {
+        barrier.subresourceRange.baseMipLevel = i - 1;
+        barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+        barrier.newLayout = vk::ImageLayout::eTransferSrcOptimal;
+        barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+        barrier.dstAccessMask = vk::AccessFlagBits::eTransferRead;
+
+        commandBuffer.pipelineBarrier(
+            vk::PipelineStageFlagBits::eTransfer,
+            vk::PipelineStageFlagBits::eTransfer,
+            {},
+            nullptr,
+            nullptr,
+            barrier
+        );
+
+        vk::ImageBlit blit{
+            .srcSubresource = {
+                .aspectMask = vk::ImageAspectFlagBits::eColor,
+                .mipLevel = i - 1,
+                .baseArrayLayer = 0,
+                .layerCount = 1
+            },
+            .srcOffsets = vk::ArrayWrapper1D<vk::Offset3D, 2>{
+                std::array<vk::Offset3D, 2>{{
+                    {0, 0, 0},
+                    {mipWidth, mipHeight, 1}
+                }}
+            },
+            .dstSubresource = {
+                .aspectMask = vk::ImageAspectFlagBits::eColor,
+                .mipLevel = i,
+                .baseArrayLayer = 0,
+                .layerCount = 1
+            },
+            .dstOffsets = vk::ArrayWrapper1D<vk::Offset3D, 2>{
+                std::array<vk::Offset3D, 2>{{
+                    {0, 0, 0},
+                    {mipWidth > 1 ? mipWidth / 2 : 1, mipHeight > 1 ? mipHeight / 2 : 1, 1}
+                }}
+            },
+        };
+
+        commandBuffer.blitImage(
+            image, vk::ImageLayout::eTransferSrcOptimal,
+            image, vk::ImageLayout::eTransferDstOptimal,
+            { blit },
+            vk::Filter::eLinear
+        );
+
+        barrier.oldLayout = vk::ImageLayout::eTransferSrcOptimal;
+        barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+        barrier.srcAccessMask = vk::AccessFlagBits::eTransferRead;
+        barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+
+        commandBuffer.pipelineBarrier(
+            vk::PipelineStageFlagBits::eTransfer,
+            vk::PipelineStageFlagBits::eFragmentShader,
+            {},
+            nullptr,
+            nullptr,
+            barrier
+        );
+
+        if (mipWidth > 1) mipWidth /= 2;
+        if (mipHeight > 1) mipHeight /= 2;
+    }
+
+    barrier.subresourceRange.baseMipLevel = mipLevels - 1;
+    barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+    barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+    barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+    barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+
+    commandBuffer.pipelineBarrier(
+        vk::PipelineStageFlagBits::eTransfer,
+        vk::PipelineStageFlagBits::eFragmentShader,
+        {},
+        nullptr,
+        nullptr,
+        barrier
+    );
+}
+
+void BaseGraphicsContext::generateMipmaps(vk::Image image, vk::Format imageFormat, int32_t texWidth, int32_t texHeight, uint32_t mipLevels) {
+    if (!supportsLinearBlit(imageFormat)) {
+        throw std::runtime_error("texture image format does not support linear blitting!");
+    }
+
+    vk::CommandBuffer commandBuffer = beginSingleTimeCommands();
+    recordGenerateMipmaps(commandBuffer, image, texWidth, texHeight, mipLevels);
+    endSingleTimeCommands(commandBuffer);
+}
+
+bool BaseGraphicsContext::supportsSampledFormat(vk::Format format) {
+    const vk::FormatProperties formatProperties = mPhysicalDevice_.getFormatProperties(format);
+    return static_cast<bool>(formatProperties.optimalTilingFeatures & vk::FormatFeatureFlagBits::eSampledImage);
+}
+
+bool BaseGraphicsContext::supportsLinearBlit(vk::Format format) {
+    const vk::FormatProperties formatProperties = mPhysicalDevice_.getFormatProperties(format);
+    const vk::FormatFeatureFlags required =
+        vk::FormatFeatureFlagBits::eBlitSrc |
+        vk::FormatFeatureFlagBits::eBlitDst |
+        vk::FormatFeatureFlagBits::eSampledImageFilterLinear;
+    return (formatProperties.optimalTilingFeatures & required) == required;
+}
+
+vk::Sampler BaseGraphicsContext::createTextureSampler(float maxAnisotropy, vk::SamplerAddressMode addressMode) {
+    const bool anisotropy = mEnabledFeatures_.samplerAnisotropy && maxAnisotropy > 1.0f;
+    const float deviceMaxAnisotropy = mPhysicalDevice_.getProperties().limits.maxSamplerAnisotropy;
+
+    vk::SamplerCreateInfo samplerInfo{
+        .magFilter = vk::Filter::eLinear,
+        .minFilter = vk::Filter::eLinear,
+        .mipmapMode = vk::SamplerMipmapMode::eLinear,
+        .addressModeU = addressMode,
+        .addressModeV = addressMode,
+        .addressModeW = addressMode,
+        .mipLodBias = 0.0f,
+        .anisotropyEnable = anisotropy ? vk::True : vk::False,
+        .maxAnisotropy = anisotropy ? std::min(maxAnisotropy, deviceMaxAnisotropy) : 1.0f,
+        .compareEnable = vk::False,
+        .compareOp = vk::CompareOp::eAlways,
+        .minLod = 0.0f,
+        .maxLod = VK_LOD_CLAMP_NONE,
+        .borderColor = vk::BorderColor::eIntOpaqueBlack,
+        .unnormalizedCoordinates = vk::False
+    };
+
+    return mDevice_.createSampler(samplerInfo);
 }
 
 vk::ImageView BaseGraphicsContext::createImageView(vk::Image image, vk::Format format, vk::ImageAspectFlags aspectFlags, uint32_t mipLevels) {
@@ -61,6 +461,10 @@ vk::ImageView BaseGraphicsContext::createImageView(vk::Image image, vk::Format f
 }
 
 vk::CommandBuffer BaseGraphicsContext::beginSingleTimeCommands() {
+    if (mUploadBatchCommands_ != nullptr) {
+        return mUploadBatchCommands_;
+    }
+
     vk::CommandBufferAllocateInfo allocInfo{
         .commandPool = mCommandPool_,
         .level = vk::CommandBufferLevel::ePrimary,
@@ -80,6 +484,10 @@ vk::CommandBuffer BaseGraphicsContext::beginSingleTimeCommands() {
 }
 
 void BaseGraphicsContext::endSingleTimeCommands(vk::CommandBuffer commandBuffer) {
+    // submitted with the rest of the batch
+    if (commandBuffer == mUploadBatchCommands_) {
+        return;
+    }
     commandBuffer.end();
 
     vk::SubmitInfo submitInfo{
@@ -92,6 +500,37 @@ void BaseGraphicsContext::endSingleTimeCommands(vk::CommandBuffer commandBuffer)
     mDevice_.freeCommandBuffers(mCommandPool_, 1, &commandBuffer);
 }
 
+void BaseGraphicsContext::beginUploadBatch() {
+    if (mUploadBatchCommands_ != nullptr) {
+        throw std::runtime_error("beginUploadBatch: a batch is already open");
+    }
+    mUploadBatchCommands_ = beginSingleTimeCommands();
+}
+
+void BaseGraphicsContext::endUploadBatch() {
+    if (mUploadBatchCommands_ == nullptr) {
+        throw std::runtime_error("endUploadBatch: no batch is open");
+    }
+    vk::CommandBuffer commandBuffer = mUploadBatchCommands_;
+    mUploadBatchCommands_ = nullptr;
+    endSingleTimeCommands(commandBuffer);
+
+    for (const auto& [buffer, memory] : mUploadBatchStaging_) {
+        mDevice_.destroyBuffer(buffer);
+        releaseMemory(memory);
+    }
+    mUploadBatchStaging_.clear();
+}
+
+void BaseGraphicsContext::releaseStagingBuffer(vk::Buffer buffer, vk::DeviceMemory memory) {
+    if (mUploadBatchCommands_ != nullptr) {
+        mUploadBatchStaging_.emplace_back(buffer, memory);
+        return;
+    }
+    mDevice_.destroyBuffer(buffer);
+    releaseMemory(memory);
+}
+
 void BaseGraphicsContext::transitionImageLayout(
     vk::Image image,
     vk::Format format,
@@ -248,7 +687,14 @@ void BaseGraphicsContext::createImage(uint32_t width,
         .memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, properties)
     };
 
-    imageMemory = mDevice_.allocateMemory(allocInfo);
+    if (mpActiveArena_ != nullptr && properties == vk::MemoryPropertyFlagBits::eDeviceLocal) {
+        const GpuArena::Allocation allocation = mpActiveArena_->allocate(memRequirements, allocInfo.memoryTypeIndex, tiling == vk::ImageTiling::eLinear);
+        imageMemory = allocation.memory;
+        mDevice_.bindImageMemory(image, imageMemory, allocation.offset);
+        return;
+    }
+
+    imageMemory = allocateMemory(allocInfo);
 
     mDevice_.bindImageMemory(image, imageMemory, 0);
 }
@@ -264,6 +710,34 @@ void BaseGraphicsContext::copyBuffer(vk::Buffer srcBuffer, vk::Buffer dstBuffer,
     endSingleTimeCommands(commandBuffer);
 }
 
+void BaseGraphicsContext::createDeviceLocalBuffer(const void* data, vk::DeviceSize size, vk::BufferUsageFlags usage, vk::Buffer& buffer, vk::DeviceMemory& bufferMemory) {
+    vk::Buffer stagingBuffer;
+    vk::DeviceMemory stagingBufferMemory;
+    createBuffer(
+        size,
+        vk::BufferUsageFlagBits::eTransferSrc,
+        vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+        stagingBuffer,
+        stagingBufferMemory
+    );
+
+    void* mapped = mDevice_.mapMemory(stagingBufferMemory, 0, size);
+    memcpy(mapped, data, static_cast<size_t>(size));
+    mDevice_.unmapMemory(stagingBufferMemory);
+
+    createBuffer(
+        size,
+        vk::BufferUsageFlagBits::eTransferDst | usage,
+        vk::MemoryPropertyFlagBits::eDeviceLocal,
+        buffer,
+        bufferMemory
+    );
+
+    copyBuffer(stagingBuffer, buffer, size);
+
+    releaseStagingBuffer(stagingBuffer, stagingBufferMemory);
+}
+
 void BaseGraphicsContext::createBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties, vk::Buffer& buffer, vk::DeviceMemory& bufferMemory) {
     vk::BufferCreateInfo bufferInfo{
         .size = size,
@@ -280,7 +754,14 @@ void BaseGraphicsContext::createBuffer(vk::DeviceSize size, vk::BufferUsageFlags
         .memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, properties)
     };
 
-    bufferMemory = mDevice_.allocateMemory(allocInfo);
+    if (mpActiveArena_ != nullptr && properties == vk::MemoryPropertyFlagBits::eDeviceLocal) {
+        const GpuArena::Allocation allocation = mpActiveArena_->allocate(memRequirements, allocInfo.memoryTypeIndex, true);
+        bufferMemory = allocation.memory;
+        mDevice_.bindBufferMemory(buffer, bufferMemory, allocation.offset);
+        return;
+    }
+
+    bufferMemory = allocateMemory(allocInfo);
 
     mDevice_.bindBufferMemory(buffer, bufferMemory, 0);
 }
@@ -297,4 +778,160 @@ std::pair<int, int> BaseGraphicsContext::getFrameDimensions() const {
     return mFrameDimensions_;
 }
 
-} // namespace clay
\ No newline at end of file
+void BaseGraphicsContext::deferDestroy(std::function<void()> destroyFn) {
+    mDeferredDestroys_.push_back({mFrameIndex_, std::move(destroyFn)});
+}
+
+void BaseGraphicsContext::advanceFrame() {
+    ++mFrameIndex_;
+
+    // a frame queued at index i may be in flight until the fence of frame i + MAX_FRAMES_IN_FLIGHT is waited on
+    auto pending = std::stable_partition(
+        mDeferredDestroys_.begin(),
+        mDeferredDestroys_.end(),
+        [this](const DeferredDestroy& entry) {
+            return entry.frameIndex + MAX_FRAMES_IN_FLIGHT > mFrameIndex_;
+        }
+    );
+    std::vector<DeferredDestroy> ready(std::make_move_iterator(pending), std::make_move_iterator(mDeferredDestroys_.end()));
+    mDeferredDestroys_.erase(pending, mDeferredDestroys_.end());
+    for (auto& entry : ready) {
+        entry.destroyFn();
+    }
+}
+
+void BaseGraphicsContext::setActiveArena(GpuArena* pArena) {
+    mpActiveArena_ = pArena;
+}
+
+GpuArena* BaseGraphicsContext::getActiveArena() const {
+    return mpActiveArena_;
+}
+
+vk::DeviceMemory BaseGraphicsContext::allocateMemory(const vk::MemoryAllocateInfo& allocInfo) {
+    vk::DeviceMemory memory = mDevice_.allocateMemory(allocInfo);
+    const uint32_t heapIndex = mPhysicalDevice_.getMemoryProperties().memoryTypes[allocInfo.memoryTypeIndex].heapIndex;
+    mAllocations_[static_cast<VkDeviceMemory>(memory)] = {allocInfo.allocationSize, heapIndex};
+    mHeapAllocated_[heapIndex] += allocInfo.allocationSize;
+    mHeapPeakAllocated_[heapIndex] = std::max(mHeapPeakAllocated_[heapIndex], mHeapAllocated_[heapIndex]);
+    return memory;
+}
+
+void BaseGraphicsContext::freeMemory(vk::DeviceMemory memory) {
+    if (memory == nullptr || mArenaBlocks_.count(static_cast<VkDeviceMemory>(memory)) != 0) {
+        return;
+    }
+    releaseMemory(memory);
+}
+
+void BaseGraphicsContext::releaseMemory(vk::DeviceMemory memory) {
+    auto it = mAllocations_.find(static_cast<VkDeviceMemory>(memory));
+    if (it != mAllocations_.end()) {
+        mHeapAllocated_[it->second.heapIndex] -= it->second.size;
+        mAllocations_.erase(it);
+    }
+    mDevice_.freeMemory(memory);
+}
+
+std::vector<BaseGraphicsContext::HeapUsage> BaseGraphicsContext::getHeapUsage() const {
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT
+    };
+    VkPhysicalDeviceMemoryProperties2 properties{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2,
+        .pNext = mpGetMemoryProperties2_ != nullptr ? &budgetProperties : nullptr
+    };
+    if (mpGetMemoryProperties2_ != nullptr) {
+        mpGetMemoryProperties2_(mPhysicalDevice_, &properties);
+    } else {
+        properties.memoryProperties = mPhysicalDevice_.getMemoryProperties();
+    }
+
+    std::vector<HeapUsage> heaps(properties.memoryProperties.memoryHeapCount);
+    for (uint32_t i = 0; i < heaps.size(); ++i) {
+        const VkMemoryHeap& heap = properties.memoryProperties.memoryHeaps[i];
+        HeapUsage& usage = heaps[i];
+        usage.size = heap.size;
+        usage.allocated = mHeapAllocated_[i];
+        usage.peakAllocated = mHeapPeakAllocated_[i];
+        usage.deviceLocal = (heap.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+        if (mpGetMemoryProperties2_ != nullptr) {
+            usage.budget = budgetProperties.heapBudget[i];
+            usage.usage = budgetProperties.heapUsage[i];
+        } else {
+            usage.budget = heap.size;
+            usage.usage = mHeapAllocated_[i];
+        }
+    }
+    return heaps;
+}
+
+uint32_t BaseGraphicsContext::getMemoryHeapIndex(vk::MemoryPropertyFlags properties) const {
+    const vk::PhysicalDeviceMemoryProperties memProperties = mPhysicalDevice_.getMemoryProperties();
+    for (uint32_t i = 0; i < memProperties.memoryTypeCount; ++i) {
+        if ((memProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+            return memProperties.memoryTypes[i].heapIndex;
+        }
+    }
+    throw std::runtime_error("No memory type has the requested properties");
+}
+
+bool BaseGraphicsContext::isMemoryBudgetEnabled() const {
+    return mpGetMemoryProperties2_ != nullptr;
+}
+
+void BaseGraphicsContext::enableMemoryBudget() {
+    // core in 1.1, the KHR alias also resolves on 1.0 instances with VK_KHR_get_physical_device_properties2
+    mpGetMemoryProperties2_ = reinterpret_cast<PFN_vkGetPhysicalDeviceMemoryProperties2KHR>(
+        mInstance_.getProcAddr("vkGetPhysicalDeviceMemoryProperties2KHR")
+    );
+}
+
+bool BaseGraphicsContext::isInstanceExtensionAvailable(const char* name) {
+    uint32_t count = 0;
+    vkEnumerateInstanceExtensionProperties(nullptr, &count, nullptr);
+    std::vector<VkExtensionProperties> extensions(count);
+    vkEnumerateInstanceExtensionProperties(nullptr, &count, extensions.data());
+    for (const VkExtensionProperties& extension : extensions) {
+        if (std::strcmp(extension.extensionName, name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+vk::DeviceMemory BaseGraphicsContext::allocateArenaBlock(vk::DeviceSize size, uint32_t memoryTypeIndex) {
+    vk::MemoryAllocateInfo allocInfo{
+        .allocationSize = size,
+        .memoryTypeIndex = memoryTypeIndex
+    };
+    vk::DeviceMemory memory = allocateMemory(allocInfo);
+    mArenaBlocks_.insert(static_cast<VkDeviceMemory>(memory));
+    return memory;
+}
+
+void BaseGraphicsContext::freeArenaBlock(vk::DeviceMemory memory) {
+    mArenaBlocks_.erase(static_cast<VkDeviceMemory>(memory));
+    releaseMemory(memory);
+}
+
+uint64_t BaseGraphicsContext::getFrameIndex() const {
+    return mFrameIndex_;
+}
+
+void BaseGraphicsContext::flushDeferredDestroys() {
+    if (mDeferredDestroys_.empty()) {
+        return;
+    }
+    mDevice_.waitIdle();
+    // destroy functions may queue more work
+    while (!mDeferredDestroys_.empty()) {
+        std::vector<DeferredDestroy> ready = std::move(mDeferredDestroys_);
+        mDeferredDestroys_.clear();
+        for (auto& entry : ready) {
+            entry.destroyFn();
+        }
+    }
+}
+
+} // namespace clay
@@ -0,0 +1,209 @@
+// standard lib
+#include <algorithm>
+#include <stdexcept>
+// third party
+#include <glm/geometric.hpp>
+#include <glm/matrix.hpp>
+// class
+#include "clay/graphics/common/ClusterCuller.h"
+
+namespace clay {
+
+namespace {
+
+// spec guaranteed minimum of maxDrawIndirectCount when multiDrawIndirect is supported
+constexpr uint32_t kMaxDrawsPerCall = (1u << 16) - 1;
+
+glm::vec4 normalizePlane(const glm::vec4& plane) {
+    const float length = glm::length(glm::vec3(plane));
+    return length > 0.0f ? plane / length : plane;
+}
+
+} // namespace
+
+std::vector<vk::DescriptorSetLayoutBinding> ClusterCuller::getDescriptorSetLayoutBindings() {
+    return {
+        {
+            .binding = 0,
+            .descriptorType = vk::DescriptorType::eStorageBuffer,
+            .descriptorCount = 1,
+            .stageFlags = vk::ShaderStageFlagBits::eCompute
+        },
+        {
+            .binding = 1,
+            .descriptorType = vk::DescriptorType::eStorageBuffer,
+            .descriptorCount = 1,
+            .stageFlags = vk::ShaderStageFlagBits::eCompute
+        }
+    };
+}
+
+vk::PushConstantRange ClusterCuller::getPushConstantRange() {
+    return {
+        .stageFlags = vk::ShaderStageFlagBits::eCompute,
+        .offset = 0,
+        .size = sizeof(CullPushConstants)
+    };
+}
+
+ClusterCuller::ClusterCuller(BaseGraphicsContext& gContext, PipelineResource& cullPipeline, Mesh& mesh, const MeshletData& meshletData)
+    : mGraphicsContext_(gContext),
+      mMesh_(mesh),
+      mMeshletCount_(static_cast<uint32_t>(meshletData.meshlets.size())) {
+    if (mMeshletCount_ == 0) {
+        throw std::runtime_error("ClusterCuller needs at least one meshlet");
+    }
+
+    std::vector<GpuMeshlet> gpuMeshlets(mMeshletCount_);
+    std::vector<vk::DrawIndexedIndirectCommand> drawCommands(mMeshletCount_);
+    for (uint32_t i = 0; i < mMeshletCount_; ++i) {
+        const Meshlet& meshlet = meshletData.meshlets[i];
+        const MeshletBounds& bounds = meshletData.bounds[i];
+
+        gpuMeshlets[i] = {
+            .boundingSphere = glm::vec4(bounds.center, bounds.radius),
+            .cone = glm::vec4(bounds.coneAxis, bounds.coneCutoff),
+            .firstIndex = meshlet.triangleOffset * 3,
+            .indexCount = meshlet.triangleCount * 3
+        };
+        // everything is visible until the first cull
+        drawCommands[i] = {
+            .indexCount = gpuMeshlets[i].indexCount,
+            .instanceCount = 1,
+            .firstIndex = gpuMeshlets[i].firstIndex,
+            .vertexOffset = 0,
+            .firstInstance = 0
+        };
+    }
+
+    mGraphicsContext_.createDeviceLocalBuffer(
+        gpuMeshlets.data(),
+        sizeof(GpuMeshlet) * gpuMeshlets.size(),
+        vk::BufferUsageFlagBits::eStorageBuffer,
+        mMeshletBuffer_,
+        mMeshletBufferMemory_
+    );
+    mGraphicsContext_.createDeviceLocalBuffer(
+        drawCommands.data(),
+        sizeof(vk::DrawIndexedIndirectCommand) * drawCommands.size(),
+        vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer,
+        mDrawBuffer_,
+        mDrawBufferMemory_
+    );
+
+    mCullMaterial_ = std::make_unique<Material>(Material::MaterialConfig{
+        .graphicsContext = mGraphicsContext_,
+        .pipelineResource = cullPipeline,
+        .bufferBindings = {
+            {
+                .buffer = mMeshletBuffer_,
+                .size = sizeof(GpuMeshlet) * gpuMeshlets.size(),
+                .binding = 0,
+                .descriptorType = vk::DescriptorType::eStorageBuffer
+            },
+            {
+                .buffer = mDrawBuffer_,
+                .size = sizeof(vk::DrawIndexedIndirectCommand) * drawCommands.size(),
+                .binding = 1,
+                .descriptorType = vk::DescriptorType::eStorageBuffer
+            }
+        }
+    });
+}
+
+ClusterCuller::~ClusterCuller() {
+    finalize();
+}
+
+void ClusterCuller::cull(vk::CommandBuffer cmdBuffer, const glm::mat4& viewProjection, const glm::mat4& model, const glm::vec3& cameraPosition) {
+    // Gribb/Hartmann plane extraction. Using the full model view projection gives the planes in model space
+    const glm::mat4 mvp = viewProjection * model;
+    const glm::mat4 rows = glm::transpose(mvp);
+
+    CullPushConstants push{};
+    push.frustumPlanes[0] = normalizePlane(rows[3] + rows[0]); // left
+    push.frustumPlanes[1] = normalizePlane(rows[3] - rows[0]); // right
+    push.frustumPlanes[2] = normalizePlane(rows[3] + rows[1]); // bottom
+    push.frustumPlanes[3] = normalizePlane(rows[3] - rows[1]); // top
+#ifdef GLM_FORCE_DEPTH_ZERO_TO_ONE
+    push.frustumPlanes[4] = normalizePlane(rows[2]);           // near, clip z is [0, w]
+#else
+    // the camera projections come from glm::perspective and glm::frustum, clip z is [-w, w]
+    push.frustumPlanes[4] = normalizePlane(rows[3] + rows[2]); // near
+#endif
+    push.frustumPlanes[5] = normalizePlane(rows[3] - rows[2]); // far
+    push.cameraPosition = glm::vec3(glm::inverse(model) * glm::vec4(cameraPosition, 1.0f));
+    push.meshletCount = mMeshletCount_;
+
+    // the previous draw must finish reading the commands before they are overwritten
+    cmdBuffer.pipelineBarrier(
+        vk::PipelineStageFlagBits::eDrawIndirect,
+        vk::PipelineStageFlagBits::eComputeShader,
+        {},
+        nullptr,
+        nullptr,
+        nullptr
+    );
+
+    mCullMaterial_->bindMaterial(cmdBuffer);
+    mCullMaterial_->pushConstants(cmdBuffer, &push, sizeof(CullPushConstants), vk::ShaderStageFlagBits::eCompute);
+    cmdBuffer.dispatch((mMeshletCount_ + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
+
+    vk::MemoryBarrier barrier{
+        .srcAccessMask = vk::AccessFlagBits::eShaderWrite,
+        .dstAccessMask = vk::AccessFlagBits::eIndirectCommandRead
+    };
+    cmdBuffer.pipelineBarrier(
+        vk::PipelineStageFlagBits::eComputeShader,
+        vk::PipelineStageFlagBits::eDrawIndirect,
+        {},
+        { barrier },
+        nullptr,
+        nullptr
+    );
+}
+
+void ClusterCuller::draw(vk::CommandBuffer cmdBuffer) {
+    mMesh_.bindMesh(cmdBuffer);
+
+    constexpr uint32_t stride = sizeof(vk::DrawIndexedIndirectCommand);
+    if (mGraphicsContext_.mEnabledFeatures_.multiDrawIndirect) {
+        for (uint32_t first = 0; first < mMeshletCount_; first += kMaxDrawsPerCall) {
+            const uint32_t drawCount = std::min(kMaxDrawsPerCall, mMeshletCount_ - first);
+            cmdBuffer.drawIndexedIndirect(mDrawBuffer_, static_cast<vk::DeviceSize>(first) * stride, drawCount, stride);
+        }
+    } else {
+        // without multiDrawIndirect the draw count must be 1
+        for (uint32_t i = 0; i < mMeshletCount_; ++i) {
+            cmdBuffer.drawIndexedIndirect(mDrawBuffer_, static_cast<vk::DeviceSize>(i) * stride, 1, stride);
+        }
+    }
+}
+
+uint32_t ClusterCuller::getMeshletCount() const {
+    return mMeshletCount_;
+}
+
+void ClusterCuller::finalize() {
+    // the descriptor set references the buffers
+    mCullMaterial_.reset();
+
+    if (mMeshletBuffer_ != nullptr) {
+        mGraphicsContext_.getDevice().destroyBuffer(mMeshletBuffer_);
+        mMeshletBuffer_ = nullptr;
+    }
+    if (mMeshletBufferMemory_ != nullptr) {
+        mGraphicsContext_.freeMemory(mMeshletBufferMemory_);
+        mMeshletBufferMemory_ = nullptr;
+    }
+    if (mDrawBuffer_ != nullptr) {
+        mGraphicsContext_.getDevice().destroyBuffer(mDrawBuffer_);
+        mDrawBuffer_ = nullptr;
+    }
+    if (mDrawBufferMemory_ != nullptr) {
+        mGraphicsContext_.freeMemory(mDrawBufferMemory_);
+        mDrawBufferMemory_ = nullptr;
+    }
+}
+
+} // namespace clay
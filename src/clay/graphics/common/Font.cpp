@@ -1,8 +1,13 @@
 // standard lib
+#include <algorithm>
+#include <cstring>
 #include <stdexcept>
+#include <string>
+#include <vector>
 // third party
 #include <ft2build.h>
 #include FT_FREETYPE_H
+#include FT_MODULE_H
 #include <glm/gtc/type_ptr.hpp>
 // clay
 #include "clay/utils/common/Logger.h"
@@ -12,85 +17,20 @@
 namespace clay {
 
 vk::VertexInputBindingDescription Font::FontVertex::getBindingDescription() {
-    return {
-        .binding = 0,
-        .stride = sizeof(FontVertex),
-        .inputRate = vk::VertexInputRate::eVertex,
-    };
+    return makeBindingDescription<FontVertex>();
 }
 
 std::array<vk::VertexInputAttributeDescription, 2> Font::FontVertex::getAttributeDescriptions() {
-    std::array<vk::VertexInputAttributeDescription, 2> attributeDescriptions{};
-    // vertex (vec4)
-    attributeDescriptions[0] = {
-        .location = 0,
-        .binding = 0,
-        .format = vk::Format::eR32G32B32A32Sfloat,
-        .offset = offsetof(FontVertex, vertex)
-    };
-
-    // glyphIndex (int)
-    attributeDescriptions[1] = {
-       .location = 1,
-       .binding = 0,
-       .format = vk::Format::eR32Sint,
-       .offset = offsetof(FontVertex, glyphIndex)
-    };
-
-    return attributeDescriptions;
-}
-
-// temp populate method TODO merge this into GraphicsContext
-void populateImage(vk::Image image, const FT_Bitmap& bitmap, BaseGraphicsContext& mGContext_) {
-    // Assuming bitmap.pixel_mode == FT_PIXEL_MODE_GRAY and bitmap.num_grays == 256
-    vk::DeviceSize imageSize = bitmap.width * bitmap.rows; // 1 byte per pixel, single channel
-
-    vk::Buffer stagingBuffer;
-    vk::DeviceMemory stagingBufferMemory;
-    mGContext_.createBuffer(
-        imageSize,
-        vk::BufferUsageFlagBits::eTransferSrc,
-        vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
-        stagingBuffer,
-        stagingBufferMemory
-    );
-
-    void* data = mGContext_.getDevice().mapMemory(stagingBufferMemory, 0, imageSize);
-    memcpy(data, bitmap.buffer, static_cast<size_t>(imageSize));
-    mGContext_.getDevice().unmapMemory(stagingBufferMemory);
-    mGContext_.transitionImageLayout(
-        image,
-        vk::Format::eR8Unorm,              // single channel 8-bit unsigned normalized
-        vk::ImageLayout::eUndefined,
-        vk::ImageLayout::eTransferDstOptimal,
-        1
-    );
-
-    mGContext_.copyBufferToImage(
-        stagingBuffer,
-        image,
-        static_cast<uint32_t>(bitmap.width),
-        static_cast<uint32_t>(bitmap.rows)
-    );
-
-    mGContext_.transitionImageLayout(
-        image,
-        vk::Format::eR8Unorm,
-        vk::ImageLayout::eTransferDstOptimal,
-        vk::ImageLayout::eShaderReadOnlyOptimal,
-        1
-    );
-
-    mGContext_.getDevice().destroyBuffer(stagingBuffer);
-    mGContext_.getDevice().freeMemory(stagingBufferMemory);
+    return makeAttributeDescriptions<FontVertex>();
 }
 
 Font::Font(BaseGraphicsContext& gContext, utils::FileData& fontFileData, ShaderModule& vertShader, ShaderModule& fragShader, UniformBuffer& uniformBuffer)
-    : mGContext_(gContext) {
+    : Font(gContext, fontFileData, vertShader, fragShader, uniformBuffer, Config{}) {}
 
-    mCharacterImage_.fill(nullptr);
-    mCharacterMemory_.fill(nullptr);
-    mCharacterImageView_.fill(nullptr);
+Font::Font(BaseGraphicsContext& gContext, utils::FileData& fontFileData, ShaderModule& vertShader, ShaderModule& fragShader, UniformBuffer& uniformBuffer, const Config& config)
+    : mGContext_(gContext),
+      mConfig_(config),
+      mAtlas_(gContext) {
 
     // Initialize the FreeType library
     FT_Library ft;
@@ -98,11 +38,15 @@ Font::Font(BaseGraphicsContext& gContext, utils::FileData& fontFileData, ShaderM
         LOG_E("ERROR::FREETYPE::Could not init FreeType Library");
         return;
     }
+    mFtLibrary_ = ft;
+
+    mFontData_ = std::make_unique<uint8_t[]>(fontFileData.size);
+    std::memcpy(mFontData_.get(), fontFileData.data.get(), fontFileData.size);
 
     FT_Face face;
     FT_Error error = FT_New_Memory_Face(
         ft,
-        reinterpret_cast<const FT_Byte*>(fontFileData.data.get()),
+        reinterpret_cast<const FT_Byte*>(mFontData_.get()),
         static_cast<FT_Long>(fontFileData.size),
         0,
         &face
@@ -110,148 +54,134 @@ Font::Font(BaseGraphicsContext& gContext, utils::FileData& fontFileData, ShaderM
 
     if (error) {
         LOG_E("ERROR::FREETYPE::Failed to load font from memory. Error code: %d", error);
-        FT_Done_FreeType(ft);
+        releaseFreeType();
         return;
     }
+    mFtFace_ = face;
+
+    uint32_t border = kGlyphPadding;
+    if (mConfig_.renderMode == RenderMode::SDF) {
+        mConfig_.sdfSpread = std::clamp<uint32_t>(mConfig_.sdfSpread, 2, 32);
+        FT_Int spread = static_cast<FT_Int>(mConfig_.sdfSpread);
+        FT_Property_Set(ft, "sdf", "spread", &spread);
+        border += mConfig_.sdfSpread;
+    }
 
-    FT_Set_Pixel_Sizes(face, 0, 48);
-
-    for (unsigned char c = 0; c < 128; ++c) {
-        if (FT_Load_Char(face, c, FT_LOAD_RENDER)) {
-            LOG_E("ERROR::FREETYTPE: Failed to load Glyph");
-            continue;
-        }
-
-        const FT_Bitmap& bitmap = face->glyph->bitmap;
-
-        mCharacterFrontInfo_[c] = {
-            .width = bitmap.width,
-            .height = bitmap.rows,
-            .bitmapLeft = face->glyph->bitmap_left,
-            .bitmapTop = face->glyph->bitmap_top,
-            .advance = static_cast<uint32_t>(face->glyph->advance.x)
-        };
-
-        if (bitmap.width == 0 || bitmap.rows == 0) {
-            continue; // Skip glyphs with no visible bitmap
-        }
+    FT_Set_Pixel_Sizes(face, 0, mConfig_.pixelSize);
+
+    // square cells one line tall fit nearly every glyph and make any freed cell reusable by any glyph
+    const FT_Size_Metrics& metrics = face->size->metrics;
+    mCellHeight_ = static_cast<uint32_t>((metrics.ascender - metrics.descender + 63) >> 6) + border * 2;
+    mCellWidth_ = mCellHeight_;
+    mCellsPerRow_ = mConfig_.atlasSize / mCellWidth_;
+    const uint32_t cellRows = mConfig_.atlasSize / mCellHeight_;
+    if (mCellsPerRow_ == 0 || cellRows == 0) {
+        releaseFreeType();
+        throw std::runtime_error(
+            "Font atlas of " + std::to_string(mConfig_.atlasSize) + " cannot hold a " +
+            std::to_string(mCellHeight_) + " pixel glyph cell"
+        );
+    }
+    mCells_.resize(static_cast<size_t>(mCellsPerRow_) * cellRows);
+    mFreeCells_.reserve(mCells_.size());
+    for (uint32_t cell = static_cast<uint32_t>(mCells_.size()); cell > 0; --cell) {
+        mFreeCells_.push_back(cell - 1);
+    }
+    mGlyphs_.reserve(mCells_.size());
+    mAtlasPixels_.assign(static_cast<size_t>(mConfig_.atlasSize) * mConfig_.atlasSize, 0);
 
-        // 1. Create vk::Image for this glyph
-        vk::ImageCreateInfo imageInfo{
-            .imageType = vk::ImageType::e2D,
-            .format = vk::Format::eR8Unorm,  // 1 channel 8-bit grayscale
-            .extent = vk::Extent3D{ static_cast<uint32_t>(bitmap.width), static_cast<uint32_t>(bitmap.rows), 1},
-            .mipLevels = 1,
-            .arrayLayers = 1,
-            .samples = vk::SampleCountFlagBits::e1,
-            .tiling = vk::ImageTiling::eOptimal,
-            .usage = vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst,
-            .sharingMode = vk::SharingMode::eExclusive,
-            .initialLayout = vk::ImageLayout::eUndefined,
-        };
-
-
-        vk::Image glyphImage =mGContext_.getDevice().createImage(imageInfo);
-
-        // 2. Allocate memory for the image, bind memory (you need to find memory type and allocate)
-        vk::MemoryRequirements memRequirements = mGContext_.getDevice().getImageMemoryRequirements(glyphImage);
-
-        vk::MemoryAllocateInfo allocInfo{
-            .allocationSize = memRequirements.size,
-            .memoryTypeIndex = mGContext_.findMemoryType(memRequirements.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal)
-        };
-
-        vk::DeviceMemory imageMemory = mGContext_.getDevice().allocateMemory(allocInfo);
-
-        mGContext_.getDevice().bindImageMemory(glyphImage, imageMemory, 0);
-
-        // 3. Create vk::ImageView for the image
-        vk::ImageViewCreateInfo viewInfo{
-            .image = glyphImage,
-            .viewType = vk::ImageViewType::e2D,
-            .format = vk::Format::eR8Unorm,
-            .subresourceRange = {
-                .aspectMask =  vk::ImageAspectFlagBits::eColor,
-                .baseMipLevel = 0,
-                .levelCount = 1,
-                .baseArrayLayer = 0,
-                .layerCount = 1
-            }
-        };
-
-        vk::ImageView glyphImageView = mGContext_.getDevice().createImageView(viewInfo);
-
-        populateImage(glyphImage, bitmap, mGContext_);
-
-        mCharacterImage_[c] = glyphImage;
-        mCharacterMemory_[c] = imageMemory;
-        mCharacterImageView_[c] = glyphImageView;
+    for (char32_t codepoint = kFirstPrewarmed; codepoint <= kLastPrewarmed; ++codepoint) {
+        findOrRasterize(codepoint);
     }
 
+    // the prewarmed glyphs go up with the image itself
+    const size_t atlasBytes = mAtlasPixels_.size();
+    utils::TextureData atlasData{
+        .storage = {std::make_unique<uint8_t[]>(atlasBytes), atlasBytes},
+        .vkFormat = static_cast<uint32_t>(vk::Format::eR8Unorm),
+        .width = mConfig_.atlasSize,
+        .height = mConfig_.atlasSize,
+        .levels = {{0, atlasBytes, mConfig_.atlasSize, mConfig_.atlasSize}}
+    };
+    std::memcpy(atlasData.storage.data.get(), mAtlasPixels_.data(), atlasBytes);
+    mAtlas_.initialize(atlasData);
+    mDirtyMinX_ = mDirtyMinY_ = UINT32_MAX;
+    mDirtyMaxX_ = mDirtyMaxY_ = 0;
+
     createPipeline(vertShader, fragShader, uniformBuffer);
 }
 
 // move constructor
 Font::Font(Font&& other)
-    : mGContext_(other.mGContext_) {
+    : mGContext_(other.mGContext_),
+      mConfig_(other.mConfig_),
+      mAtlas_(std::move(other.mAtlas_)) {
 
     mSampler_ = other.mSampler_;
-    mCharacterFrontInfo_ = other.mCharacterFrontInfo_;
-    mCharacterImage_ = other.mCharacterImage_;
-    mCharacterMemory_ = other.mCharacterMemory_;
-    mCharacterImageView_ = other.mCharacterImageView_;
+    mFontData_ = std::move(other.mFontData_);
+    mFtLibrary_ = other.mFtLibrary_;
+    mFtFace_ = other.mFtFace_;
+    mGlyphs_ = std::move(other.mGlyphs_);
+    mCells_ = std::move(other.mCells_);
+    mFreeCells_ = std::move(other.mFreeCells_);
+    mLruHead_ = other.mLruHead_;
+    mLruTail_ = other.mLruTail_;
+    mCellWidth_ = other.mCellWidth_;
+    mCellHeight_ = other.mCellHeight_;
+    mCellsPerRow_ = other.mCellsPerRow_;
+    mAtlasPixels_ = std::move(other.mAtlasPixels_);
+    mDirtyMinX_ = other.mDirtyMinX_;
+    mDirtyMinY_ = other.mDirtyMinY_;
+    mDirtyMaxX_ = other.mDirtyMaxX_;
+    mDirtyMaxY_ = other.mDirtyMaxY_;
 
     mPipeline_ = std::move(other.mPipeline_);
     mMaterial_ = std::move(other.mMaterial_);
 
     other.mSampler_ = nullptr;
-    for (size_t i = 0; i < 128; ++i) {
-        other.mCharacterImageView_[i] = nullptr;
-        other.mCharacterImage_[i] = nullptr;
-        other.mCharacterMemory_[i] = nullptr;
-    }
+    other.mFtLibrary_ = nullptr;
+    other.mFtFace_ = nullptr;
 }
 
 // move assignment
 Font& Font::operator=(Font&& other) noexcept {
     if (this != &other) {
+        releaseFreeType();
+
+        mConfig_ = other.mConfig_;
         mSampler_ = other.mSampler_;
-        mCharacterFrontInfo_ = other.mCharacterFrontInfo_;
-        mCharacterImage_ = other.mCharacterImage_;
-        mCharacterMemory_ = other.mCharacterMemory_;
-        mCharacterImageView_ = other.mCharacterImageView_;
+        mFontData_ = std::move(other.mFontData_);
+        mFtLibrary_ = other.mFtLibrary_;
+        mFtFace_ = other.mFtFace_;
+        mGlyphs_ = std::move(other.mGlyphs_);
+        mCells_ = std::move(other.mCells_);
+        mFreeCells_ = std::move(other.mFreeCells_);
+        mLruHead_ = other.mLruHead_;
+        mLruTail_ = other.mLruTail_;
+        mCellWidth_ = other.mCellWidth_;
+        mCellHeight_ = other.mCellHeight_;
+        mCellsPerRow_ = other.mCellsPerRow_;
+        mAtlasPixels_ = std::move(other.mAtlasPixels_);
+        mDirtyMinX_ = other.mDirtyMinX_;
+        mDirtyMinY_ = other.mDirtyMinY_;
+        mDirtyMaxX_ = other.mDirtyMaxX_;
+        mDirtyMaxY_ = other.mDirtyMaxY_;
+        mAtlas_ = std::move(other.mAtlas_);
 
         mPipeline_ = std::move(other.mPipeline_);
         mMaterial_ = std::move(other.mMaterial_);
 
         other.mSampler_ = nullptr;
-        for (size_t i = 0; i < 128; ++i) {
-            other.mCharacterImageView_[i] = nullptr;
-            other.mCharacterImage_[i] = nullptr;
-            other.mCharacterMemory_[i] = nullptr;
-        }
+        other.mFtLibrary_ = nullptr;
+        other.mFtFace_ = nullptr;
     }
     return *this;
 }
 
 Font::~Font() {
-    for (size_t i = 0; i < 128; ++i) {
-        if (mCharacterImageView_[i] != nullptr) {
-            mGContext_.getDevice().destroyImageView(mCharacterImageView_[i]);
-            mCharacterImageView_[i] = nullptr;
-        }
-
-        if (mCharacterImage_[i] != nullptr) {
-            mGContext_.getDevice().destroyImage(mCharacterImage_[i]);
-            mCharacterImage_[i] = nullptr;
-        }
-
-        if (mCharacterMemory_[i] != nullptr) {
-            mGContext_.getDevice().freeMemory(mCharacterMemory_[i]);
-            mCharacterMemory_[i] = nullptr;
-        }
-    }
+    mAtlas_.finalize();
     mGContext_.getDevice().destroySampler(mSampler_);
+    releaseFreeType();
 }
 
 const PipelineResource& Font::getPipeline() const {
@@ -262,8 +192,212 @@ const Material& Font::getMaterial() const {
     return *mMaterial_;
 }
 
-const Font::CharacterInfo& Font::getCharacterInfo(char c) const {
-    return mCharacterFrontInfo_[static_cast<int>(c)];
+Font::CharacterInfo Font::getCharacterInfo(char32_t codepoint) {
+    return findOrRasterize(codepoint).info;
+}
+
+Font::CharacterInfo Font::acquireGlyph(char32_t codepoint, bool& pinned) {
+    const CachedGlyph glyph = findOrRasterize(codepoint);
+    pinned = glyph.cell != kNoCell;
+    if (pinned && mCells_[glyph.cell].pinCount++ == 0) {
+        lruRemove(glyph.cell);
+    }
+    return glyph.info;
+}
+
+void Font::releaseGlyph(char32_t codepoint) {
+    const CachedGlyph* glyph = mGlyphs_.find(codepoint);
+    if (glyph == nullptr || glyph->cell == kNoCell) {
+        return;
+    }
+    Cell& cell = mCells_[glyph->cell];
+    if (cell.pinCount > 0 && --cell.pinCount == 0) {
+        lruPushBack(glyph->cell);
+    }
+}
+
+void Font::flushAtlas() {
+    if (mDirtyMinX_ >= mDirtyMaxX_ || mDirtyMinY_ >= mDirtyMaxY_) {
+        return;
+    }
+    const uint32_t width = mDirtyMaxX_ - mDirtyMinX_;
+    const uint32_t height = mDirtyMaxY_ - mDirtyMinY_;
+    std::vector<uint8_t> region(static_cast<size_t>(width) * height);
+    for (uint32_t row = 0; row < height; ++row) {
+        std::memcpy(
+            region.data() + static_cast<size_t>(row) * width,
+            mAtlasPixels_.data() + static_cast<size_t>(mDirtyMinY_ + row) * mConfig_.atlasSize + mDirtyMinX_,
+            width
+        );
+    }
+    mAtlas_.updateRegion(region.data(), mDirtyMinX_, mDirtyMinY_, width, height);
+
+    mDirtyMinX_ = mDirtyMinY_ = UINT32_MAX;
+    mDirtyMaxX_ = mDirtyMaxY_ = 0;
+}
+
+uint32_t Font::getCachedGlyphCount() const {
+    return static_cast<uint32_t>(mGlyphs_.size());
+}
+
+const Texture& Font::getAtlas() const {
+    return mAtlas_;
+}
+
+std::size_t Font::getCpuMemorySize() const {
+    return mAtlasPixels_.capacity() +
+        mCells_.capacity() * sizeof(Cell) +
+        mFreeCells_.capacity() * sizeof(uint32_t) +
+        mGlyphs_.size() * sizeof(CachedGlyph);
+}
+
+const Font::Config& Font::getConfig() const {
+    return mConfig_;
+}
+
+Font::CachedGlyph Font::findOrRasterize(char32_t codepoint) {
+    if (const CachedGlyph* cached = mGlyphs_.find(codepoint)) {
+        if (cached->cell != kNoCell && mCells_[cached->cell].pinCount == 0) {
+            lruRemove(cached->cell);
+            lruPushBack(cached->cell);
+        }
+        return *cached;
+    }
+
+    CachedGlyph glyph{
+        .info = {},
+        .cell = kNoCell
+    };
+    if (mFtFace_ == nullptr) {
+        return glyph;
+    }
+
+    // index 0 is the font's missing glyph box
+    const bool sdf = mConfig_.renderMode == RenderMode::SDF;
+    const FT_UInt glyphIndex = FT_Get_Char_Index(mFtFace_, codepoint);
+    if (FT_Load_Glyph(mFtFace_, glyphIndex, sdf ? FT_LOAD_DEFAULT : FT_LOAD_RENDER)) {
+        LOG_E("ERROR::FREETYTPE: Failed to load glyph U+%04X", static_cast<uint32_t>(codepoint));
+        return mGlyphs_.insert(codepoint, glyph);
+    }
+    glyph.info.advance = static_cast<uint32_t>(mFtFace_->glyph->advance.x);
+
+    // the distance field is computed from the outline, its bitmap is grown by the spread on every side
+    if (sdf && FT_Render_Glyph(mFtFace_->glyph, FT_RENDER_MODE_SDF)) {
+        LOG_E("ERROR::FREETYTPE: Failed to render SDF for glyph U+%04X", static_cast<uint32_t>(codepoint));
+        return mGlyphs_.insert(codepoint, glyph);
+    }
+
+    const FT_Bitmap& bitmap = mFtFace_->glyph->bitmap;
+    if (bitmap.width == 0 || bitmap.rows == 0) {
+        return mGlyphs_.insert(codepoint, glyph);
+    }
+    if (bitmap.width + kGlyphPadding * 2 > mCellWidth_ || bitmap.rows + kGlyphPadding * 2 > mCellHeight_) {
+        LOG_E(
+            "Glyph U+%04X is %ux%u, larger than the %ux%u atlas cell",
+            static_cast<uint32_t>(codepoint), bitmap.width, bitmap.rows, mCellWidth_, mCellHeight_
+        );
+        return mGlyphs_.insert(codepoint, glyph);
+    }
+
+    const uint32_t cell = allocateCell();
+    if (cell == kNoCell) {
+        // not cached so it is retried once text releases glyphs
+        LOG_E("Font atlas is full of glyphs in use, U+%04X is not drawn", static_cast<uint32_t>(codepoint));
+        return glyph;
+    }
+    mCells_[cell].codepoint = codepoint;
+    lruPushBack(cell);
+
+    // clear whatever the cell held and write the glyph at its padded top left
+    const uint32_t cellX = (cell % mCellsPerRow_) * mCellWidth_;
+    const uint32_t cellY = (cell / mCellsPerRow_) * mCellHeight_;
+    for (uint32_t row = 0; row < mCellHeight_; ++row) {
+        std::memset(mAtlasPixels_.data() + static_cast<size_t>(cellY + row) * mConfig_.atlasSize + cellX, 0, mCellWidth_);
+    }
+    const uint32_t x = cellX + kGlyphPadding;
+    const uint32_t y = cellY + kGlyphPadding;
+    for (uint32_t row = 0; row < bitmap.rows; ++row) {
+        // pitch may pad rows or be negative for bottom up bitmaps
+        std::memcpy(
+            mAtlasPixels_.data() + static_cast<size_t>(y + row) * mConfig_.atlasSize + x,
+            bitmap.buffer + static_cast<ptrdiff_t>(row) * bitmap.pitch,
+            bitmap.width
+        );
+    }
+    mDirtyMinX_ = std::min(mDirtyMinX_, cellX);
+    mDirtyMinY_ = std::min(mDirtyMinY_, cellY);
+    mDirtyMaxX_ = std::max(mDirtyMaxX_, cellX + mCellWidth_);
+    mDirtyMaxY_ = std::max(mDirtyMaxY_, cellY + mCellHeight_);
+
+    const float atlasExtent = static_cast<float>(mConfig_.atlasSize);
+    glyph.info.width = bitmap.width;
+    glyph.info.height = bitmap.rows;
+    glyph.info.bitmapLeft = mFtFace_->glyph->bitmap_left;
+    glyph.info.bitmapTop = mFtFace_->glyph->bitmap_top;
+    glyph.info.uvRect = {
+        x / atlasExtent,
+        y / atlasExtent,
+        bitmap.width / atlasExtent,
+        bitmap.rows / atlasExtent
+    };
+    glyph.cell = cell;
+    return mGlyphs_.insert(codepoint, glyph);
+}
+
+uint32_t Font::allocateCell() {
+    if (!mFreeCells_.empty()) {
+        const uint32_t cell = mFreeCells_.back();
+        mFreeCells_.pop_back();
+        return cell;
+    }
+    if (mLruHead_ == kNoCell) {
+        return kNoCell;
+    }
+
+    const uint32_t cell = mLruHead_;
+    lruRemove(cell);
+    mGlyphs_.erase(mCells_[cell].codepoint);
+    mCells_[cell] = Cell{};
+    return cell;
+}
+
+void Font::lruRemove(uint32_t cell) {
+    Cell& entry = mCells_[cell];
+    if (entry.lruPrev != kNoCell) {
+        mCells_[entry.lruPrev].lruNext = entry.lruNext;
+    } else {
+        mLruHead_ = entry.lruNext;
+    }
+    if (entry.lruNext != kNoCell) {
+        mCells_[entry.lruNext].lruPrev = entry.lruPrev;
+    } else {
+        mLruTail_ = entry.lruPrev;
+    }
+    entry.lruPrev = kNoCell;
+    entry.lruNext = kNoCell;
+}
+
+void Font::lruPushBack(uint32_t cell) {
+    Cell& entry = mCells_[cell];
+    entry.lruPrev = mLruTail_;
+    entry.lruNext = kNoCell;
+    if (mLruTail_ != kNoCell) {
+        mCells_[mLruTail_].lruNext = cell;
+    } else {
+        mLruHead_ = cell;
+    }
+    mLruTail_ = cell;
+}
+
+void Font::releaseFreeType() {
+    if (mFtFace_ != nullptr) {
+        FT_Done_Face(mFtFace_);
+        mFtFace_ = nullptr;
+    }
+    if (mFtLibrary_ != nullptr) {
+        FT_Done_FreeType(mFtLibrary_);
+        mFtLibrary_ = nullptr;
+    }
 }
 
 void Font::createPipeline(ShaderModule& vertShader, ShaderModule& fragShader, UniformBuffer& uniformBuffer) {
@@ -315,7 +449,7 @@ void Font::createPipeline(ShaderModule& vertShader, ShaderModule& fragShader, Un
         {
             .binding = 1,
             .descriptorType = vk::DescriptorType::eCombinedImageSampler,
-            .descriptorCount = 128,
+            .descriptorCount = 1,
             .stageFlags = vk::ShaderStageFlagBits::eFragment,
             .pImmutableSamplers = nullptr
         }
@@ -338,12 +472,13 @@ void Font::createPipeline(ShaderModule& vertShader, ShaderModule& fragShader, Un
     };
 
     vk::SamplerCreateInfo samplerInfo{
-        .magFilter = vk::Filter::eNearest,
-        .minFilter = vk::Filter::eNearest,
+        // distances interpolate, coverage is kept texel exact
+        .magFilter = mConfig_.renderMode == RenderMode::SDF ? vk::Filter::eLinear : vk::Filter::eNearest,
+        .minFilter = mConfig_.renderMode == RenderMode::SDF ? vk::Filter::eLinear : vk::Filter::eNearest,
         .mipmapMode = vk::SamplerMipmapMode::eNearest,
-        .addressModeU = vk::SamplerAddressMode::eClampToBorder,
-        .addressModeV = vk::SamplerAddressMode::eClampToBorder,
-        .addressModeW = vk::SamplerAddressMode::eClampToBorder,
+        .addressModeU = vk::SamplerAddressMode::eClampToEdge,
+        .addressModeV = vk::SamplerAddressMode::eClampToEdge,
+        .addressModeW = vk::SamplerAddressMode::eClampToEdge,
         .mipLodBias = 0.0f,
         .anisotropyEnable = vk::False,
         .maxAnisotropy = 1.0f,
@@ -357,17 +492,16 @@ void Font::createPipeline(ShaderModule& vertShader, ShaderModule& fragShader, Un
 
 
     mSampler_ = mGContext_.getDevice().createSampler(samplerInfo);
+    mAtlas_.setSampler(mSampler_);
 
-    for (int i = 0; i < 128; ++i) {
-        matConfig.imageArrayBindings.push_back(
-            {
-                .sampler = mSampler_,
-                .imageView = mCharacterImageView_[i] != nullptr ? mCharacterImageView_[i] : mCharacterImageView_['a'], // TODO fix this
-                .binding = 1,
-                .descriptorType = vk::DescriptorType::eCombinedImageSampler
-            }
-        );
-    }
+    matConfig.imageBindings = {
+        {
+            .sampler = mSampler_,
+            .imageView = mAtlas_.getImageView(),
+            .binding = 1,
+            .descriptorType = vk::DescriptorType::eCombinedImageSampler
+        }
+    };
 
     mMaterial_ = std::make_unique<Material>(matConfig);
 }
@@ -0,0 +1,88 @@
+// standard lib
+#include <algorithm>
+// class
+#include "clay/graphics/common/GpuArena.h"
+
+namespace clay {
+
+GpuArena::Scope::Scope(BaseGraphicsContext& gContext, GpuArena* pArena)
+    : mGraphicsContext_(gContext),
+      mpPrevious_(gContext.getActiveArena()) {
+    if (pArena != nullptr) {
+        mGraphicsContext_.setActiveArena(pArena);
+    }
+}
+
+GpuArena::Scope::~Scope() {
+    mGraphicsContext_.setActiveArena(mpPrevious_);
+}
+
+GpuArena::GpuArena(BaseGraphicsContext& gContext, vk::DeviceSize blockSize)
+    : mGraphicsContext_(gContext),
+      mBlockSize_(blockSize) {}
+
+GpuArena::~GpuArena() {
+    if (mGraphicsContext_.getActiveArena() == this) {
+        mGraphicsContext_.setActiveArena(nullptr);
+    }
+    if (mBlocks_.empty()) {
+        return;
+    }
+
+    // queued after the scene's own deferred destroys, so every object bound here is gone first
+    std::vector<vk::DeviceMemory> blocks;
+    blocks.reserve(mBlocks_.size());
+    for (const Block& block : mBlocks_) {
+        blocks.push_back(block.memory);
+    }
+    mGraphicsContext_.deferDestroy([&gContext = mGraphicsContext_, blocks]() {
+        for (vk::DeviceMemory memory : blocks) {
+            gContext.freeArenaBlock(memory);
+        }
+    });
+}
+
+GpuArena::Allocation GpuArena::allocate(const vk::MemoryRequirements& requirements, uint32_t memoryTypeIndex, bool linearResource) {
+    const vk::DeviceSize alignment = std::max<vk::DeviceSize>(requirements.alignment, 1);
+    for (Block& block : mBlocks_) {
+        if (block.memoryTypeIndex != memoryTypeIndex || block.linearResources != linearResource) {
+            continue;
+        }
+        const vk::DeviceSize offset = (block.used + alignment - 1) / alignment * alignment;
+        if (offset + requirements.size <= block.size) {
+            mAllocatedBytes_ += offset + requirements.size - block.used;
+            block.used = offset + requirements.size;
+            return {block.memory, offset};
+        }
+    }
+
+    // oversized resources get a block of their own
+    const vk::DeviceSize blockSize = std::max(mBlockSize_, requirements.size);
+    mBlocks_.push_back({
+        mGraphicsContext_.allocateArenaBlock(blockSize, memoryTypeIndex),
+        blockSize,
+        requirements.size,
+        memoryTypeIndex,
+        linearResource
+    });
+    mAllocatedBytes_ += requirements.size;
+    return {mBlocks_.back().memory, 0};
+}
+
+vk::DeviceSize GpuArena::getAllocatedBytes() const {
+    return mAllocatedBytes_;
+}
+
+vk::DeviceSize GpuArena::getReservedBytes() const {
+    vk::DeviceSize total = 0;
+    for (const Block& block : mBlocks_) {
+        total += block.size;
+    }
+    return total;
+}
+
+uint32_t GpuArena::getBlockCount() const {
+    return static_cast<uint32_t>(mBlocks_.size());
+}
+
+} // namespace clay
@@ -8,15 +8,19 @@ namespace clay {
 Material::Material(const MaterialConfig& config)
     : mGraphicsContext_(config.graphicsContext),
       mPipelineResource_(config.pipelineResource),
-      mDescriptorSet_(nullptr) {
-    createDescriptorSet(config);
+      mDescriptorSet_(nullptr),
+      mBufferBindings_(config.bufferBindings),
+      mImageBindings_(config.imageBindings),
+      mImageArrayBindings_(config.imageArrayBindings) {
+    createDescriptorSet();
 }
 
 void Material::bindMaterial(vk::CommandBuffer cmdBuffer) const {
-    cmdBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, getPipeline());
+    const vk::PipelineBindPoint bindPoint = mPipelineResource_.getBindPoint();
+    cmdBuffer.bindPipeline(bindPoint, getPipeline());
 
     cmdBuffer.bindDescriptorSets(
-        vk::PipelineBindPoint::eGraphics,
+        bindPoint,
         getPipelineLayout(),
         0,
         1,
@@ -34,12 +38,18 @@ void Material::pushConstants(vk::CommandBuffer cmdBuffer, const void* data, uint
 Material::Material(Material&& other) 
     : mGraphicsContext_(other.mGraphicsContext_),
       mPipelineResource_(other.mPipelineResource_),
-      mDescriptorSet_(other.mDescriptorSet_) {}
+      mDescriptorSet_(other.mDescriptorSet_),
+      mBufferBindings_(std::move(other.mBufferBindings_)),
+      mImageBindings_(std::move(other.mImageBindings_)),
+      mImageArrayBindings_(std::move(other.mImageArrayBindings_)) {}
 
 // move assignment
 Material& Material::operator=(Material&& other) noexcept {
     if (this != &other) {
         mDescriptorSet_ = other.mDescriptorSet_;
+        mBufferBindings_ = std::move(other.mBufferBindings_);
+        mImageBindings_ = std::move(other.mImageBindings_);
+        mImageArrayBindings_ = std::move(other.mImageArrayBindings_);
     }
     return *this;
 }
@@ -48,7 +58,7 @@ Material::~Material() {
     // vk::DescriptorSet does not need to be finalized manually. It is freed when the vk::DescriptorPool is finalized
 }
 
-void Material::createDescriptorSet(const MaterialConfig& config) {
+void Material::createDescriptorSet() {
     // Allocate descriptor set
     vk::DescriptorSetAllocateInfo allocInfo{};
     allocInfo.descriptorPool = mGraphicsContext_.mDescriptorPool_;
@@ -62,9 +72,12 @@ void Material::createDescriptorSet(const MaterialConfig& config) {
     std::vector<vk::WriteDescriptorSet> descriptorWrites;
     std::vector<vk::DescriptorBufferInfo> bufferInfos;
     std::vector<vk::DescriptorImageInfo> imageInfos;
+    // the writes point into these, they must not reallocate
+    bufferInfos.reserve(mBufferBindings_.size());
+    imageInfos.reserve(mImageBindings_.size() + mImageArrayBindings_.size());
 
     // Handle buffer bindings
-    for (const auto& binding : config.bufferBindings) {
+    for (const auto& binding : mBufferBindings_) {
         bufferInfos.push_back({
             .buffer = binding.buffer,
             .offset = 0,
@@ -82,7 +95,7 @@ void Material::createDescriptorSet(const MaterialConfig& config) {
     }
 
     // Handle single image bindings
-    for (const auto& binding : config.imageBindings) {
+    for (const auto& binding : mImageBindings_) {
         imageInfos.push_back({
             .sampler = binding.sampler,
             .imageView = binding.imageView,
@@ -100,7 +113,7 @@ void Material::createDescriptorSet(const MaterialConfig& config) {
     }
 
     // Handle image arrays
-    for (const auto& binding : config.imageArrayBindings) {
+    for (const auto& binding : mImageArrayBindings_) {
         imageInfos.push_back({
             .sampler = binding.sampler,
             .imageView = binding.imageView,
@@ -108,14 +121,14 @@ void Material::createDescriptorSet(const MaterialConfig& config) {
         });
     }
 
-    if (!config.imageArrayBindings.empty()) {
+    if (!mImageArrayBindings_.empty()) {
         descriptorWrites.push_back({
             .dstSet = mDescriptorSet_,
-            .dstBinding = config.imageArrayBindings.front().binding,
+            .dstBinding = mImageArrayBindings_.front().binding,
             .dstArrayElement = 0,
-            .descriptorCount = static_cast<uint32_t>(config.imageArrayBindings.size()),
-            .descriptorType = config.imageArrayBindings.front().descriptorType,
-            .pImageInfo = &imageInfos[config.imageBindings.size()]
+            .descriptorCount = static_cast<uint32_t>(mImageArrayBindings_.size()),
+            .descriptorType = mImageArrayBindings_.front().descriptorType,
+            .pImageInfo = &imageInfos[mImageBindings_.size()]
         });
     }
 
@@ -143,4 +156,28 @@ const vk::DescriptorSet& Material::getDescriptorSet() const {
     return mDescriptorSet_;
 }
 
+bool Material::replaceImageView(vk::ImageView oldView, vk::ImageView newView) {
+    bool replaced = false;
+    for (auto* bindings : {&mImageBindings_, &mImageArrayBindings_}) {
+        for (auto& binding : *bindings) {
+            if (binding.imageView == oldView) {
+                binding.imageView = newView;
+                replaced = true;
+            }
+        }
+    }
+    if (!replaced) {
+        return false;
+    }
+
+    const vk::DescriptorSet oldSet = mDescriptorSet_;
+    createDescriptorSet();
+    mGraphicsContext_.deferDestroy(
+        [device = mGraphicsContext_.getDevice(), pool = mGraphicsContext_.mDescriptorPool_, oldSet]() {
+            device.freeDescriptorSets(pool, oldSet);
+        }
+    );
+    return true;
+}
+
 } // namespace clay
\ No newline at end of file
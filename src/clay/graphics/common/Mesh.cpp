@@ -1,20 +1,82 @@
 // standard lib
 #include <stdexcept>
 #include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string>
 // third party
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/packing.hpp>
+#include <glm/gtc/type_ptr.hpp>
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 // clay
 #include "clay/utils/common/Logger.h"
+#include "clay/graphics/common/MeshOptimizer.h"
 // class
 #include "clay/graphics/common/Mesh.h"
 
 namespace clay {
 
-Mesh processMesh(BaseGraphicsContext& gContext, aiMesh* mesh, const aiScene* scene) {
-    std::vector<Mesh::Vertex> vertices;
-    std::vector<unsigned int> indices;
+namespace {
+
+int16_t packSnorm16(float value) {
+    return static_cast<int16_t>(std::round(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+// Maps a unit vector onto the octahedron unfolded over [-1, 1]^2
+glm::vec2 octahedralEncode(glm::vec3 n) {
+    const float l1Norm = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+    if (l1Norm == 0.0f) {
+        return {0.0f, 0.0f}; // degenerate, decodes to +z
+    }
+    n /= l1Norm;
+    glm::vec2 encoded(n.x, n.y);
+    if (n.z < 0.0f) {
+        encoded = {
+            (1.0f - std::abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f),
+            (1.0f - std::abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f)
+        };
+    }
+    return encoded;
+}
+
+glm::i16vec2 encodeNormal(const glm::vec3& normal) {
+    const glm::vec2 encoded = octahedralEncode(normal);
+    return {packSnorm16(encoded.x), packSnorm16(encoded.y)};
+}
+
+glm::i16vec2 encodeTangent(const glm::vec3& normal, const glm::vec3& tangent, const glm::vec3& bitangent) {
+    const glm::vec2 encoded = octahedralEncode(tangent);
+    const float sign = glm::dot(glm::cross(normal, tangent), bitangent) < 0.0f ? -1.0f : 1.0f;
+    // remap y to [0, 1] and store the bitangent sign in the sign of y. Keep it off zero so the sign survives
+    const float y = std::max(encoded.y * 0.5f + 0.5f, 1.0f / 32767.0f);
+    return {packSnorm16(encoded.x), packSnorm16(y * sign)};
+}
+
+glm::u16vec2 encodeTexCoord(const glm::vec2& texCoord, Mesh::TexCoordEncoding encoding) {
+    if (encoding == Mesh::TexCoordEncoding::UNORM16) {
+        return {glm::packUnorm1x16(texCoord.x), glm::packUnorm1x16(texCoord.y)};
+    }
+    return {glm::packHalf1x16(texCoord.x), glm::packHalf1x16(texCoord.y)};
+}
+
+vk::Format texCoordFormat(Mesh::TexCoordEncoding encoding) {
+    return encoding == Mesh::TexCoordEncoding::UNORM16
+        ? vk::Format::eR16G16Unorm
+        : vk::Format::eR16G16Sfloat;
+}
+
+} // namespace
+
+void extractMesh(aiMesh* mesh, const Mesh::ImportOptions& options, std::vector<Mesh::Vertex>& vertices, std::vector<unsigned int>& indices) {
+    vertices.clear();
+    indices.clear();
+    vertices.reserve(mesh->mNumVertices);
+    indices.reserve(static_cast<size_t>(mesh->mNumFaces) * 3);
 
     for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
         Mesh::Vertex vertex;
@@ -68,69 +130,114 @@ Mesh processMesh(BaseGraphicsContext& gContext, aiMesh* mesh, const aiScene* sce
 
     // now walk through each of the mesh's faces (a face is a mesh its triangle) and retrieve the corresponding vertex indices.
     for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
-        aiFace face = mesh->mFaces[i];
-        // retrieve all indices of the face and store them in the indices vector
-        for(unsigned int j = 0; j < face.mNumIndices; ++j) {
-            indices.push_back(face.mIndices[j]);
+        const aiFace& face = mesh->mFaces[i];
+        // points and lines survive aiProcess_Triangulate, they would break the triangle list
+        if (face.mNumIndices != 3) {
+            continue;
         }
+        indices.insert(indices.end(), face.mIndices, face.mIndices + 3);
+    }
+
+    if (options.optimize) {
+        mesh_optimizer::optimizeMesh(vertices, indices, options.overdrawThreshold);
     }
+}
+
+Mesh processMesh(BaseGraphicsContext& gContext, aiMesh* mesh, const aiScene* scene, const Mesh::ImportOptions& options) {
+    std::vector<Mesh::Vertex> vertices;
+    std::vector<unsigned int> indices;
+    extractMesh(mesh, options, vertices, indices);
 
     // TODO material/texture logic
-    return {gContext, vertices, indices};
+    return {gContext, vertices, indices, options.vertexFormat, options.allowShortIndices};
 }
 
-void processNode(BaseGraphicsContext& gContext, aiNode* node, const aiScene* scene, std::vector<Mesh>& meshList) {
+void processNode(BaseGraphicsContext& gContext, aiNode* node, const aiScene* scene, std::vector<Mesh>& meshList, const Mesh::ImportOptions& options) {
     // process all the node's meshes (if any)
     for (unsigned int i = 0; i < node->mNumMeshes; ++i) {
         aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-        meshList.push_back(processMesh(gContext, mesh, scene));
+        meshList.push_back(processMesh(gContext, mesh, scene, options));
     }
     // then do the same for each of its children
     for (unsigned int i = 0; i < node->mNumChildren; ++i) {
-        processNode(gContext, node->mChildren[i], scene, meshList);
+        processNode(gContext, node->mChildren[i], scene, meshList, options);
+    }
+}
+
+// Appends every mesh under node to one vertex and index buffer, indices are rebased to the shared buffer
+void packNode(
+    aiNode* node,
+    const aiScene* scene,
+    const Mesh::ImportOptions& options,
+    const glm::mat4& parentTransform,
+    std::vector<Mesh::Vertex>& vertices,
+    std::vector<unsigned int>& indices,
+    std::vector<Mesh::SubMesh>& subMeshes
+) {
+    // assimp matrices are row major
+    const glm::mat4 transform = parentTransform * glm::transpose(glm::make_mat4(&node->mTransformation.a1));
+
+    std::vector<Mesh::Vertex> meshVertices;
+    std::vector<unsigned int> meshIndices;
+    for (unsigned int i = 0; i < node->mNumMeshes; ++i) {
+        extractMesh(scene->mMeshes[node->mMeshes[i]], options, meshVertices, meshIndices);
+
+        const uint32_t baseVertex = static_cast<uint32_t>(vertices.size());
+        subMeshes.push_back({
+            static_cast<uint32_t>(indices.size()),
+            static_cast<uint32_t>(meshIndices.size()),
+            transform
+        });
+        vertices.insert(vertices.end(), meshVertices.begin(), meshVertices.end());
+        for (unsigned int eachIndex : meshIndices) {
+            indices.push_back(eachIndex + baseVertex);
+        }
+    }
+
+    for (unsigned int i = 0; i < node->mNumChildren; ++i) {
+        packNode(node->mChildren[i], scene, options, transform, vertices, indices, subMeshes);
     }
 }
 
 vk::VertexInputBindingDescription Mesh::Vertex::getBindingDescription() {
-   return {
-        .binding = 0,
-        .stride = sizeof(Mesh::Vertex),
-        .inputRate = vk::VertexInputRate::eVertex
-    };
+    return makeBindingDescription<Vertex>();
 }
 
 std::array<vk::VertexInputAttributeDescription, 5> Mesh::Vertex::getAttributeDescriptions() {
-    std::array<vk::VertexInputAttributeDescription, 5> attributeDescriptions{};
-
-    attributeDescriptions[0].binding = 0;
-    attributeDescriptions[0].location = 0;
-    attributeDescriptions[0].format = vk::Format::eR32G32B32Sfloat;
-    attributeDescriptions[0].offset = offsetof(Mesh::Vertex, position);
-
-    attributeDescriptions[1].binding = 0;
-    attributeDescriptions[1].location = 1;
-    attributeDescriptions[1].format = vk::Format::eR32G32B32Sfloat;
-    attributeDescriptions[1].offset = offsetof(Mesh::Vertex, normal);
-
-    attributeDescriptions[2].binding = 0;
-    attributeDescriptions[2].location = 2;
-    attributeDescriptions[2].format = vk::Format::eR32G32B32Sfloat;
-    attributeDescriptions[2].offset = offsetof(Mesh::Vertex, texCoord);
+    return makeAttributeDescriptions<Vertex>();
+}
 
-    attributeDescriptions[3].binding = 0;
-    attributeDescriptions[3].location = 3;
-    attributeDescriptions[3].format = vk::Format::eR32G32B32Sfloat;
-    attributeDescriptions[3].offset = offsetof(Mesh::Vertex, tangent);
+vk::VertexInputBindingDescription Mesh::getBindingDescription(const VertexFormat& format) {
+    if (format.encoding == VertexEncoding::CUSTOM) {
+        throw std::runtime_error("CUSTOM vertex format has no fixed layout");
+    }
+    if (format.encoding == VertexEncoding::COMPACT) {
+        return makeBindingDescription<CompactVertex>();
+    } else if (format.encoding == VertexEncoding::QUANTIZED) {
+        return makeBindingDescription<QuantizedVertex>();
+    }
+    return makeBindingDescription<Vertex>();
+}
 
-    attributeDescriptions[4].binding = 0;
-    attributeDescriptions[4].location = 4;
-    attributeDescriptions[4].format = vk::Format::eR32G32B32Sfloat;
-    attributeDescriptions[4].offset = offsetof(Mesh::Vertex, bitangent);
+std::vector<vk::VertexInputAttributeDescription> Mesh::getAttributeDescriptions(const VertexFormat& format) {
+    if (format.encoding == VertexEncoding::CUSTOM) {
+        throw std::runtime_error("CUSTOM vertex format has no fixed layout");
+    }
+    VertexLayout layout = VertexLayout::of<Vertex>();
+    if (format.encoding == VertexEncoding::COMPACT) {
+        layout = VertexLayout::of<CompactVertex>();
+    } else if (format.encoding == VertexEncoding::QUANTIZED) {
+        layout = VertexLayout::of<QuantizedVertex>();
+    }
 
-    return attributeDescriptions;
+    if (format.encoding != VertexEncoding::FULL) {
+        // location 2 is texCoord for the compact layouts
+        layout.attributes[2].format = texCoordFormat(format.texCoordEncoding);
+    }
+    return layout.attributes;
 }
 
-void Mesh::parseObjFile(BaseGraphicsContext& gContext, utils::FileData& fileData, std::vector<Mesh>& meshList) {
+void Mesh::parseObjFile(BaseGraphicsContext& gContext, utils::FileData& fileData, std::vector<Mesh>& meshList, const ImportOptions& options) {
     Assimp::Importer import;
     const aiScene* scene = import.ReadFileFromMemory(
         fileData.data.get(),
@@ -143,16 +250,99 @@ void Mesh::parseObjFile(BaseGraphicsContext& gContext, utils::FileData& fileData
         return;
     }
     // Process the Assimp node and add to mMeshes_
-    processNode(gContext, scene->mRootNode, scene, meshList);
+    processNode(gContext, scene->mRootNode, scene, meshList, options);
+}
+
+Mesh Mesh::parseModelFile(BaseGraphicsContext& gContext, utils::FileData& fileData, const ImportOptions& options) {
+    return createFromImport(gContext, importModelFile(fileData, options), options);
+}
+
+Mesh::ImportedModel Mesh::importModelFile(const utils::FileData& fileData, const ImportOptions& options) {
+    Assimp::Importer import;
+    const aiScene* scene = import.ReadFileFromMemory(
+        fileData.data.get(),
+        fileData.size,
+        aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_CalcTangentSpace,
+        "obj"
+    );
+    if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
+        throw std::runtime_error(std::string("Failed to import model: ") + import.GetErrorString());
+    }
+
+    ImportedModel model;
+    packNode(scene->mRootNode, scene, options, glm::mat4(1.0f), model.vertices, model.indices, model.subMeshes);
+    return model;
+}
+
+Mesh Mesh::createFromImport(BaseGraphicsContext& gContext, const ImportedModel& model, const ImportOptions& options) {
+    Mesh mesh(gContext, model.vertices, model.indices, options.vertexFormat, options.allowShortIndices);
+    mesh.mSubMeshes_ = model.subMeshes;
+    return mesh;
+}
+
+std::vector<uint8_t> Mesh::serializeImport(const ImportedModel& model) {
+    // counts, then each array as is. The structs are plain floats and integers with no padding
+    const uint64_t counts[3] = {model.vertices.size(), model.indices.size(), model.subMeshes.size()};
+    const size_t vertexBytes = model.vertices.size() * sizeof(Vertex);
+    const size_t indexBytes = model.indices.size() * sizeof(unsigned int);
+    const size_t subMeshBytes = model.subMeshes.size() * sizeof(SubMesh);
+
+    std::vector<uint8_t> data(sizeof(counts) + vertexBytes + indexBytes + subMeshBytes);
+    uint8_t* out = data.data();
+    std::memcpy(out, counts, sizeof(counts));
+    out += sizeof(counts);
+    std::memcpy(out, model.vertices.data(), vertexBytes);
+    out += vertexBytes;
+    std::memcpy(out, model.indices.data(), indexBytes);
+    out += indexBytes;
+    std::memcpy(out, model.subMeshes.data(), subMeshBytes);
+    return data;
+}
+
+Mesh::ImportedModel Mesh::deserializeImport(const utils::FileData& data) {
+    uint64_t counts[3];
+    if (data.size < sizeof(counts)) {
+        throw std::runtime_error("Serialized import is truncated");
+    }
+    std::memcpy(counts, data.data.get(), sizeof(counts));
+    const uint64_t remaining = data.size - sizeof(counts);
+    if (counts[0] > remaining / sizeof(Vertex) ||
+        counts[1] > remaining / sizeof(unsigned int) ||
+        counts[2] > remaining / sizeof(SubMesh) ||
+        counts[0] * sizeof(Vertex) + counts[1] * sizeof(unsigned int) + counts[2] * sizeof(SubMesh) != remaining) {
+        throw std::runtime_error("Serialized import is truncated");
+    }
+
+    ImportedModel model;
+    model.vertices.resize(counts[0]);
+    model.indices.resize(counts[1]);
+    model.subMeshes.resize(counts[2]);
+    const uint8_t* in = data.data.get() + sizeof(counts);
+    std::memcpy(model.vertices.data(), in, model.vertices.size() * sizeof(Vertex));
+    in += model.vertices.size() * sizeof(Vertex);
+    std::memcpy(model.indices.data(), in, model.indices.size() * sizeof(unsigned int));
+    in += model.indices.size() * sizeof(unsigned int);
+    std::memcpy(model.subMeshes.data(), in, model.subMeshes.size() * sizeof(SubMesh));
+    return model;
 }
 
 Mesh::Mesh(BaseGraphicsContext& gContext)
     : mGraphicsContext_(gContext) {}
 
-Mesh::Mesh(BaseGraphicsContext& gContext, const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices)
-    : mGraphicsContext_(gContext) {
+Mesh::Mesh(BaseGraphicsContext& gContext, const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, const VertexFormat& format, bool allowShortIndices)
+    : mGraphicsContext_(gContext),
+      mVertexLayout_{getBindingDescription(format), getAttributeDescriptions(format)},
+      mVertexFormat_(format) {
     createVertexBuffer(vertices);
-    createIndexBuffer(indices);
+    createIndexBuffer(indices, allowShortIndices);
+}
+
+Mesh::Mesh(BaseGraphicsContext& gContext, const VertexLayout& layout, const void* vertexData, vk::DeviceSize vertexDataSize, const std::vector<unsigned int>& indices, bool allowShortIndices)
+    : mGraphicsContext_(gContext),
+      mVertexLayout_(layout),
+      mVertexFormat_{.encoding = VertexEncoding::CUSTOM} {
+    createVertexBuffer(vertexData, vertexDataSize);
+    createIndexBuffer(indices, allowShortIndices);
 }
 
 // Move constructor
@@ -164,6 +354,12 @@ Mesh::Mesh(Mesh&& other) noexcept
     mIndexBuffer_ = other.mIndexBuffer_;
     mIndexBufferMemory_ = other.mIndexBufferMemory_;
     mIndicesCount_ = other.mIndicesCount_;
+    mIndexType_ = other.mIndexType_;
+    mSubMeshes_ = std::move(other.mSubMeshes_);
+    mVertexCount_ = other.mVertexCount_;
+    mVertexLayout_ = std::move(other.mVertexLayout_);
+    mVertexFormat_ = other.mVertexFormat_;
+    mDequantizeTransform_ = other.mDequantizeTransform_;
 
     // Null out other's handles
     other.mVertexBuffer_ = nullptr;
@@ -180,6 +376,13 @@ Mesh& Mesh::operator=(Mesh&& other) noexcept {
         mVertexBufferMemory_ = other.mVertexBufferMemory_;
         mIndexBuffer_ = other.mIndexBuffer_;
         mIndexBufferMemory_ = other.mIndexBufferMemory_;
+        mIndicesCount_ = other.mIndicesCount_;
+        mIndexType_ = other.mIndexType_;
+        mSubMeshes_ = std::move(other.mSubMeshes_);
+        mVertexCount_ = other.mVertexCount_;
+        mVertexLayout_ = std::move(other.mVertexLayout_);
+        mVertexFormat_ = other.mVertexFormat_;
+        mDequantizeTransform_ = other.mDequantizeTransform_;
 
         other.mVertexBuffer_ = nullptr;
         other.mVertexBufferMemory_ = nullptr;
@@ -197,68 +400,102 @@ void Mesh::bindMesh(vk::CommandBuffer cmdBuffer) {
     vk::Buffer vertexBuffers[] = {mVertexBuffer_};
     vk::DeviceSize offsets[] = {0};
     cmdBuffer.bindVertexBuffers(0, 1, vertexBuffers, offsets);
-    cmdBuffer.bindIndexBuffer(mIndexBuffer_, 0, vk::IndexType::eUint32);
+    cmdBuffer.bindIndexBuffer(mIndexBuffer_, 0, mIndexType_);
 }
 
 void Mesh::createVertexBuffer(const std::vector<Vertex>& vertices) {
-    vk::DeviceSize bufferSize = sizeof(Vertex) * vertices.size();
+    if (mVertexFormat_.encoding == VertexEncoding::FULL) {
+        createVertexBuffer(vertices.data(), sizeof(Vertex) * vertices.size());
+        return;
+    }
 
-    vk::Buffer stagingBuffer;
-    vk::DeviceMemory stagingBufferMemory;
-    mGraphicsContext_.createBuffer(
-        bufferSize,
-        vk::BufferUsageFlagBits::eTransferSrc,
-        vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
-        stagingBuffer,
-        stagingBufferMemory
-    );
+    std::vector<glm::i16vec2> normals(vertices.size());
+    std::vector<glm::i16vec2> tangents(vertices.size());
+    std::vector<glm::u16vec2> texCoords(vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        normals[i] = encodeNormal(vertices[i].normal);
+        tangents[i] = encodeTangent(vertices[i].normal, vertices[i].tangent, vertices[i].bitangent);
+        texCoords[i] = encodeTexCoord(vertices[i].texCoord, mVertexFormat_.texCoordEncoding);
+    }
+
+    if (mVertexFormat_.encoding == VertexEncoding::COMPACT) {
+        std::vector<CompactVertex> compactVertices(vertices.size());
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            compactVertices[i] = {vertices[i].position, normals[i], tangents[i], texCoords[i]};
+        }
+        createVertexBuffer(compactVertices.data(), sizeof(CompactVertex) * compactVertices.size());
+        return;
+    }
+
+    // QUANTIZED: positions are stored relative to the mesh bounds
+    glm::vec3 boundsMin(0.0f);
+    glm::vec3 boundsMax(0.0f);
+    if (!vertices.empty()) {
+        boundsMin = boundsMax = vertices[0].position;
+    }
+    for (const Vertex& eachVertex : vertices) {
+        boundsMin = glm::min(boundsMin, eachVertex.position);
+        boundsMax = glm::max(boundsMax, eachVertex.position);
+    }
+    glm::vec3 extent = boundsMax - boundsMin;
+    // flat axes still need a non zero scale to invert
+    extent = glm::max(extent, glm::vec3(std::numeric_limits<float>::epsilon()));
+
+    std::vector<QuantizedVertex> quantizedVertices(vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        const glm::vec3 normalized = (vertices[i].position - boundsMin) / extent;
+        quantizedVertices[i] = {
+            {glm::packUnorm1x16(normalized.x), glm::packUnorm1x16(normalized.y), glm::packUnorm1x16(normalized.z), 0},
+            normals[i],
+            tangents[i],
+            texCoords[i]
+        };
+    }
+    mDequantizeTransform_ = glm::scale(glm::translate(glm::mat4(1.0f), boundsMin), extent);
+
+    createVertexBuffer(quantizedVertices.data(), sizeof(QuantizedVertex) * quantizedVertices.size());
+}
 
-    void* data = mGraphicsContext_.getDevice().mapMemory(stagingBufferMemory, 0, bufferSize);
-    memcpy(data, vertices.data(), (size_t) bufferSize);
-    mGraphicsContext_.getDevice().unmapMemory(stagingBufferMemory);
+void Mesh::createVertexBuffer(const void* vertexData, vk::DeviceSize bufferSize) {
+    mVertexCount_ = static_cast<uint32_t>(bufferSize / mVertexLayout_.binding.stride);
 
-    mGraphicsContext_.createBuffer(
+    mGraphicsContext_.createDeviceLocalBuffer(
+        vertexData,
         bufferSize,
-        vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer,
-        vk::MemoryPropertyFlagBits::eDeviceLocal,
+        vk::BufferUsageFlagBits::eVertexBuffer,
         mVertexBuffer_,
         mVertexBufferMemory_
     );
-
-    mGraphicsContext_.copyBuffer(stagingBuffer, mVertexBuffer_, bufferSize);
-    mGraphicsContext_.getDevice().destroyBuffer(stagingBuffer);
-    mGraphicsContext_.getDevice().freeMemory(stagingBufferMemory);
 }
 
-void Mesh::createIndexBuffer(const std::vector<unsigned int>& indices) {
+void Mesh::createIndexBuffer(const std::vector<unsigned int>& indices, bool allowShortIndices) {
     mIndicesCount_ = static_cast<uint32_t>(indices.size());
-    vk::DeviceSize bufferSize = sizeof(indices[0]) * indices.size();
-
-    vk::Buffer stagingBuffer;
-    vk::DeviceMemory stagingBufferMemory;
-    mGraphicsContext_.createBuffer(
-        bufferSize,
-        vk::BufferUsageFlagBits::eTransferSrc,
-        vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
-        stagingBuffer,
-        stagingBufferMemory
-    );
+    // until told otherwise the whole buffer is one sub-mesh
+    mSubMeshes_ = {{0, mIndicesCount_, glm::mat4(1.0f)}};
+
+    if (allowShortIndices && mVertexCount_ <= std::numeric_limits<uint16_t>::max()) {
+        // halves index bandwidth, 0xFFFF stays free for primitive restart
+        mIndexType_ = vk::IndexType::eUint16;
+        const std::vector<uint16_t> shortIndices(indices.begin(), indices.end());
+
+        mGraphicsContext_.createDeviceLocalBuffer(
+            shortIndices.data(),
+            sizeof(shortIndices[0]) * shortIndices.size(),
+            vk::BufferUsageFlagBits::eIndexBuffer,
+            mIndexBuffer_,
+            mIndexBufferMemory_
+        );
+        return;
+    }
+    mIndexType_ = vk::IndexType::eUint32;
 
-    void* data = mGraphicsContext_.getDevice().mapMemory(stagingBufferMemory, 0, bufferSize);
-    memcpy(data, indices.data(), (size_t) bufferSize);
-    mGraphicsContext_.getDevice().unmapMemory(stagingBufferMemory);
-    mGraphicsContext_.createBuffer(
-        bufferSize,
-        vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer, 
-        vk::MemoryPropertyFlagBits::eDeviceLocal,
+    mGraphicsContext_.createDeviceLocalBuffer(
+        indices.data(),
+        sizeof(indices[0]) * indices.size(),
+        vk::BufferUsageFlagBits::eIndexBuffer,
         mIndexBuffer_,
         mIndexBufferMemory_
     );
-
-    mGraphicsContext_.copyBuffer(stagingBuffer, mIndexBuffer_, bufferSize);
-
-    mGraphicsContext_.getDevice().destroyBuffer(stagingBuffer);
-    mGraphicsContext_.getDevice().freeMemory(stagingBufferMemory);
 }
 
 vk::Buffer Mesh::getVertexBuffer() const {
@@ -273,13 +510,48 @@ uint32_t Mesh::getIndicesCount() const {
     return mIndicesCount_;
 }
 
+const std::vector<Mesh::SubMesh>& Mesh::getSubMeshes() const {
+    return mSubMeshes_;
+}
+
+vk::IndexType Mesh::getIndexType() const {
+    return mIndexType_;
+}
+
+uint32_t Mesh::getVertexCount() const {
+    return mVertexCount_;
+}
+
+const VertexLayout& Mesh::getVertexLayout() const {
+    return mVertexLayout_;
+}
+
+const Mesh::VertexFormat& Mesh::getVertexFormat() const {
+    return mVertexFormat_;
+}
+
+const glm::mat4& Mesh::getDequantizeTransform() const {
+    return mDequantizeTransform_;
+}
+
+vk::DeviceSize Mesh::getMemorySize() const {
+    vk::DeviceSize size = 0;
+    if (mVertexBuffer_ != nullptr) {
+        size += mGraphicsContext_.getDevice().getBufferMemoryRequirements(mVertexBuffer_).size;
+    }
+    if (mIndexBuffer_ != nullptr) {
+        size += mGraphicsContext_.getDevice().getBufferMemoryRequirements(mIndexBuffer_).size;
+    }
+    return size;
+}
+
 void Mesh::finalize() {
     if (mVertexBuffer_ != nullptr) {
         mGraphicsContext_.getDevice().destroyBuffer(mVertexBuffer_);
         mVertexBuffer_ = nullptr;
     }
     if (mVertexBufferMemory_ != nullptr) {
-        mGraphicsContext_.getDevice().freeMemory(mVertexBufferMemory_);
+        mGraphicsContext_.freeMemory(mVertexBufferMemory_);
         mVertexBufferMemory_ = nullptr;
     }
 
@@ -288,10 +560,12 @@ void Mesh::finalize() {
         mIndexBuffer_ = nullptr;
     }
     if (mIndexBufferMemory_ != nullptr) {
-        mGraphicsContext_.getDevice().freeMemory(mIndexBufferMemory_);
+        mGraphicsContext_.freeMemory(mIndexBufferMemory_);
         mIndexBufferMemory_ = nullptr;
     }
     mIndicesCount_ = 0;
+    mVertexCount_ = 0;
+    mSubMeshes_.clear();
 }
 
 
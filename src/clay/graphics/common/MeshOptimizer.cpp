@@ -0,0 +1,387 @@
+// standard lib
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <numeric>
+// third party
+#include <glm/geometric.hpp>
+// class
+#include "clay/graphics/common/MeshOptimizer.h"
+
+namespace clay::mesh_optimizer {
+
+namespace {
+
+// Forsyth scoring constants, see "Linear-Speed Vertex Cache Optimisation"
+constexpr size_t kForsythCacheSize = 32;
+constexpr float kCacheDecayPower = 1.5f;
+constexpr float kLastTriangleScore = 0.75f;
+constexpr float kValenceBoostScale = 2.0f;
+constexpr float kValenceBoostPower = 0.5f;
+
+// FIFO cache size used to find cluster boundaries for overdraw sorting
+constexpr size_t kOverdrawCacheSize = 16;
+
+float forsythVertexScore(int cachePosition, uint32_t remainingTriangles) {
+    if (remainingTriangles == 0) {
+        return -1.0f; // nothing left to draw with this vertex
+    }
+
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        if (cachePosition < 3) {
+            // used by the last triangle, fixed score so the three of them are not favored over each other
+            score = kLastTriangleScore;
+        } else {
+            const float scaler = 1.0f / static_cast<float>(kForsythCacheSize - 3);
+            score = std::pow(1.0f - static_cast<float>(cachePosition - 3) * scaler, kCacheDecayPower);
+        }
+    }
+    // boost vertices with few triangles left so they get finished off instead of being left stranded
+    score += kValenceBoostScale * std::pow(static_cast<float>(remainingTriangles), -kValenceBoostPower);
+    return score;
+}
+
+uint64_t hashBytes(const uint8_t* bytes, size_t size) {
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+} // namespace
+
+size_t generateWeldRemap(std::vector<unsigned int>& remap, const void* vertexData, size_t vertexCount, size_t vertexStride) {
+    remap.assign(vertexCount, UNUSED_VERTEX);
+    if (vertexCount == 0) {
+        return 0;
+    }
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(vertexData);
+
+    // open addressing table of original indices, kept at most half full
+    size_t tableSize = 1;
+    while (tableSize < vertexCount * 2) {
+        tableSize <<= 1;
+    }
+    const size_t tableMask = tableSize - 1;
+    std::vector<unsigned int> table(tableSize, UNUSED_VERTEX);
+
+    size_t uniqueCount = 0;
+    for (size_t i = 0; i < vertexCount; ++i) {
+        const uint8_t* vertex = bytes + i * vertexStride;
+        size_t slot = hashBytes(vertex, vertexStride) & tableMask;
+
+        while (true) {
+            const unsigned int candidate = table[slot];
+            if (candidate == UNUSED_VERTEX) {
+                table[slot] = static_cast<unsigned int>(i);
+                remap[i] = static_cast<unsigned int>(uniqueCount++);
+                break;
+            }
+            if (std::memcmp(bytes + candidate * vertexStride, vertex, vertexStride) == 0) {
+                remap[i] = remap[candidate];
+                break;
+            }
+            slot = (slot + 1) & tableMask;
+        }
+    }
+    return uniqueCount;
+}
+
+size_t generateFetchRemap(std::vector<unsigned int>& remap, const std::vector<unsigned int>& indices, size_t vertexCount) {
+    remap.assign(vertexCount, UNUSED_VERTEX);
+
+    unsigned int nextVertex = 0;
+    for (unsigned int index : indices) {
+        if (remap[index] == UNUSED_VERTEX) {
+            remap[index] = nextVertex++;
+        }
+    }
+    return nextVertex;
+}
+
+void remapIndices(std::vector<unsigned int>& indices, const std::vector<unsigned int>& remap) {
+    for (unsigned int& index : indices) {
+        index = remap[index];
+    }
+}
+
+void optimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount) {
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0 || vertexCount == 0) {
+        return;
+    }
+
+    // triangles using each vertex, stored as ranges in one array
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+    for (size_t i = 0; i < triangleCount * 3; ++i) {
+        ++adjacencyOffsets[indices[i] + 1];
+    }
+    for (size_t v = 0; v < vertexCount; ++v) {
+        adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+    }
+    std::vector<uint32_t> adjacency(triangleCount * 3);
+    {
+        std::vector<uint32_t> fillOffsets(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (size_t t = 0; t < triangleCount; ++t) {
+            for (size_t k = 0; k < 3; ++k) {
+                adjacency[fillOffsets[indices[t * 3 + k]]++] = static_cast<uint32_t>(t);
+            }
+        }
+    }
+
+    // the first remainingTriangles entries of each range are the triangles not yet emitted
+    std::vector<uint32_t> remainingTriangles(vertexCount);
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        remainingTriangles[v] = adjacencyOffsets[v + 1] - adjacencyOffsets[v];
+        vertexScore[v] = forsythVertexScore(-1, remainingTriangles[v]);
+    }
+
+    std::vector<float> triangleScore(triangleCount);
+    std::vector<bool> emitted(triangleCount, false);
+    int64_t bestTriangle = 0;
+    for (size_t t = 0; t < triangleCount; ++t) {
+        triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+        if (triangleScore[t] > triangleScore[bestTriangle]) {
+            bestTriangle = static_cast<int64_t>(t);
+        }
+    }
+
+    std::vector<unsigned int> result;
+    result.reserve(triangleCount * 3);
+
+    // 3 extra slots hold the vertices pushed out by the newest triangle
+    std::array<uint32_t, kForsythCacheSize + 3> cache{};
+    std::array<uint32_t, kForsythCacheSize + 3> newCache{};
+    size_t cacheSize = 0;
+    size_t scanCursor = 0;
+
+    auto updateVertexScore = [&](uint32_t vertex) {
+        const float newScore = forsythVertexScore(cachePosition[vertex], remainingTriangles[vertex]);
+        const float delta = newScore - vertexScore[vertex];
+        vertexScore[vertex] = newScore;
+        const uint32_t begin = adjacencyOffsets[vertex];
+        for (uint32_t i = begin; i < begin + remainingTriangles[vertex]; ++i) {
+            triangleScore[adjacency[i]] += delta;
+        }
+    };
+
+    for (size_t emittedCount = 0; emittedCount < triangleCount; ++emittedCount) {
+        if (bestTriangle < 0) {
+            // nothing in the cache touches a remaining triangle, continue with the next one in input order
+            while (emitted[scanCursor]) {
+                ++scanCursor;
+            }
+            bestTriangle = static_cast<int64_t>(scanCursor);
+        }
+
+        const size_t triangle = static_cast<size_t>(bestTriangle);
+        emitted[triangle] = true;
+        const uint32_t triangleVertices[3] = {indices[triangle * 3], indices[triangle * 3 + 1], indices[triangle * 3 + 2]};
+
+        size_t newCacheSize = 0;
+        for (uint32_t vertex : triangleVertices) {
+            result.push_back(vertex);
+
+            // remove the triangle from the vertex's remaining range
+            const uint32_t begin = adjacencyOffsets[vertex];
+            const uint32_t end = begin + remainingTriangles[vertex];
+            for (uint32_t i = begin; i < end; ++i) {
+                if (adjacency[i] == triangle) {
+                    std::swap(adjacency[i], adjacency[end - 1]);
+                    --remainingTriangles[vertex];
+                    break;
+                }
+            }
+
+            if (std::find(newCache.begin(), newCache.begin() + newCacheSize, vertex) == newCache.begin() + newCacheSize) {
+                newCache[newCacheSize++] = vertex;
+            }
+        }
+        for (size_t i = 0; i < cacheSize; ++i) {
+            const uint32_t vertex = cache[i];
+            if (std::find(newCache.begin(), newCache.begin() + newCacheSize, vertex) == newCache.begin() + newCacheSize) {
+                newCache[newCacheSize++] = vertex;
+            }
+        }
+
+        // vertices that fell out of the cache
+        for (size_t i = kForsythCacheSize; i < newCacheSize; ++i) {
+            cachePosition[newCache[i]] = -1;
+            updateVertexScore(newCache[i]);
+        }
+
+        cacheSize = std::min(newCacheSize, kForsythCacheSize);
+        std::copy(newCache.begin(), newCache.begin() + cacheSize, cache.begin());
+        for (size_t i = 0; i < cacheSize; ++i) {
+            cachePosition[cache[i]] = static_cast<int>(i);
+            updateVertexScore(cache[i]);
+        }
+
+        // the next triangle is the best one touching the cache
+        bestTriangle = -1;
+        float bestScore = -std::numeric_limits<float>::max();
+        for (size_t i = 0; i < cacheSize; ++i) {
+            const uint32_t vertex = cache[i];
+            const uint32_t begin = adjacencyOffsets[vertex];
+            for (uint32_t j = begin; j < begin + remainingTriangles[vertex]; ++j) {
+                const uint32_t candidate = adjacency[j];
+                if (triangleScore[candidate] > bestScore) {
+                    bestScore = triangleScore[candidate];
+                    bestTriangle = candidate;
+                }
+            }
+        }
+    }
+
+    std::copy(result.begin(), result.end(), indices.begin());
+}
+
+void optimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<glm::vec3>& positions, float threshold) {
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) {
+        return;
+    }
+
+    // cache misses per triangle in a FIFO cache
+    std::vector<uint32_t> cacheTimestamps(positions.size(), 0);
+    uint32_t timestamp = kOverdrawCacheSize + 1;
+    auto countMisses = [&](size_t triangle) {
+        uint32_t misses = 0;
+        for (size_t k = 0; k < 3; ++k) {
+            const unsigned int vertex = indices[triangle * 3 + k];
+            if (timestamp - cacheTimestamps[vertex] > kOverdrawCacheSize) {
+                cacheTimestamps[vertex] = timestamp++;
+                ++misses;
+            }
+        }
+        return misses;
+    };
+
+    // hard boundaries are where the cache optimizer restarted, every vertex of the triangle missed
+    std::vector<size_t> hardClusters;
+    for (size_t t = 0; t < triangleCount; ++t) {
+        if (countMisses(t) == 3) {
+            hardClusters.push_back(t);
+        }
+    }
+    if (hardClusters.empty() || hardClusters[0] != 0) {
+        hardClusters.insert(hardClusters.begin(), 0);
+    }
+    hardClusters.push_back(triangleCount);
+
+    // soft boundaries split a hard cluster wherever the cache efficiency so far is within the threshold
+    std::vector<size_t> clusters;
+    for (size_t c = 0; c + 1 < hardClusters.size(); ++c) {
+        const size_t begin = hardClusters[c];
+        const size_t end = hardClusters[c + 1];
+
+        std::fill(cacheTimestamps.begin(), cacheTimestamps.end(), 0);
+        timestamp = kOverdrawCacheSize + 1;
+        uint32_t clusterMisses = 0;
+        for (size_t t = begin; t < end; ++t) {
+            clusterMisses += countMisses(t);
+        }
+        const float clusterThreshold = threshold * static_cast<float>(clusterMisses) / static_cast<float>(end - begin);
+
+        std::fill(cacheTimestamps.begin(), cacheTimestamps.end(), 0);
+        timestamp = kOverdrawCacheSize + 1;
+        clusters.push_back(begin);
+        uint32_t runningMisses = 0;
+        size_t runningStart = begin;
+        for (size_t t = begin; t < end; ++t) {
+            runningMisses += countMisses(t);
+            const float runningACMR = static_cast<float>(runningMisses) / static_cast<float>(t + 1 - runningStart);
+            if (t + 1 < end && runningACMR <= clusterThreshold) {
+                clusters.push_back(t + 1);
+                runningStart = t + 1;
+                runningMisses = 0;
+                std::fill(cacheTimestamps.begin(), cacheTimestamps.end(), 0);
+                timestamp = kOverdrawCacheSize + 1;
+            }
+        }
+    }
+    clusters.push_back(triangleCount);
+
+    const size_t clusterCount = clusters.size() - 1;
+
+    // area weighted centroid and normal of the whole mesh and of each cluster
+    glm::vec3 meshCentroid(0.0f);
+    float meshArea = 0.0f;
+    std::vector<glm::vec3> clusterCentroids(clusterCount, glm::vec3(0.0f));
+    std::vector<glm::vec3> clusterNormals(clusterCount, glm::vec3(0.0f));
+    for (size_t c = 0; c < clusterCount; ++c) {
+        float clusterArea = 0.0f;
+        for (size_t t = clusters[c]; t < clusters[c + 1]; ++t) {
+            const glm::vec3& p0 = positions[indices[t * 3]];
+            const glm::vec3& p1 = positions[indices[t * 3 + 1]];
+            const glm::vec3& p2 = positions[indices[t * 3 + 2]];
+            const glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+            const float area = glm::length(normal);
+            const glm::vec3 centroid = (p0 + p1 + p2) * (area / 3.0f);
+
+            clusterCentroids[c] += centroid;
+            clusterNormals[c] += normal;
+            clusterArea += area;
+            meshCentroid += centroid;
+            meshArea += area;
+        }
+        if (clusterArea > 0.0f) {
+            clusterCentroids[c] /= clusterArea;
+        }
+        const float normalLength = glm::length(clusterNormals[c]);
+        if (normalLength > 0.0f) {
+            clusterNormals[c] /= normalLength;
+        }
+    }
+    if (meshArea > 0.0f) {
+        meshCentroid /= meshArea;
+    }
+
+    // clusters facing away from the center are likely in front, draw those first
+    std::vector<float> sortKeys(clusterCount);
+    for (size_t c = 0; c < clusterCount; ++c) {
+        sortKeys[c] = glm::dot(clusterCentroids[c] - meshCentroid, clusterNormals[c]);
+    }
+    std::vector<size_t> clusterOrder(clusterCount);
+    std::iota(clusterOrder.begin(), clusterOrder.end(), 0);
+    std::stable_sort(clusterOrder.begin(), clusterOrder.end(), [&](size_t a, size_t b) {
+        return sortKeys[a] > sortKeys[b];
+    });
+
+    std::vector<unsigned int> result;
+    result.reserve(triangleCount * 3);
+    for (size_t c : clusterOrder) {
+        result.insert(result.end(), indices.begin() + clusters[c] * 3, indices.begin() + clusters[c + 1] * 3);
+    }
+    std::copy(result.begin(), result.end(), indices.begin());
+}
+
+float computeACMR(const std::vector<unsigned int>& indices, size_t vertexCount, size_t cacheSize) {
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) {
+        return 0.0f;
+    }
+
+    std::vector<size_t> cacheTimestamps(vertexCount, 0);
+    size_t timestamp = cacheSize + 1;
+    size_t misses = 0;
+    for (size_t i = 0; i < triangleCount * 3; ++i) {
+        if (timestamp - cacheTimestamps[indices[i]] > cacheSize) {
+            cacheTimestamps[indices[i]] = timestamp++;
+            ++misses;
+        }
+    }
+    return static_cast<float>(misses) / static_cast<float>(triangleCount);
+}
+
+} // namespace clay::mesh_optimizer
@@ -0,0 +1,128 @@
+// standard lib
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+// third party
+#include <glm/geometric.hpp>
+// class
+#include "clay/graphics/common/Meshlet.h"
+
+namespace clay {
+
+MeshletData buildMeshlets(const std::vector<unsigned int>& indices, const std::vector<glm::vec3>& positions, uint32_t maxVertices, uint32_t maxTriangles) {
+    if (maxVertices < 3 || maxVertices > 255 || maxTriangles == 0) {
+        throw std::runtime_error("Invalid meshlet limits");
+    }
+
+    MeshletData data;
+    const size_t triangleCount = indices.size() / 3;
+
+    // local index of each mesh vertex in the current meshlet
+    std::vector<uint8_t> localIndex(positions.size(), 0xFF);
+    Meshlet current{0, 0, 0, 0};
+
+    auto finishMeshlet = [&]() {
+        if (current.triangleCount == 0) {
+            return;
+        }
+        for (uint32_t i = 0; i < current.vertexCount; ++i) {
+            localIndex[data.vertices[current.vertexOffset + i]] = 0xFF;
+        }
+        data.meshlets.push_back(current);
+        current = {
+            static_cast<uint32_t>(data.vertices.size()),
+            current.triangleOffset + current.triangleCount,
+            0,
+            0
+        };
+    };
+
+    for (size_t t = 0; t < triangleCount; ++t) {
+        const unsigned int a = indices[t * 3];
+        const unsigned int b = indices[t * 3 + 1];
+        const unsigned int c = indices[t * 3 + 2];
+
+        uint32_t newVertices = (localIndex[a] == 0xFF) + (localIndex[b] == 0xFF) + (localIndex[c] == 0xFF);
+        // degenerate triangles would count a shared vertex twice
+        if (a == b || a == c) {
+            newVertices -= (localIndex[a] == 0xFF);
+        }
+        if (b == c) {
+            newVertices -= (localIndex[b] == 0xFF);
+        }
+
+        if (current.vertexCount + newVertices > maxVertices || current.triangleCount + 1 > maxTriangles) {
+            finishMeshlet();
+        }
+
+        for (unsigned int vertex : {a, b, c}) {
+            if (localIndex[vertex] == 0xFF) {
+                localIndex[vertex] = static_cast<uint8_t>(current.vertexCount++);
+                data.vertices.push_back(vertex);
+            }
+            data.triangles.push_back(localIndex[vertex]);
+        }
+        ++current.triangleCount;
+    }
+    finishMeshlet();
+
+    data.bounds.reserve(data.meshlets.size());
+    for (const Meshlet& meshlet : data.meshlets) {
+        data.bounds.push_back(computeMeshletBounds(data, meshlet, positions));
+    }
+    return data;
+}
+
+MeshletBounds computeMeshletBounds(const MeshletData& data, const Meshlet& meshlet, const std::vector<glm::vec3>& positions) {
+    MeshletBounds bounds{};
+
+    // sphere around the bounding box center
+    glm::vec3 boundsMin(std::numeric_limits<float>::max());
+    glm::vec3 boundsMax(std::numeric_limits<float>::lowest());
+    for (uint32_t i = 0; i < meshlet.vertexCount; ++i) {
+        const glm::vec3& position = positions[data.vertices[meshlet.vertexOffset + i]];
+        boundsMin = glm::min(boundsMin, position);
+        boundsMax = glm::max(boundsMax, position);
+    }
+    bounds.center = (boundsMin + boundsMax) * 0.5f;
+    for (uint32_t i = 0; i < meshlet.vertexCount; ++i) {
+        const glm::vec3& position = positions[data.vertices[meshlet.vertexOffset + i]];
+        bounds.radius = std::max(bounds.radius, glm::length(position - bounds.center));
+    }
+
+    // normal cone around the average triangle normal
+    std::vector<glm::vec3> normals;
+    normals.reserve(meshlet.triangleCount);
+    glm::vec3 axis(0.0f);
+    for (uint32_t t = 0; t < meshlet.triangleCount; ++t) {
+        const size_t base = (static_cast<size_t>(meshlet.triangleOffset) + t) * 3;
+        const glm::vec3& p0 = positions[data.vertices[meshlet.vertexOffset + data.triangles[base]]];
+        const glm::vec3& p1 = positions[data.vertices[meshlet.vertexOffset + data.triangles[base + 1]]];
+        const glm::vec3& p2 = positions[data.vertices[meshlet.vertexOffset + data.triangles[base + 2]]];
+        const glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+        const float length = glm::length(normal);
+        if (length > 0.0f) {
+            normals.push_back(normal / length);
+            axis += normals.back();
+        }
+    }
+
+    const float axisLength = glm::length(axis);
+    if (normals.empty() || axisLength == 0.0f) {
+        bounds.coneAxis = {0.0f, 0.0f, 1.0f};
+        bounds.coneCutoff = 1.0f;
+        return bounds;
+    }
+    bounds.coneAxis = axis / axisLength;
+
+    float minDot = 1.0f;
+    for (const glm::vec3& normal : normals) {
+        minDot = std::min(minDot, glm::dot(normal, bounds.coneAxis));
+    }
+    // a cone wider than a hemisphere always has a front facing triangle
+    bounds.coneCutoff = minDot <= 0.0f ? 1.0f : std::sqrt(1.0f - minDot * minDot);
+    return bounds;
+}
+
+} // namespace clay
@@ -1,3 +1,6 @@
+// clay
+#include "clay/application/common/Resources.h"
+#include "clay/graphics/common/ClusterCuller.h"
 // class
 #include "clay/graphics/common/Model.h"
 
@@ -28,13 +31,44 @@ void Model::addElement(const ModelElement& element) {
     mModelGroups_.push_back(element);
 }
 
-void Model::render(vk::CommandBuffer cmdBuffer, const void* userPushData, uint32_t userPushSize) {
-    for (auto eachElement: mModelGroups_) {
-        Mesh* pMesh = eachElement.mesh;
+void Model::addSubMeshes(Resources& resources, ResourceHandle<Mesh> mesh, Material* material) {
+    const auto& subMeshes = resources[mesh].getSubMeshes();
+    for (uint32_t i = 0; i < subMeshes.size(); ++i) {
+        mModelGroups_.push_back({mesh, material, subMeshes[i].transform, i});
+    }
+}
+
+void Model::setMaterial(Material* material) {
+    for (auto& eachElement: mModelGroups_) {
+        eachElement.material = material;
+    }
+}
+
+void Model::render(Resources& resources, vk::CommandBuffer cmdBuffer, const void* userPushData, uint32_t userPushSize) {
+    const Mesh* pBoundMesh = nullptr;
+    const Material* pBoundMaterial = nullptr;
+
+    for (const auto& eachElement: mModelGroups_) {
         Material* pMaterial = eachElement.material;
+        if (pMaterial == nullptr || !resources.isReady(eachElement.mesh)) {
+            continue;
+        }
+        Mesh* pMesh = &resources[eachElement.mesh];
+        const std::vector<Mesh::SubMesh>& subMeshes = pMesh->getSubMeshes();
+        if (eachElement.subMeshIndex >= subMeshes.size()) {
+            // the mesh was reloaded with fewer sub-meshes
+            continue;
+        }
 
-        pMaterial->bindMaterial(cmdBuffer);
-        pMesh->bindMesh(cmdBuffer);
+        // sub-meshes share buffers, only rebind when the element changes them
+        if (pMaterial != pBoundMaterial) {
+            pMaterial->bindMaterial(cmdBuffer);
+            pBoundMaterial = pMaterial;
+        }
+        if (pMesh != pBoundMesh) {
+            pMesh->bindMesh(cmdBuffer);
+            pBoundMesh = pMesh;
+        }
 
         // make a copy of instance data
         std::vector<uint8_t> pushDataCopy(userPushSize);
@@ -50,7 +84,26 @@ void Model::render(vk::CommandBuffer cmdBuffer, const void* userPushData, uint32
             vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment
         );
 
-        cmdBuffer.drawIndexed(pMesh->getIndicesCount(), 1, 0, 0, 0);
+        const Mesh::SubMesh& subMesh = subMeshes[eachElement.subMeshIndex];
+        cmdBuffer.drawIndexed(subMesh.indexCount, 1, subMesh.firstIndex, 0, 0);
+    }
+}
+
+void Model::render(Resources& resources, ClusterCuller& culler, vk::CommandBuffer cmdBuffer, const void* userPushData, uint32_t userPushSize) {
+    for (const auto& eachElement: mModelGroups_) {
+        if (eachElement.material == nullptr || !resources.isReady(eachElement.mesh)) {
+            continue;
+        }
+
+        eachElement.material->bindMaterial(cmdBuffer);
+        eachElement.material->pushConstants(
+            cmdBuffer,
+            userPushData,
+            userPushSize,
+            vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment
+        );
+        culler.draw(cmdBuffer);
+        return;
     }
 }
 
@@ -11,7 +11,14 @@ PipelineResource::PipelineResource(const PipelineConfig& config)
       mPipeline_(nullptr),
       mDescriptorSetLayout_(nullptr) {
     createDescriptorSetLayout(config);
-    createPipeline(config);
+    createPipelineLayout(config);
+
+    const auto& shaders = config.pipelineLayoutInfo.shaders;
+    if (shaders.size() == 1 && shaders[0]->getStage() == vk::ShaderStageFlagBits::eCompute) {
+        createComputePipeline(config);
+    } else {
+        createPipeline(config);
+    }
 }
 
 // move constructor
@@ -20,6 +27,7 @@ PipelineResource::PipelineResource(PipelineResource&& other)
     mPipelineLayout_ = other.mPipelineLayout_;
     mPipeline_ = other.mPipeline_;
     mDescriptorSetLayout_ = other.mDescriptorSetLayout_;
+    mBindPoint_ = other.mBindPoint_;
 
     other.mPipelineLayout_ = nullptr;
     other.mPipeline_ = nullptr;
@@ -33,6 +41,7 @@ PipelineResource& PipelineResource::operator=(PipelineResource&& other) noexcept
         mPipelineLayout_ = other.mPipelineLayout_;
         mPipeline_ = other.mPipeline_;
         mDescriptorSetLayout_ = other.mDescriptorSetLayout_;
+        mBindPoint_ = other.mBindPoint_;
 
         other.mPipelineLayout_ = nullptr;
         other.mPipeline_ = nullptr;
@@ -57,6 +66,10 @@ const vk::DescriptorSetLayout& PipelineResource::getDescriptorSetLayout() const
     return mDescriptorSetLayout_;
 }
 
+vk::PipelineBindPoint PipelineResource::getBindPoint() const {
+    return mBindPoint_;
+}
+
 void PipelineResource::createDescriptorSetLayout(const PipelineConfig& config) {
     vk::DescriptorSetLayoutCreateInfo layoutInfo{};
     layoutInfo.bindingCount = static_cast<uint32_t>(config.bindingLayoutInfo.bindings.size());
@@ -65,6 +78,17 @@ void PipelineResource::createDescriptorSetLayout(const PipelineConfig& config) {
     mDescriptorSetLayout_ = mGraphicsContext_.getDevice().createDescriptorSetLayout(layoutInfo);
 }
 
+void PipelineResource::createPipelineLayout(const PipelineConfig& config) {
+    vk::PipelineLayoutCreateInfo pipelineLayoutInfo{
+        .setLayoutCount = 1,
+        .pSetLayouts = &mDescriptorSetLayout_,
+        .pushConstantRangeCount =  static_cast<uint32_t>(config.pipelineLayoutInfo.pushConstants.size()),
+        .pPushConstantRanges = config.pipelineLayoutInfo.pushConstants.data()
+    };
+
+    mPipelineLayout_ = mGraphicsContext_.getDevice().createPipelineLayout(pipelineLayoutInfo);
+}
+
 void PipelineResource::createPipeline(const PipelineConfig& config) {
     vk::PipelineVertexInputStateCreateInfo vertexInputInfo{
         .vertexBindingDescriptionCount = 1,
@@ -90,7 +114,7 @@ void PipelineResource::createPipeline(const PipelineConfig& config) {
 
     vk::PipelineColorBlendAttachmentState colorBlendAttachment{
         .blendEnable = vk::True,
-        .srcColorBlendFactor = vk::BlendFactor::eSrcAlpha,
+        .srcColorBlendFactor = config.pipelineLayoutInfo.premultipliedAlpha ? vk::BlendFactor::eOne : vk::BlendFactor::eSrcAlpha,
         .dstColorBlendFactor = vk::BlendFactor::eOneMinusSrcAlpha,
         .colorBlendOp = vk::BlendOp::eAdd,
         .srcAlphaBlendFactor = vk::BlendFactor::eOne,
@@ -117,15 +141,6 @@ void PipelineResource::createPipeline(const PipelineConfig& config) {
         .pDynamicStates = dynamicStates.data()
     };
 
-    vk::PipelineLayoutCreateInfo pipelineLayoutInfo{
-        .setLayoutCount = 1,
-        .pSetLayouts = &mDescriptorSetLayout_,
-        .pushConstantRangeCount =  static_cast<uint32_t>(config.pipelineLayoutInfo.pushConstants.size()),
-        .pPushConstantRanges = config.pipelineLayoutInfo.pushConstants.data()
-    };
-
-    mPipelineLayout_ = mGraphicsContext_.getDevice().createPipelineLayout(pipelineLayoutInfo);
-
     std::vector<vk::PipelineShaderStageCreateInfo> shaderStages;
 
     for (auto& eachShader: config.pipelineLayoutInfo.shaders) {
@@ -154,6 +169,24 @@ void PipelineResource::createPipeline(const PipelineConfig& config) {
     };
 
     mPipeline_ = mGraphicsContext_.getDevice().createGraphicsPipeline(nullptr, pipelineInfo).value;
+    mBindPoint_ = vk::PipelineBindPoint::eGraphics;
+}
+
+void PipelineResource::createComputePipeline(const PipelineConfig& config) {
+    const ShaderModule* computeShader = config.pipelineLayoutInfo.shaders[0];
+
+    vk::ComputePipelineCreateInfo pipelineInfo{
+        .stage = {
+            .stage = vk::ShaderStageFlagBits::eCompute,
+            .module = computeShader->getShaderModule(),
+            .pName = "main"
+        },
+        .layout = mPipelineLayout_,
+        .basePipelineHandle = nullptr
+    };
+
+    mPipeline_ = mGraphicsContext_.getDevice().createComputePipeline(nullptr, pipelineInfo).value;
+    mBindPoint_ = vk::PipelineBindPoint::eCompute;
 }
 
 void PipelineResource::finalize() {
@@ -0,0 +1,208 @@
+// standard lib
+#include <algorithm>
+#include <cstring>
+// third party
+#include <glm/common.hpp>
+// class
+#include "clay/graphics/common/TextBatcher.h"
+
+namespace clay {
+
+vk::VertexInputBindingDescription TextBatcher::GlyphInstance::getBindingDescription() {
+    return makeBindingDescription<GlyphInstance>(vk::VertexInputRate::eInstance);
+}
+
+std::array<vk::VertexInputAttributeDescription, 5> TextBatcher::GlyphInstance::getAttributeDescriptions() {
+    return makeAttributeDescriptions<GlyphInstance>();
+}
+
+TextBatcher::TextBatcher(BaseGraphicsContext& gContext, ShaderModule& vertShader, ShaderModule& fragShader, UniformBuffer& uniformBuffer)
+    : mGraphicsContext_(gContext),
+      mUniformBuffer_(uniformBuffer) {
+    PipelineResource::PipelineConfig pipelineConfig{
+        .graphicsContext = mGraphicsContext_
+    };
+
+    pipelineConfig.pipelineLayoutInfo.shaders = {
+        &vertShader, &fragShader
+    };
+
+    auto instanceAttrib = GlyphInstance::getAttributeDescriptions();
+    pipelineConfig.pipelineLayoutInfo.attributeDescriptions = {instanceAttrib.begin(), instanceAttrib.end()};
+    pipelineConfig.pipelineLayoutInfo.vertexInputBindingDescription = GlyphInstance::getBindingDescription();
+
+    pipelineConfig.pipelineLayoutInfo.depthStencilState = {
+        .depthTestEnable = vk::True,
+        .depthWriteEnable = vk::True,
+        .depthCompareOp = vk::CompareOp::eLessOrEqual,
+        .depthBoundsTestEnable = vk::False,
+        .stencilTestEnable = vk::False
+    };
+
+    pipelineConfig.pipelineLayoutInfo.rasterizerState = {
+        .depthClampEnable = vk::False,
+        .rasterizerDiscardEnable = vk::False,
+        .polygonMode = vk::PolygonMode::eFill,
+        .cullMode = vk::CullModeFlagBits::eNone,
+        .frontFace = vk::FrontFace::eCounterClockwise,
+        .depthBiasEnable = vk::False,
+        .lineWidth = 1.0f
+    };
+
+    pipelineConfig.bindingLayoutInfo.bindings = {
+        {
+            .binding = 0,
+            .descriptorType = vk::DescriptorType::eUniformBuffer,
+            .descriptorCount = 1,
+            .stageFlags = vk::ShaderStageFlagBits::eVertex,
+            .pImmutableSamplers = nullptr
+        },
+        {
+            .binding = 1,
+            .descriptorType = vk::DescriptorType::eCombinedImageSampler,
+            .descriptorCount = 1,
+            .stageFlags = vk::ShaderStageFlagBits::eFragment,
+            .pImmutableSamplers = nullptr
+        }
+    };
+
+    mPipeline_ = std::make_unique<PipelineResource>(pipelineConfig);
+
+    reserve(kInitialCapacity);
+}
+
+TextBatcher::~TextBatcher() {
+    mBatches_.clear();
+    // frames in flight may still read the instances
+    if (mInstanceBuffer_ != nullptr) {
+        mGraphicsContext_.deferDestroy(
+            [&gContext = mGraphicsContext_, buffer = mInstanceBuffer_, memory = mInstanceMemory_]() {
+                gContext.getDevice().unmapMemory(memory);
+                gContext.getDevice().destroyBuffer(buffer);
+                gContext.freeMemory(memory);
+            }
+        );
+    }
+}
+
+void TextBatcher::add(const Font& font, const std::vector<Font::GlyphQuad>& glyphs, const glm::mat4& modelMatrix, const glm::vec4& color) {
+    if (glyphs.empty()) {
+        return;
+    }
+
+    FontBatch& batch = mBatches_[&font];
+    if (batch.material == nullptr) {
+        Material::MaterialConfig matConfig{
+            .graphicsContext = mGraphicsContext_,
+            .pipelineResource = *mPipeline_
+        };
+        matConfig.bufferBindings = {
+            {
+                .buffer = mUniformBuffer_.mBuffer_,
+                .size = mUniformBuffer_.getSize(),
+                .binding = 0,
+                .descriptorType = vk::DescriptorType::eUniformBuffer
+            }
+        };
+        matConfig.imageBindings = {
+            {
+                .sampler = font.getAtlas().getSampler(),
+                .imageView = font.getAtlas().getImageView(),
+                .binding = 1,
+                .descriptorType = vk::DescriptorType::eCombinedImageSampler
+            }
+        };
+        batch.material = std::make_unique<Material>(matConfig);
+    }
+
+    const glm::vec4 clampedColor = glm::clamp(color, 0.0f, 1.0f) * 255.0f + 0.5f;
+    const glm::u8vec4 packedColor(clampedColor);
+
+    // only the corner moves with the glyph, the edges are the model axes scaled by its size
+    batch.instances.reserve(batch.instances.size() + glyphs.size());
+    for (const Font::GlyphQuad& glyph : glyphs) {
+        batch.instances.push_back({
+            .origin = modelMatrix[3] + modelMatrix[0] * glyph.rect.x + modelMatrix[1] * glyph.rect.y,
+            .axisX = modelMatrix[0] * glyph.rect.z,
+            .axisY = modelMatrix[1] * glyph.rect.w,
+            .uvRect = glyph.uvRect,
+            .color = packedColor
+        });
+    }
+}
+
+void TextBatcher::draw(vk::CommandBuffer cmdBuffer) {
+    const uint64_t frameIndex = mGraphicsContext_.getFrameIndex();
+    if (frameIndex != mLastFrameIndex_) {
+        mLastFrameIndex_ = frameIndex;
+        mFrameUsed_ = 0;
+    }
+
+    uint32_t glyphCount = 0;
+    for (const auto& [font, batch] : mBatches_) {
+        glyphCount += static_cast<uint32_t>(batch.instances.size());
+    }
+    mDrawnGlyphCount_ = glyphCount;
+    if (glyphCount == 0) {
+        return;
+    }
+    reserve(glyphCount);
+
+    // the region of this frame was last read by the frame MAX_FRAMES_IN_FLIGHT ago, whose fence was waited on
+    const uint32_t regionStart = static_cast<uint32_t>(frameIndex % BaseGraphicsContext::MAX_FRAMES_IN_FLIGHT) * mCapacity_;
+    for (auto& [font, batch] : mBatches_) {
+        if (batch.instances.empty()) {
+            continue;
+        }
+        const uint32_t firstInstance = regionStart + mFrameUsed_;
+        const uint32_t instanceCount = static_cast<uint32_t>(batch.instances.size());
+        std::memcpy(mpMapped_ + firstInstance, batch.instances.data(), instanceCount * sizeof(GlyphInstance));
+        mFrameUsed_ += instanceCount;
+        batch.instances.clear();
+
+        batch.material->bindMaterial(cmdBuffer);
+        const vk::DeviceSize offset = 0;
+        cmdBuffer.bindVertexBuffers(0, 1, &mInstanceBuffer_, &offset);
+        cmdBuffer.draw(6, instanceCount, 0, firstInstance);
+    }
+}
+
+uint32_t TextBatcher::getDrawnGlyphCount() const {
+    return mDrawnGlyphCount_;
+}
+
+void TextBatcher::reserve(uint32_t glyphCount) {
+    const uint32_t required = mFrameUsed_ + glyphCount;
+    if (required <= mCapacity_) {
+        return;
+    }
+    uint32_t capacity = std::max(mCapacity_, kInitialCapacity);
+    while (capacity < required) {
+        capacity *= 2;
+    }
+
+    // frames in flight, and draws already recorded this frame, still read the old buffer
+    if (mInstanceBuffer_ != nullptr) {
+        mGraphicsContext_.deferDestroy(
+            [&gContext = mGraphicsContext_, buffer = mInstanceBuffer_, memory = mInstanceMemory_]() {
+                gContext.getDevice().unmapMemory(memory);
+                gContext.getDevice().destroyBuffer(buffer);
+                gContext.freeMemory(memory);
+            }
+        );
+    }
+
+    const vk::DeviceSize size = static_cast<vk::DeviceSize>(capacity) * BaseGraphicsContext::MAX_FRAMES_IN_FLIGHT * sizeof(GlyphInstance);
+    mGraphicsContext_.createBuffer(
+        size,
+        vk::BufferUsageFlagBits::eVertexBuffer,
+        vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+        mInstanceBuffer_,
+        mInstanceMemory_
+    );
+    mpMapped_ = static_cast<GlyphInstance*>(mGraphicsContext_.getDevice().mapMemory(mInstanceMemory_, 0, size));
+    mCapacity_ = capacity;
+    mFrameUsed_ = 0;
+}
+
+} // namespace clay
@@ -1,3 +1,7 @@
+// standard lib
+#include <stdexcept>
+#include <string>
+#include <vector>
 // class
 #include "clay/graphics/common/Texture.h"
 
@@ -12,6 +16,11 @@ Texture::Texture(Texture&& other) noexcept
     mImageMemory_ = other.mImageMemory_;
     mImageView_ = other.mImageView_;
     mSampler_ = other.mSampler_;
+    mMipLevels_ = other.mMipLevels_;
+    mFormat_ = other.mFormat_;
+    mMemorySize_ = other.mMemorySize_;
+    mPremultipliedAlpha_ = other.mPremultipliedAlpha_;
+    mOwnsImage_ = other.mOwnsImage_;
 
     other.mImage_ = nullptr;
     other.mImageMemory_ = nullptr;
@@ -25,6 +34,11 @@ Texture& Texture::operator=(Texture&& other) noexcept {
         mImageMemory_ = other.mImageMemory_;
         mImageView_ = other.mImageView_;
         mSampler_ = other.mSampler_;
+        mMipLevels_ = other.mMipLevels_;
+        mFormat_ = other.mFormat_;
+        mMemorySize_ = other.mMemorySize_;
+        mPremultipliedAlpha_ = other.mPremultipliedAlpha_;
+        mOwnsImage_ = other.mOwnsImage_;
 
         other.mImage_ = nullptr;
         other.mImageMemory_ = nullptr;
@@ -38,11 +52,19 @@ Texture::~Texture() {
     finalize();
 }
 
-void Texture::initialize(utils::ImageData& imageData) {
+void Texture::initialize(utils::ImageData& imageData, bool generateMipmaps) {
+    // the image is always created as R8G8B8A8
+    utils::convertToRGBA(imageData);
+    retireImage();
+    mMipLevels_ = generateMipmaps ? utils::calculateMipLevels(imageData.width, imageData.height) : 1;
+    mFormat_ = vk::Format::eR8G8B8A8Srgb;
+    mPremultipliedAlpha_ = false;
+    mOwnsImage_ = true;
+
     mGraphicsContext_.createImage(
         imageData.width,
         imageData.height,
-        1,
+        mMipLevels_,
         vk::SampleCountFlagBits::e1,
         vk::Format::eR8G8B8A8Srgb,
         vk::ImageTiling::eOptimal,
@@ -52,19 +74,124 @@ void Texture::initialize(utils::ImageData& imageData) {
         mImageMemory_
     );
 
-    mGraphicsContext_.populateImage(mImage_, imageData);
+    // upload, mip generation and the transition to shader read are one submit
+    mGraphicsContext_.uploadImage(mImage_, vk::Format::eR8G8B8A8Srgb, imageData, mMipLevels_);
 
     mImageView_ = mGraphicsContext_.createImageView(
-        mImage_, vk::Format::eR8G8B8A8Srgb, vk::ImageAspectFlagBits::eColor, 1
+        mImage_, vk::Format::eR8G8B8A8Srgb, vk::ImageAspectFlagBits::eColor, mMipLevels_
+    );
+    mMemorySize_ = mGraphicsContext_.getDevice().getImageMemoryRequirements(mImage_).size;
+}
+
+void Texture::initialize(const utils::TextureData& textureData, uint32_t firstLevel) {
+    if (firstLevel >= textureData.levels.size()) {
+        throw std::runtime_error("Texture level " + std::to_string(firstLevel) + " is out of range");
+    }
+    const vk::Format format = static_cast<vk::Format>(textureData.vkFormat);
+    if (!mGraphicsContext_.supportsSampledFormat(format)) {
+        throw std::runtime_error("Texture format " + vk::to_string(format) + " is not supported by this device");
+    }
+
+    const utils::TextureData::Level& baseLevel = textureData.levels[firstLevel];
+    const uint32_t storedLevels = static_cast<uint32_t>(textureData.levels.size()) - firstLevel;
+    // block compressed formats cannot be blitted, those keep their single level
+    const bool blitMipmaps = textureData.generateMipmaps && storedLevels == 1 && mGraphicsContext_.supportsLinearBlit(format);
+    const uint32_t mipLevels = blitMipmaps
+        ? utils::calculateMipLevels(static_cast<int>(baseLevel.width), static_cast<int>(baseLevel.height))
+        : storedLevels;
+    vk::ImageUsageFlags usage = vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled;
+    if (blitMipmaps) {
+        usage |= vk::ImageUsageFlagBits::eTransferSrc;
+    }
+
+    vk::Image image;
+    vk::DeviceMemory imageMemory;
+    mGraphicsContext_.createImage(
+        baseLevel.width,
+        baseLevel.height,
+        mipLevels,
+        vk::SampleCountFlagBits::e1,
+        format,
+        vk::ImageTiling::eOptimal,
+        usage,
+        vk::MemoryPropertyFlagBits::eDeviceLocal,
+        image,
+        imageMemory
+    );
+
+    std::vector<BaseGraphicsContext::ImageLevel> levels;
+    levels.reserve(storedLevels);
+    for (size_t i = firstLevel; i < textureData.levels.size(); ++i) {
+        const utils::TextureData::Level& eachLevel = textureData.levels[i];
+        levels.push_back({
+            textureData.storage.data.get() + eachLevel.offset,
+            eachLevel.size,
+            eachLevel.width,
+            eachLevel.height
+        });
+    }
+    mGraphicsContext_.uploadImageLevels(image, format, levels, mipLevels);
+
+    vk::ImageView imageView = mGraphicsContext_.createImageView(
+        image, format, vk::ImageAspectFlagBits::eColor, mipLevels
     );
 
-    // maybe give Texture an API to transition?
-    mGraphicsContext_.transitionImageLayout(
+    retireImage();
+    mImage_ = image;
+    mImageMemory_ = imageMemory;
+    mImageView_ = imageView;
+    mMipLevels_ = mipLevels;
+    mFormat_ = format;
+    mMemorySize_ = mGraphicsContext_.getDevice().getImageMemoryRequirements(image).size;
+    mPremultipliedAlpha_ = textureData.premultipliedAlpha;
+    mOwnsImage_ = true;
+}
+
+void Texture::retireImage() {
+    if (mImage_ == nullptr) {
+        return;
+    }
+    mGraphicsContext_.deferDestroy(
+        [&gContext = mGraphicsContext_, oldImage = mImage_, oldMemory = mImageMemory_, oldView = mImageView_, ownsImage = mOwnsImage_]() {
+            gContext.getDevice().destroyImageView(oldView);
+            if (ownsImage) {
+                gContext.getDevice().destroyImage(oldImage);
+                gContext.freeMemory(oldMemory);
+            }
+        }
+    );
+    mImage_ = nullptr;
+    mImageMemory_ = nullptr;
+    mImageView_ = nullptr;
+}
+
+void Texture::initializeView(const Texture& source) {
+    finalize();
+    mImage_ = source.mImage_;
+    mImageView_ = mGraphicsContext_.createImageView(
+        source.mImage_, source.mFormat_, vk::ImageAspectFlagBits::eColor, source.mMipLevels_
+    );
+    mSampler_ = source.mSampler_;
+    mMipLevels_ = source.mMipLevels_;
+    mFormat_ = source.mFormat_;
+    mPremultipliedAlpha_ = source.mPremultipliedAlpha_;
+    // the memory is counted by source
+    mMemorySize_ = 0;
+    mOwnsImage_ = false;
+}
+
+void Texture::updateRegion(const void* pixels, uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
+    if (mImage_ == nullptr) {
+        throw std::runtime_error("Texture::updateRegion on an uninitialized texture");
+    }
+    const vk::DeviceSize texelSize = vk::blockSize(mFormat_);
+    if (vk::blockExtent(mFormat_)[0] != 1 || texelSize == 0) {
+        throw std::runtime_error("Texture::updateRegion does not support " + vk::to_string(mFormat_));
+    }
+    mGraphicsContext_.updateImageRegion(
         mImage_,
-        vk::Format::eR8G8B8A8Srgb,
-        vk::ImageLayout::eTransferDstOptimal,
-        vk::ImageLayout::eShaderReadOnlyOptimal,
-        1
+        {pixels, texelSize * width * height, width, height},
+        {static_cast<int32_t>(x), static_cast<int32_t>(y)}
     );
 }
 
@@ -78,15 +205,16 @@ void Texture::finalize() {
         mImageView_ = nullptr;
     }
 
-    if (mImage_ != nullptr) {
+    if (mImage_ != nullptr && mOwnsImage_) {
         mGraphicsContext_.getDevice().destroyImage(mImage_);
-        mImage_ = nullptr;
     }
+    mImage_ = nullptr;
 
     if (mImageMemory_ != nullptr) {
-        mGraphicsContext_.getDevice().freeMemory(mImageMemory_);
+        mGraphicsContext_.freeMemory(mImageMemory_);
         mImageMemory_ = nullptr;
     }
+    mOwnsImage_ = true;
 }
 
 vk::ImageView Texture::getImageView() const {
@@ -97,4 +225,20 @@ vk::Sampler Texture::getSampler() const {
     return mSampler_;
 }
 
+uint32_t Texture::getMipLevels() const {
+    return mMipLevels_;
+}
+
+vk::Format Texture::getFormat() const {
+    return mFormat_;
+}
+
+bool Texture::isPremultipliedAlpha() const {
+    return mPremultipliedAlpha_;
+}
+
+vk::DeviceSize Texture::getMemorySize() const {
+    return mMemorySize_;
+}
+
 } // namespace
\ No newline at end of file
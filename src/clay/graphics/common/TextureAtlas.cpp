@@ -0,0 +1,156 @@
+// standard lib
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+// class
+#include "clay/graphics/common/TextureAtlas.h"
+
+namespace clay {
+
+TextureAtlas::TextureAtlas(BaseGraphicsContext& gContext, const Config& config)
+    : mGraphicsContext_(gContext),
+      mConfig_(config) {}
+
+TextureAtlas::RegionId TextureAtlas::add(utils::ImageData&& image) {
+    if (mBuilt_) {
+        throw std::runtime_error("TextureAtlas: cannot add images after build");
+    }
+    if (image.pixels == nullptr || image.width <= 0 || image.height <= 0) {
+        throw std::runtime_error("TextureAtlas: empty image");
+    }
+    const uint32_t paddedWidth = static_cast<uint32_t>(image.width) + mConfig_.padding * 2;
+    const uint32_t paddedHeight = static_cast<uint32_t>(image.height) + mConfig_.padding * 2;
+    if (paddedWidth > mConfig_.pageSize || paddedHeight > mConfig_.pageSize) {
+        throw std::runtime_error(
+            "TextureAtlas: " + std::to_string(image.width) + "x" + std::to_string(image.height) +
+            " image does not fit in a " + std::to_string(mConfig_.pageSize) + " page"
+        );
+    }
+
+    utils::convertToRGBA(image);
+    mPendingImages_.push_back(std::move(image));
+    return static_cast<RegionId>(mPendingImages_.size() - 1);
+}
+
+void TextureAtlas::build() {
+    if (mBuilt_) {
+        throw std::runtime_error("TextureAtlas: already built");
+    }
+    mBuilt_ = true;
+
+    // tall images first gives the skyline flat shelves to fill
+    std::vector<RegionId> order(mPendingImages_.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this](RegionId a, RegionId b) {
+        const utils::ImageData& imageA = mPendingImages_[a];
+        const utils::ImageData& imageB = mPendingImages_[b];
+        return imageA.height != imageB.height ? imageA.height > imageB.height : imageA.width > imageB.width;
+    });
+
+    std::vector<utils::RectPacker> packers;
+    mRegions_.resize(mPendingImages_.size());
+    const float pageSize = static_cast<float>(mConfig_.pageSize);
+    for (RegionId id : order) {
+        const utils::ImageData& image = mPendingImages_[id];
+        const uint32_t padding = mConfig_.padding;
+        const uint32_t paddedWidth = static_cast<uint32_t>(image.width) + padding * 2;
+        const uint32_t paddedHeight = static_cast<uint32_t>(image.height) + padding * 2;
+
+        std::optional<utils::RectPacker::Rect> rect;
+        uint32_t page = 0;
+        for (; page < packers.size() && !rect.has_value(); ++page) {
+            rect = packers[page].pack(paddedWidth, paddedHeight);
+        }
+        if (!rect.has_value()) {
+            packers.emplace_back(mConfig_.pageSize, mConfig_.pageSize);
+            rect = packers.back().pack(paddedWidth, paddedHeight);
+            page = static_cast<uint32_t>(packers.size());
+        }
+
+        Region& region = mRegions_[id];
+        region.page = page - 1;
+        region.x = rect->x + padding;
+        region.y = rect->y + padding;
+        region.width = static_cast<uint32_t>(image.width);
+        region.height = static_cast<uint32_t>(image.height);
+        region.uvRect = {
+            region.x / pageSize,
+            region.y / pageSize,
+            region.width / pageSize,
+            region.height / pageSize
+        };
+    }
+
+    const size_t pageBytes = static_cast<size_t>(mConfig_.pageSize) * mConfig_.pageSize * 4;
+    std::vector<utils::ImageData> pageImages;
+    pageImages.reserve(packers.size());
+    for (size_t page = 0; page < packers.size(); ++page) {
+        utils::ImageData pageImage{
+            std::make_unique<uint8_t[]>(pageBytes),
+            static_cast<int>(mConfig_.pageSize),
+            static_cast<int>(mConfig_.pageSize),
+            4
+        };
+        std::memset(pageImage.pixels.get(), 0, pageBytes);
+        pageImages.push_back(std::move(pageImage));
+    }
+    for (RegionId id = 0; id < mRegions_.size(); ++id) {
+        blit(mPendingImages_[id], mRegions_[id], pageImages[mRegions_[id].page].pixels.get());
+    }
+    mPendingImages_.clear();
+    mPendingImages_.shrink_to_fit();
+
+    mPages_.reserve(pageImages.size());
+    mOccupancy_.reserve(pageImages.size());
+    for (size_t page = 0; page < pageImages.size(); ++page) {
+        mPages_.emplace_back(mGraphicsContext_);
+        mPages_.back().initialize(pageImages[page], mConfig_.generateMipmaps);
+        mOccupancy_.push_back(0.0f);
+    }
+    for (const Region& region : mRegions_) {
+        mOccupancy_[region.page] += static_cast<float>(region.width) * region.height / (pageSize * pageSize);
+    }
+}
+
+const TextureAtlas::Region& TextureAtlas::getRegion(RegionId id) const {
+    if (!mBuilt_) {
+        throw std::runtime_error("TextureAtlas: regions are assigned by build");
+    }
+    return mRegions_.at(id);
+}
+
+uint32_t TextureAtlas::getPageCount() const {
+    return static_cast<uint32_t>(mPages_.size());
+}
+
+Texture& TextureAtlas::getPage(uint32_t page) {
+    return mPages_.at(page);
+}
+
+float TextureAtlas::getOccupancy(uint32_t page) const {
+    return mOccupancy_.at(page);
+}
+
+void TextureAtlas::blit(const utils::ImageData& image, const Region& region, uint8_t* pagePixels) const {
+    const int padding = static_cast<int>(mConfig_.padding);
+    const size_t pageStride = static_cast<size_t>(mConfig_.pageSize) * 4;
+
+    // rows and columns past the edges repeat the edge pixels
+    for (int y = -padding; y < image.height + padding; ++y) {
+        const int sourceY = std::clamp(y, 0, image.height - 1);
+        const uint8_t* sourceRow = image.pixels.get() + static_cast<size_t>(sourceY) * image.width * 4;
+        uint8_t* destinationRow = pagePixels + static_cast<size_t>(static_cast<int>(region.y) + y) * pageStride + static_cast<size_t>(region.x) * 4;
+
+        for (int x = -padding; x < 0; ++x) {
+            std::memcpy(destinationRow + x * 4, sourceRow, 4);
+        }
+        std::memcpy(destinationRow, sourceRow, static_cast<size_t>(image.width) * 4);
+        for (int x = image.width; x < image.width + padding; ++x) {
+            std::memcpy(destinationRow + x * 4, sourceRow + (image.width - 1) * 4, 4);
+        }
+    }
+}
+
+} // namespace clay
@@ -0,0 +1,225 @@
+// standard lib
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+// third party
+#include <glm/geometric.hpp>
+// class
+#include "clay/graphics/common/TextureStreamer.h"
+
+namespace clay {
+
+TextureStreamer::TextureStreamer(BaseGraphicsContext& gContext, const Config& config)
+    : mGraphicsContext_(gContext),
+      mConfig_(config) {}
+
+TextureStreamer::StreamId TextureStreamer::registerTexture(Texture& texture, utils::TextureData&& source) {
+    if (source.levels.empty()) {
+        throw std::runtime_error("TextureStreamer: texture has no levels");
+    }
+
+    StreamId id;
+    if (!mFreeIds_.empty()) {
+        id = mFreeIds_.back();
+        mFreeIds_.pop_back();
+    } else {
+        id = static_cast<StreamId>(mEntries_.size());
+        mEntries_.emplace_back();
+    }
+
+    Entry& entry = mEntries_[id];
+    entry = Entry{};
+    entry.texture = &texture;
+    entry.source = std::move(source);
+    entry.active = true;
+
+    // first level that fits the tail size, the smallest level if none do
+    entry.tailLevel = static_cast<uint32_t>(entry.source.levels.size()) - 1;
+    for (uint32_t level = 0; level < entry.source.levels.size(); ++level) {
+        const auto& eachLevel = entry.source.levels[level];
+        if (std::max(eachLevel.width, eachLevel.height) <= mConfig_.tailSize) {
+            entry.tailLevel = level;
+            break;
+        }
+    }
+
+    entry.residentLevel = entry.tailLevel;
+    texture.initialize(entry.source, entry.tailLevel);
+    mResidentBytes_ += texture.getMemorySize();
+    return id;
+}
+
+void TextureStreamer::unregisterTexture(StreamId id) {
+    Entry& entry = getEntry(id);
+    mResidentBytes_ -= entry.texture->getMemorySize();
+    entry = Entry{};
+    mFreeIds_.push_back(id);
+}
+
+void TextureStreamer::addMaterial(StreamId id, Material& material) {
+    getEntry(id).materials.push_back(&material);
+}
+
+void TextureStreamer::reportUsage(StreamId id, float screenPixels) {
+    Entry& entry = getEntry(id);
+    const uint64_t frameIndex = mGraphicsContext_.getFrameIndex();
+    if (entry.lastUsedFrame != frameIndex) {
+        entry.screenPixels = 0.0f;
+        entry.lastUsedFrame = frameIndex;
+    }
+    entry.screenPixels = std::max(entry.screenPixels, screenPixels);
+}
+
+void TextureStreamer::reportUsage(StreamId id, const glm::mat4& model) {
+    // the largest axis of the model matrix is the object's size in view space
+    const float size = std::max({glm::length(model[0]), glm::length(model[1]), glm::length(model[2])});
+    // y may be flipped for vulkan
+    const float pixelsPerUnit = std::abs(mProjection_[1][1]) * 0.5f * mViewportHeight_;
+    if (mProjection_[3][3] == 1.0f) {
+        // orthographic, the footprint does not depend on distance
+        reportUsage(id, size * pixelsPerUnit);
+        return;
+    }
+    const float depth = -(mView_ * model[3]).z;
+    if (depth <= 0.0f) {
+        return;
+    }
+    reportUsage(id, size * pixelsPerUnit / depth);
+}
+
+void TextureStreamer::setView(const glm::mat4& view, const glm::mat4& projection, float viewportHeight) {
+    mView_ = view;
+    mProjection_ = projection;
+    mViewportHeight_ = viewportHeight;
+}
+
+void TextureStreamer::update() {
+    // replaced images queued before this are freed by now, matches BaseGraphicsContext::advanceFrame
+    const uint64_t frameIndex = mGraphicsContext_.getFrameIndex();
+    std::erase_if(mPendingFrees_, [this, frameIndex](const PendingFree& pending) {
+        if (pending.frameIndex + BaseGraphicsContext::MAX_FRAMES_IN_FLIGHT > frameIndex) {
+            return false;
+        }
+        mPendingBytes_ -= pending.bytes;
+        return true;
+    });
+
+    std::vector<StreamId> order;
+    std::vector<uint32_t> targetLevel(mEntries_.size(), 0);
+    vk::DeviceSize plannedBytes = 0;
+
+    for (StreamId id = 0; id < mEntries_.size(); ++id) {
+        const Entry& entry = mEntries_[id];
+        if (!entry.active) {
+            continue;
+        }
+        targetLevel[id] = wantedLevel(entry);
+        plannedBytes += levelBytes(entry, targetLevel[id]);
+        order.push_back(id);
+    }
+
+    // least recently used and smallest on screen give up their largest mips first
+    std::sort(order.begin(), order.end(), [this](StreamId a, StreamId b) {
+        const Entry& entryA = mEntries_[a];
+        const Entry& entryB = mEntries_[b];
+        if (entryA.lastUsedFrame != entryB.lastUsedFrame) {
+            return entryA.lastUsedFrame < entryB.lastUsedFrame;
+        }
+        return entryA.screenPixels < entryB.screenPixels;
+    });
+    for (StreamId id : order) {
+        const Entry& entry = mEntries_[id];
+        while (plannedBytes > mConfig_.budgetBytes && targetLevel[id] < entry.tailLevel) {
+            plannedBytes -= levelBytes(entry, targetLevel[id]) - levelBytes(entry, targetLevel[id] + 1);
+            ++targetLevel[id];
+        }
+    }
+
+    // evicted images are released through deferDestroy, so their bytes stay pending for MAX_FRAMES_IN_FLIGHT
+    // frames. Upgrades then go to the most important textures while the new image fits next to all of that
+    for (StreamId id : order) {
+        if (targetLevel[id] > mEntries_[id].residentLevel) {
+            makeResident(mEntries_[id], targetLevel[id]);
+        }
+    }
+    uint32_t uploads = 0;
+    for (auto it = order.rbegin(); it != order.rend() && uploads < mConfig_.maxUploadsPerFrame; ++it) {
+        const Entry& entry = mEntries_[*it];
+        if (targetLevel[*it] >= entry.residentLevel) {
+            continue;
+        }
+        if (mResidentBytes_ + mPendingBytes_ + levelBytes(entry, targetLevel[*it]) > mConfig_.budgetBytes) {
+            // retried once earlier replacements are freed
+            continue;
+        }
+        makeResident(mEntries_[*it], targetLevel[*it]);
+        ++uploads;
+    }
+}
+
+uint32_t TextureStreamer::getResidentLevel(StreamId id) const {
+    return getEntry(id).residentLevel;
+}
+
+vk::DeviceSize TextureStreamer::getResidentBytes() const {
+    return mResidentBytes_;
+}
+
+vk::DeviceSize TextureStreamer::getBudget() const {
+    return mConfig_.budgetBytes;
+}
+
+void TextureStreamer::setBudget(vk::DeviceSize budgetBytes) {
+    mConfig_.budgetBytes = budgetBytes;
+}
+
+TextureStreamer::Entry& TextureStreamer::getEntry(StreamId id) {
+    if (id >= mEntries_.size() || !mEntries_[id].active) {
+        throw std::runtime_error("TextureStreamer: invalid stream id");
+    }
+    return mEntries_[id];
+}
+
+const TextureStreamer::Entry& TextureStreamer::getEntry(StreamId id) const {
+    if (id >= mEntries_.size() || !mEntries_[id].active) {
+        throw std::runtime_error("TextureStreamer: invalid stream id");
+    }
+    return mEntries_[id];
+}
+
+vk::DeviceSize TextureStreamer::levelBytes(const Entry& entry, uint32_t firstLevel) {
+    vk::DeviceSize bytes = 0;
+    for (size_t level = firstLevel; level < entry.source.levels.size(); ++level) {
+        bytes += entry.source.levels[level].size;
+    }
+    return bytes;
+}
+
+uint32_t TextureStreamer::wantedLevel(const Entry& entry) const {
+    const uint64_t frameIndex = mGraphicsContext_.getFrameIndex();
+    if (entry.screenPixels <= 0.0f || frameIndex - entry.lastUsedFrame > mConfig_.idleFrames) {
+        return entry.tailLevel;
+    }
+
+    // the level with about one texel per covered pixel
+    const uint32_t size = std::max(entry.source.width, entry.source.height);
+    const float level = std::floor(std::log2(static_cast<float>(size) / entry.screenPixels));
+    return std::min(static_cast<uint32_t>(std::max(level, 0.0f)), entry.tailLevel);
+}
+
+void TextureStreamer::makeResident(Entry& entry, uint32_t firstLevel) {
+    const vk::ImageView oldView = entry.texture->getImageView();
+    const vk::DeviceSize oldBytes = entry.texture->getMemorySize();
+
+    entry.texture->initialize(entry.source, firstLevel);
+    entry.residentLevel = firstLevel;
+    mResidentBytes_ = mResidentBytes_ - oldBytes + entry.texture->getMemorySize();
+    mPendingFrees_.push_back({mGraphicsContext_.getFrameIndex(), oldBytes});
+    mPendingBytes_ += oldBytes;
+
+    for (Material* material : entry.materials) {
+        material->replaceImageView(oldView, entry.texture->getImageView());
+    }
+}
+
+} // namespace clay
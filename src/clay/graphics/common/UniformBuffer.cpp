@@ -26,7 +26,7 @@ UniformBuffer::UniformBuffer(BaseGraphicsContext& graphicsContext, vk::DeviceSiz
         )
     };
 
-    mBufferMemory_ = mGraphicsContext_.getDevice().allocateMemory(allocInfo);
+    mBufferMemory_ = mGraphicsContext_.allocateMemory(allocInfo);
 
    mGraphicsContext_.getDevice().bindBufferMemory(mBuffer_, mBufferMemory_, 0);
 
@@ -91,7 +91,7 @@ void UniformBuffer::finalize() {
         mBuffer_ = nullptr;
     }
     if (mBufferMemory_ != nullptr) {
-        mGraphicsContext_.getDevice().freeMemory(mBufferMemory_);
+        mGraphicsContext_.freeMemory(mBufferMemory_);
         mBufferMemory_ = nullptr;
     }
 }
@@ -1,6 +1,7 @@
 #ifdef CLAY_PLATFORM_DESKTOP
 
 // standard lib
+#include <cstring>
 #include <iostream>
 #include <set>
 #include <algorithm>
@@ -173,14 +174,31 @@ void GraphicsContextDesktop::createLogicalDevice() {
         queueCreateInfos.push_back(queueCreateInfo);
     }
 
+    const vk::PhysicalDeviceFeatures supportedFeatures = mPhysicalDevice_.getFeatures();
+
     vk::PhysicalDeviceFeatures deviceFeatures{};
     deviceFeatures.samplerAnisotropy = vk::True;
+    deviceFeatures.multiDrawIndirect = supportedFeatures.multiDrawIndirect;
+    deviceFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC;
+    mEnabledFeatures_ = deviceFeatures;
+
+    std::vector<const char*> enabledExtensions = deviceExtensions;
+    bool memoryBudget = false;
+    if (isInstanceExtensionAvailable(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME)) {
+        for (const vk::ExtensionProperties& extension : mPhysicalDevice_.enumerateDeviceExtensionProperties()) {
+            if (std::strcmp(extension.extensionName, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME) == 0) {
+                enabledExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+                memoryBudget = true;
+                break;
+            }
+        }
+    }
 
     vk::DeviceCreateInfo createInfo{
         .queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size()),
         .pQueueCreateInfos = queueCreateInfos.data(),
-        .enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size()),
-        .ppEnabledExtensionNames = deviceExtensions.data(),
+        .enabledExtensionCount = static_cast<uint32_t>(enabledExtensions.size()),
+        .ppEnabledExtensionNames = enabledExtensions.data(),
         .pEnabledFeatures = &deviceFeatures,
     };
 
@@ -192,6 +210,9 @@ void GraphicsContextDesktop::createLogicalDevice() {
     }
 
     mDevice_ = mPhysicalDevice_.createDevice(createInfo);
+    if (memoryBudget) {
+        enableMemoryBudget();
+    }
 
     mGraphicsQueue_ = mDevice_.getQueue(indices.graphicsFamily.value(), 0);
     mPresentQueue_  = mDevice_.getQueue(indices.presentFamily.value(), 0);
@@ -280,6 +301,10 @@ std::vector<const char*> GraphicsContextDesktop::getRequiredExtensions() {
     if (enableValidationLayers) {
         extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
     }
+    // needed by VK_EXT_memory_budget on a 1.0 instance
+    if (isInstanceExtensionAvailable(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME)) {
+        extensions.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+    }
 
     return extensions;
 }
@@ -364,117 +389,6 @@ void GraphicsContextDesktop::createDescriptorPool() {
     mDescriptorPool_ = mDevice_.createDescriptorPool(poolInfo);
 }
 
-void GraphicsContextDesktop::generateMipmaps(vk::Image image, vk::Format imageFormat, int32_t texWidth, int32_t texHeight, uint32_t mipLevels) {
-    // Check if image format supports linear blitting
-    vk::FormatProperties formatProperties = mPhysicalDevice_.getFormatProperties(imageFormat);
-
-    if (!(formatProperties.optimalTilingFeatures & vk::FormatFeatureFlagBits::eSampledImageFilterLinear)) {
-        throw std::runtime_error("texture image format does not support linear blitting!");
-    }
-
-    vk::CommandBuffer commandBuffer = beginSingleTimeCommands();
-
-    vk::ImageMemoryBarrier barrier{
-        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-        .image = image,
-        .subresourceRange = {
-            .aspectMask =  vk::ImageAspectFlagBits::eColor,
-            .levelCount = 1,
-            .baseArrayLayer = 0,
-            .layerCount = 1,
-        }
-    };
-
-    int32_t mipWidth = texWidth;
-    int32_t mipHeight = texHeight;
-
-    for (uint32_t i = 1; i < mipLevels; i++) {
-        barrier.subresourceRange.baseMipLevel = i - 1;
-        barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
-        barrier.newLayout = vk::ImageLayout::eTransferSrcOptimal;
-        barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
-        barrier.dstAccessMask = vk::AccessFlagBits::eTransferRead;
-
-        commandBuffer.pipelineBarrier(
-            vk::PipelineStageFlagBits::eTransfer,
-            vk::PipelineStageFlagBits::eTransfer,
-            {},
-            nullptr,
-            nullptr,
-            barrier
-        );
-
-        vk::ImageBlit blit{
-            .srcSubresource = {
-                .aspectMask = vk::ImageAspectFlagBits::eColor,
-                .mipLevel = i - 1,
-                .baseArrayLayer = 0,
-                .layerCount = 1
-            },
-            .srcOffsets = vk::ArrayWrapper1D<vk::Offset3D, 2>{
-                std::array<vk::Offset3D, 2>{{
-                    {0, 0, 0},
-                    {mipWidth, mipHeight, 1}
-                }}
-            },
-            .dstSubresource = {
-                .aspectMask = vk::ImageAspectFlagBits::eColor,
-                .mipLevel = i,
-                .baseArrayLayer = 0,
-                .layerCount = 1
-            },
-            .dstOffsets = vk::ArrayWrapper1D<vk::Offset3D, 2>{
-                std::array<vk::Offset3D, 2>{{
-                    {0, 0, 0},
-                    {mipWidth > 1 ? mipWidth / 2 : 1, mipHeight > 1 ? mipHeight / 2 : 1, 1}
-                }}
-            },
-        };
-
-        commandBuffer.blitImage(
-            image, vk::ImageLayout::eTransferSrcOptimal,
-            image, vk::ImageLayout::eTransferDstOptimal,
-            { blit },
-            vk::Filter::eLinear
-        );
-
-        barrier.oldLayout = vk::ImageLayout::eTransferSrcOptimal,
-        barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
-        barrier.srcAccessMask = vk::AccessFlagBits::eTransferRead;
-        barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
-
-        commandBuffer.pipelineBarrier(
-            vk::PipelineStageFlagBits::eTransfer,
-            vk::PipelineStageFlagBits::eFragmentShader,
-            {},
-            nullptr,
-            nullptr,
-            barrier
-        );
-
-        if (mipWidth > 1) mipWidth /= 2;
-        if (mipHeight > 1) mipHeight /= 2;
-    }
-
-    barrier.subresourceRange.baseMipLevel = mipLevels - 1;
-    barrier.oldLayout = vk::ImageLayout::eTransferSrcOptimal;
-    barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
-    barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
-    barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
-
-    commandBuffer.pipelineBarrier(
-        vk::PipelineStageFlagBits::eTransfer,
-        vk::PipelineStageFlagBits::eFragmentShader,
-        {},
-        nullptr,
-        nullptr,
-        barrier
-    );
-
-    endSingleTimeCommands(commandBuffer);
-}
-
 vk::Format GraphicsContextDesktop::findSupportedFormat(const std::vector<vk::Format>& candidates, vk::ImageTiling tiling, vk::FormatFeatureFlags features) {
     for (vk::Format format : candidates) {
         vk::FormatProperties props = mPhysicalDevice_.getFormatProperties(format);
@@ -742,11 +656,11 @@ void GraphicsContextDesktop::recreateSwapChain(Window& window) {
 void GraphicsContextDesktop::cleanupSwapChain() {
     mDevice_.destroyImageView(mDepthImageView_);
     mDevice_.destroyImage(mDepthImage_);
-    mDevice_.freeMemory(mDepthImageMemory_);
+    freeMemory(mDepthImageMemory_);
 
     mDevice_.destroyImageView(mColorImageView_);
     mDevice_.destroyImage(mColorImage_);
-    mDevice_.freeMemory(mColorImageMemory_);
+    freeMemory(mColorImageMemory_);
 
     for (const auto& framebuffer : mSwapChainFramebuffers_) {
         mDevice_.destroyFramebuffer(framebuffer);
@@ -828,6 +742,7 @@ void GraphicsContextDesktop::createSyncObjects() {
 }
 
 void GraphicsContextDesktop::cleanUp() {
+    flushDeferredDestroys();
     cleanupSwapChain();
     mCameraUniform_.reset();
     mCameraUniformHeadLocked_.reset();
@@ -294,8 +294,17 @@ GraphicsContextXR::GraphicsContextXR() {
         }
     }
 
-    VkPhysicalDeviceFeatures features;
-    vkGetPhysicalDeviceFeatures(mPhysicalDevice_, &features);
+    VkPhysicalDeviceFeatures supportedFeatures;
+    vkGetPhysicalDeviceFeatures(mPhysicalDevice_, &supportedFeatures);
+
+    // only what the engine uses, recorded so feature checks see what the device was created with
+    VkPhysicalDeviceFeatures features{};
+    features.samplerAnisotropy = supportedFeatures.samplerAnisotropy;
+    features.multiDrawIndirect = supportedFeatures.multiDrawIndirect;
+    features.textureCompressionBC = supportedFeatures.textureCompressionBC;
+    features.textureCompressionASTC_LDR = supportedFeatures.textureCompressionASTC_LDR;
+    features.textureCompressionETC2 = supportedFeatures.textureCompressionETC2;
+    mEnabledFeatures_ = features;
 
     VkDeviceCreateInfo deviceCI{};
     deviceCI.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -435,6 +444,10 @@ GraphicsContextXR::GraphicsContextXR(XrInstance m_xrInstance, XrSystemId systemI
     }
 
     activeInstanceExtensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+    // needed by VK_EXT_memory_budget when the runtime asks for a 1.0 instance
+    if (isInstanceExtensionAvailable(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME)) {
+        activeInstanceExtensions.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+    }
 
     if (enableValidation) {
         activeInstanceLayers = {"VK_LAYER_KHRONOS_validation"};
@@ -562,9 +575,29 @@ GraphicsContextXR::GraphicsContextXR(XrInstance m_xrInstance, XrSystemId systemI
             break;
         }
     }
+    // heap budgets let Resources stay under the platform memory ceiling
+    bool memoryBudget = false;
+    if (isInstanceExtensionAvailable(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME)) {
+        for (const VkExtensionProperties &extensionProperty : deviceExtensionProperties) {
+            if (strcmp(extensionProperty.extensionName, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME) == 0) {
+                activeDeviceExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+                memoryBudget = true;
+                break;
+            }
+        }
+    }
+
+    VkPhysicalDeviceFeatures supportedFeatures;
+    vkGetPhysicalDeviceFeatures(mPhysicalDevice_, &supportedFeatures);
 
-    VkPhysicalDeviceFeatures features;
-    vkGetPhysicalDeviceFeatures(mPhysicalDevice_, &features);
+    // only what the engine uses, recorded so feature checks see what the device was created with
+    VkPhysicalDeviceFeatures features{};
+    features.samplerAnisotropy = supportedFeatures.samplerAnisotropy;
+    features.multiDrawIndirect = supportedFeatures.multiDrawIndirect;
+    features.textureCompressionBC = supportedFeatures.textureCompressionBC;
+    features.textureCompressionASTC_LDR = supportedFeatures.textureCompressionASTC_LDR;
+    features.textureCompressionETC2 = supportedFeatures.textureCompressionETC2;
+    mEnabledFeatures_ = features;
 
     VkDeviceCreateInfo deviceCI;
     deviceCI.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -581,6 +614,9 @@ GraphicsContextXR::GraphicsContextXR(XrInstance m_xrInstance, XrSystemId systemI
         vkCreateDevice(mPhysicalDevice_, &deviceCI, nullptr, &mDevice_),
         "Failed to create Device."
     )
+    if (memoryBudget) {
+        enableMemoryBudget();
+    }
 
     VkCommandPoolCreateInfo cmdPoolCI;
     cmdPoolCI.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
@@ -751,6 +787,8 @@ void GraphicsContextXR::CreateRenderPass(const std::vector<int64_t>& colorFormat
 
 
 GraphicsContextXR::~GraphicsContextXR() {
+    flushDeferredDestroys();
+
     vkDestroyDescriptorPool(mDevice_, mDescriptorPool_, nullptr);
 
     vkDestroyFence(mDevice_, fence, nullptr);
@@ -813,6 +851,7 @@ void GraphicsContextXR::BeginRendering() {
         "Failed to wait for Fence"
     )
     VULKAN_CHECK(vkResetFences(mDevice_, 1, &fence), "Failed to reset Fence.")
+    advanceFrame();
 
     for (const auto& descSet : cmdBufferDescriptorSets[cmdBuffer]) {
         VULKAN_CHECK(
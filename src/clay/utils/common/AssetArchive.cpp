@@ -0,0 +1,174 @@
+// standard lib
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+// clay
+#include "clay/utils/common/Lz4.h"
+// class
+#include "clay/utils/common/AssetArchive.h"
+
+namespace clay::utils {
+
+namespace {
+
+static_assert(sizeof(AssetArchiveHeader) == 16, "AssetArchiveHeader layout is part of the file format");
+static_assert(sizeof(AssetArchiveEntry) == 40, "AssetArchiveEntry layout is part of the file format");
+
+std::size_t alignUp(std::size_t value, std::size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// context is a heap allocated owner of the archive bytes
+void releaseArchiveView(uint8_t*, std::size_t, void* context) {
+    delete static_cast<std::shared_ptr<const FileData>*>(context);
+}
+
+} // namespace
+
+AssetArchive::AssetArchive(FileData&& archive)
+    : mArchive_(std::make_shared<const FileData>(std::move(archive))) {
+    AssetArchiveHeader header;
+    if (mArchive_->size < sizeof(header)) {
+        throw std::runtime_error("Not an asset archive");
+    }
+    std::memcpy(&header, mArchive_->data.get(), sizeof(header));
+    if (header.magic != ASSET_ARCHIVE_MAGIC) {
+        throw std::runtime_error("Not an asset archive");
+    }
+    if (header.version != ASSET_ARCHIVE_VERSION) {
+        throw std::runtime_error(
+            "Asset archive version " + std::to_string(header.version) +
+            " does not match " + std::to_string(ASSET_ARCHIVE_VERSION) + ", re-run the asset packer"
+        );
+    }
+    const std::size_t indexEnd = sizeof(header) + static_cast<std::size_t>(header.entryCount) * sizeof(AssetArchiveEntry);
+    if (indexEnd > mArchive_->size) {
+        throw std::runtime_error("Asset archive: truncated index");
+    }
+
+    mEntries_.resize(header.entryCount);
+    std::memcpy(mEntries_.data(), mArchive_->data.get() + sizeof(header), mEntries_.size() * sizeof(AssetArchiveEntry));
+    for (std::size_t i = 0; i < mEntries_.size(); ++i) {
+        const AssetArchiveEntry& entry = mEntries_[i];
+        if (entry.offset > mArchive_->size || entry.storedSize > mArchive_->size - entry.offset) {
+            throw std::runtime_error("Asset archive: entry " + std::to_string(i) + " is out of bounds");
+        }
+        if (entry.compression != AssetCompression::NONE && entry.compression != AssetCompression::LZ4) {
+            throw std::runtime_error("Asset archive: entry " + std::to_string(i) + " has an unknown compression");
+        }
+        if (i > 0 && mEntries_[i - 1].pathHash >= entry.pathHash) {
+            throw std::runtime_error("Asset archive: index is not sorted");
+        }
+    }
+}
+
+uint64_t AssetArchive::hashPath(std::string_view path) {
+    std::string normalized(path);
+    std::replace(normalized.begin(), normalized.end(), '\\', '/');
+    return hashString(normalized);
+}
+
+bool AssetArchive::contains(std::string_view path) const {
+    return find(hashPath(path)) != nullptr;
+}
+
+FileData AssetArchive::load(std::string_view path) const {
+    const AssetArchiveEntry* entry = find(hashPath(path));
+    if (entry == nullptr) {
+        throw std::runtime_error("Asset archive has no entry for " + std::string(path));
+    }
+
+    uint8_t* stored = mArchive_->data.get() + entry->offset;
+    if (entry->compression == AssetCompression::NONE) {
+        return {
+            {stored, FileDataDeleter(releaseArchiveView, 0, new std::shared_ptr<const FileData>(mArchive_))},
+            static_cast<std::size_t>(entry->storedSize)
+        };
+    }
+
+    auto buffer = std::make_unique<uint8_t[]>(entry->size);
+    decompressLz4Block(stored, entry->storedSize, buffer.get(), entry->size);
+    return {std::move(buffer), static_cast<std::size_t>(entry->size)};
+}
+
+uint32_t AssetArchive::getEntryCount() const {
+    return static_cast<uint32_t>(mEntries_.size());
+}
+
+const AssetArchiveEntry* AssetArchive::find(uint64_t pathHash) const {
+    auto it = std::lower_bound(mEntries_.begin(), mEntries_.end(), pathHash, [](const AssetArchiveEntry& entry, uint64_t hash) {
+        return entry.pathHash < hash;
+    });
+    return it != mEntries_.end() && it->pathHash == pathHash ? &*it : nullptr;
+}
+
+std::vector<uint8_t> writeAssetArchive(const std::vector<AssetArchiveInput>& inputs) {
+    struct PackedInput {
+        AssetArchiveEntry entry;
+        std::vector<uint8_t> compressed; // empty when stored raw
+        const AssetArchiveInput* input;
+    };
+
+    std::vector<PackedInput> packed;
+    packed.reserve(inputs.size());
+    for (const AssetArchiveInput& input : inputs) {
+        PackedInput each{
+            .entry = {
+                .pathHash = AssetArchive::hashPath(input.path),
+                .offset = 0,
+                .storedSize = input.data.size(),
+                .size = input.data.size(),
+                .compression = AssetCompression::NONE,
+                .reserved = 0
+            },
+            .compressed = {},
+            .input = &input
+        };
+        if (input.compress && !input.data.empty()) {
+            std::vector<uint8_t> compressed = compressLz4Block(input.data.data(), input.data.size());
+            if (compressed.size() < input.data.size()) {
+                each.entry.storedSize = compressed.size();
+                each.entry.compression = AssetCompression::LZ4;
+                each.compressed = std::move(compressed);
+            }
+        }
+        packed.push_back(std::move(each));
+    }
+
+    std::sort(packed.begin(), packed.end(), [](const PackedInput& a, const PackedInput& b) {
+        return a.entry.pathHash < b.entry.pathHash;
+    });
+    for (std::size_t i = 1; i < packed.size(); ++i) {
+        if (packed[i - 1].entry.pathHash == packed[i].entry.pathHash) {
+            throw std::runtime_error(
+                "Asset archive: " + packed[i - 1].input->path + " and " + packed[i].input->path + " have the same path hash"
+            );
+        }
+    }
+
+    std::size_t offset = sizeof(AssetArchiveHeader) + packed.size() * sizeof(AssetArchiveEntry);
+    for (PackedInput& each : packed) {
+        offset = alignUp(offset, ASSET_ARCHIVE_ALIGNMENT);
+        each.entry.offset = offset;
+        offset += each.entry.storedSize;
+    }
+
+    const AssetArchiveHeader header{
+        .magic = ASSET_ARCHIVE_MAGIC,
+        .version = ASSET_ARCHIVE_VERSION,
+        .entryCount = static_cast<uint32_t>(packed.size()),
+        .reserved = 0
+    };
+    std::vector<uint8_t> output(offset, 0);
+    std::memcpy(output.data(), &header, sizeof(header));
+    for (std::size_t i = 0; i < packed.size(); ++i) {
+        const PackedInput& each = packed[i];
+        std::memcpy(output.data() + sizeof(header) + i * sizeof(AssetArchiveEntry), &each.entry, sizeof(AssetArchiveEntry));
+        const std::vector<uint8_t>& blob = each.entry.compression == AssetCompression::NONE ? each.input->data : each.compressed;
+        std::copy(blob.begin(), blob.end(), output.begin() + each.entry.offset);
+    }
+    return output;
+}
+
+} // namespace clay::utils
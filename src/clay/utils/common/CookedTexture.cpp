@@ -0,0 +1,126 @@
+// standard lib
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+// class
+#include "clay/utils/common/CookedTexture.h"
+
+namespace clay::utils {
+
+namespace {
+
+struct LevelIndexEntry {
+    uint64_t offset;
+    uint64_t size;
+};
+
+static_assert(sizeof(CookedTextureHeader) == 32, "CookedTextureHeader layout is part of the file format");
+static_assert(sizeof(LevelIndexEntry) == 16, "LevelIndexEntry layout is part of the file format");
+
+std::size_t alignUp(std::size_t value, std::size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+bool isCookedTextureFile(const FileData& fileData) {
+    uint32_t magic = 0;
+    if (fileData.size < sizeof(magic)) {
+        return false;
+    }
+    std::memcpy(&magic, fileData.data.get(), sizeof(magic));
+    return magic == COOKED_TEXTURE_MAGIC;
+}
+
+TextureData parseCookedTexture(FileData&& fileData) {
+    if (!isCookedTextureFile(fileData) || fileData.size < sizeof(CookedTextureHeader)) {
+        throw std::runtime_error("Not a cooked texture");
+    }
+
+    CookedTextureHeader header;
+    std::memcpy(&header, fileData.data.get(), sizeof(header));
+    if (header.version != COOKED_TEXTURE_VERSION) {
+        throw std::runtime_error(
+            "Cooked texture version " + std::to_string(header.version) +
+            " does not match " + std::to_string(COOKED_TEXTURE_VERSION) + ", re-run the texture cooker"
+        );
+    }
+    if (header.width == 0 || header.height == 0 || header.levelCount == 0) {
+        throw std::runtime_error("Cooked texture has no image data");
+    }
+    if (header.width > MAX_TEXTURE_DIMENSION || header.height > MAX_TEXTURE_DIMENSION) {
+        throw std::runtime_error("Cooked texture: " + std::to_string(header.width) + "x" + std::to_string(header.height) + " is too large");
+    }
+    if (calculateLevelSize(header.vkFormat, 1, 1) == 0) {
+        throw std::runtime_error("Cooked texture: unsupported format " + std::to_string(header.vkFormat));
+    }
+    if (header.levelCount > calculateMipLevels(static_cast<int>(header.width), static_cast<int>(header.height))) {
+        throw std::runtime_error("Cooked texture: " + std::to_string(header.levelCount) + " levels is more than a full mip chain");
+    }
+    const std::size_t indexEnd = sizeof(CookedTextureHeader) + static_cast<std::size_t>(header.levelCount) * sizeof(LevelIndexEntry);
+    if (indexEnd > fileData.size) {
+        throw std::runtime_error("Cooked texture: truncated level index");
+    }
+
+    TextureData textureData;
+    textureData.vkFormat = header.vkFormat;
+    textureData.width = header.width;
+    textureData.height = header.height;
+    textureData.premultipliedAlpha = (header.flags & COOKED_TEXTURE_PREMULTIPLIED_ALPHA) != 0;
+    textureData.levels.reserve(header.levelCount);
+
+    for (uint32_t level = 0; level < header.levelCount; ++level) {
+        LevelIndexEntry entry;
+        std::memcpy(&entry, fileData.data.get() + sizeof(CookedTextureHeader) + level * sizeof(LevelIndexEntry), sizeof(entry));
+        if (entry.offset > fileData.size || entry.size > fileData.size - entry.offset) {
+            throw std::runtime_error("Cooked texture: level " + std::to_string(level) + " is out of bounds");
+        }
+        const uint32_t levelWidth = std::max(header.width >> level, 1u);
+        const uint32_t levelHeight = std::max(header.height >> level, 1u);
+        if (entry.size != calculateLevelSize(header.vkFormat, levelWidth, levelHeight)) {
+            throw std::runtime_error("Cooked texture: level " + std::to_string(level) + " size does not match its format");
+        }
+
+        textureData.levels.push_back({
+            static_cast<std::size_t>(entry.offset),
+            static_cast<std::size_t>(entry.size),
+            levelWidth,
+            levelHeight
+        });
+    }
+
+    textureData.storage = std::move(fileData);
+    return textureData;
+}
+
+std::vector<uint8_t> writeCookedTexture(uint32_t vkFormat, uint32_t width, uint32_t height, uint32_t flags, const std::vector<std::vector<uint8_t>>& levels) {
+    const CookedTextureHeader header{
+        .magic = COOKED_TEXTURE_MAGIC,
+        .version = COOKED_TEXTURE_VERSION,
+        .vkFormat = vkFormat,
+        .width = width,
+        .height = height,
+        .levelCount = static_cast<uint32_t>(levels.size()),
+        .flags = flags,
+        .reserved = 0
+    };
+
+    std::vector<LevelIndexEntry> index(levels.size());
+    std::size_t offset = sizeof(CookedTextureHeader) + levels.size() * sizeof(LevelIndexEntry);
+    for (size_t i = 0; i < levels.size(); ++i) {
+        offset = alignUp(offset, COOKED_TEXTURE_ALIGNMENT);
+        index[i] = {offset, levels[i].size()};
+        offset += levels[i].size();
+    }
+
+    std::vector<uint8_t> output(offset, 0);
+    std::memcpy(output.data(), &header, sizeof(header));
+    std::memcpy(output.data() + sizeof(header), index.data(), index.size() * sizeof(LevelIndexEntry));
+    for (size_t i = 0; i < levels.size(); ++i) {
+        std::copy(levels[i].begin(), levels[i].end(), output.begin() + index[i].offset);
+    }
+    return output;
+}
+
+} // namespace clay::utils
@@ -0,0 +1,222 @@
+// standard lib
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+// clay
+#include "clay/utils/common/Logger.h"
+#include "clay/utils/common/Lz4.h"
+// class
+#include "clay/utils/common/DerivedDataCache.h"
+
+namespace clay::utils {
+
+namespace {
+
+static_assert(sizeof(DerivedDataHeader) == 32, "DerivedDataHeader layout is part of the file format");
+
+constexpr const char* kEntryExtension = ".ddc";
+
+} // namespace
+
+DerivedDataCache::DerivedDataCache(const std::filesystem::path& directory, uint64_t maxBytes)
+    : mDirectory_(directory),
+      mMaxBytes_(maxBytes) {
+    std::error_code error;
+    std::filesystem::create_directories(mDirectory_, error);
+    if (error) {
+        throw std::runtime_error("Failed to create derived data cache " + mDirectory_.string() + ": " + error.message());
+    }
+
+    for (const std::filesystem::directory_entry& file : std::filesystem::directory_iterator(mDirectory_, error)) {
+        const std::filesystem::path& path = file.path();
+        const std::string stem = path.stem().string();
+        if (path.extension() != kEntryExtension || stem.size() != 16 || !file.is_regular_file(error)) {
+            continue;
+        }
+        if (stem.find_first_not_of("0123456789abcdef") != std::string::npos) {
+            continue;
+        }
+        const uint64_t size = file.file_size(error);
+        const std::filesystem::file_time_type lastUse = file.last_write_time(error);
+        if (error) {
+            continue;
+        }
+        mEntries_[std::stoull(stem, nullptr, 16)] = {size, lastUse};
+        mTotalBytes_ += size;
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex_);
+    evict();
+}
+
+uint64_t DerivedDataCache::makeKey(std::string_view importer, uint32_t importerVersion, const FileData& source, std::string_view options) {
+    const uint64_t contentHash = hashString(std::string_view(reinterpret_cast<const char*>(source.data.get()), source.size));
+
+    std::string keyBytes(importer);
+    keyBytes.push_back('\0');
+    keyBytes.append(reinterpret_cast<const char*>(&importerVersion), sizeof(importerVersion));
+    keyBytes.append(reinterpret_cast<const char*>(&contentHash), sizeof(contentHash));
+    keyBytes.append(options);
+    return hashString(keyBytes);
+}
+
+std::optional<FileData> DerivedDataCache::load(uint64_t key) {
+    {
+        std::lock_guard<std::mutex> lock(mMutex_);
+        if (mEntries_.find(key) == mEntries_.end()) {
+            return std::nullopt;
+        }
+    }
+
+    const std::filesystem::path path = pathFor(key);
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        // evicted by another thread since the lookup
+        std::lock_guard<std::mutex> lock(mMutex_);
+        erase(key);
+        return std::nullopt;
+    }
+    const uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+    file.seekg(0);
+
+    DerivedDataHeader header{};
+    bool valid = fileSize >= sizeof(header) && file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    valid = valid &&
+        header.magic == DERIVED_DATA_MAGIC &&
+        header.version == DERIVED_DATA_VERSION &&
+        header.key == key &&
+        header.storedSize == fileSize - sizeof(header) &&
+        header.storedSize <= header.size;
+
+    FileData result{};
+    if (valid) {
+        std::vector<uint8_t> stored(header.storedSize);
+        valid = static_cast<bool>(file.read(reinterpret_cast<char*>(stored.data()), static_cast<std::streamsize>(stored.size())));
+        if (valid) {
+            result = {std::make_unique<uint8_t[]>(header.size), header.size};
+            if (header.storedSize == header.size) {
+                std::memcpy(result.data.get(), stored.data(), stored.size());
+            } else {
+                try {
+                    decompressLz4Block(stored.data(), stored.size(), result.data.get(), result.size);
+                } catch (const std::runtime_error&) {
+                    valid = false;
+                }
+            }
+        }
+    }
+    file.close();
+
+    std::error_code error;
+    if (!valid) {
+        LOG_E("Derived data cache: discarding corrupt entry %s", path.string().c_str());
+        std::filesystem::remove(path, error);
+        std::lock_guard<std::mutex> lock(mMutex_);
+        erase(key);
+        return std::nullopt;
+    }
+
+    // the modification time persists the use order between runs
+    const std::filesystem::file_time_type now = std::filesystem::file_time_type::clock::now();
+    std::filesystem::last_write_time(path, now, error);
+    std::lock_guard<std::mutex> lock(mMutex_);
+    auto it = mEntries_.find(key);
+    if (it != mEntries_.end()) {
+        it->second.lastUse = now;
+    }
+    return result;
+}
+
+void DerivedDataCache::store(uint64_t key, const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> compressed = compressLz4Block(data.data(), data.size());
+    const bool useCompressed = compressed.size() < data.size();
+    const std::vector<uint8_t>& stored = useCompressed ? compressed : data;
+
+    const DerivedDataHeader header{
+        DERIVED_DATA_MAGIC,
+        DERIVED_DATA_VERSION,
+        key,
+        data.size(),
+        stored.size()
+    };
+
+    // written aside and renamed so a reader never sees a partial entry
+    const std::filesystem::path path = pathFor(key);
+    std::filesystem::path tempPath = path;
+    tempPath += ".tmp" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(stored.data()), static_cast<std::streamsize>(stored.size()));
+        if (!file) {
+            LOG_E("Derived data cache: failed to write %s", tempPath.string().c_str());
+            file.close();
+            std::error_code error;
+            std::filesystem::remove(tempPath, error);
+            return;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        LOG_E("Derived data cache: failed to write %s: %s", path.string().c_str(), error.message().c_str());
+        std::filesystem::remove(tempPath, error);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex_);
+    erase(key);
+    const uint64_t size = sizeof(header) + stored.size();
+    mEntries_[key] = {size, std::filesystem::file_time_type::clock::now()};
+    mTotalBytes_ += size;
+    evict();
+}
+
+uint64_t DerivedDataCache::getSize() const {
+    std::lock_guard<std::mutex> lock(mMutex_);
+    return mTotalBytes_;
+}
+
+std::filesystem::path DerivedDataCache::pathFor(uint64_t key) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx%s", static_cast<unsigned long long>(key), kEntryExtension);
+    return mDirectory_ / name;
+}
+
+void DerivedDataCache::evict() {
+    if (mTotalBytes_ <= mMaxBytes_) {
+        return;
+    }
+
+    std::vector<std::pair<std::filesystem::file_time_type, uint64_t>> byUse;
+    byUse.reserve(mEntries_.size());
+    for (const auto& [key, entry] : mEntries_) {
+        byUse.emplace_back(entry.lastUse, key);
+    }
+    std::sort(byUse.begin(), byUse.end());
+
+    for (const auto& [lastUse, key] : byUse) {
+        if (mTotalBytes_ <= mMaxBytes_) {
+            break;
+        }
+        std::error_code error;
+        std::filesystem::remove(pathFor(key), error);
+        erase(key);
+    }
+}
+
+void DerivedDataCache::erase(uint64_t key) {
+    auto it = mEntries_.find(key);
+    if (it != mEntries_.end()) {
+        mTotalBytes_ -= it->second.size;
+        mEntries_.erase(it);
+    }
+}
+
+} // namespace clay::utils
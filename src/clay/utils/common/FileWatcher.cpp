@@ -0,0 +1,137 @@
+// standard lib
+#include <system_error>
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+// class
+#include "clay/utils/common/FileWatcher.h"
+
+namespace clay::utils {
+
+namespace {
+
+std::filesystem::file_time_type lastWriteTime(const std::string& path) {
+    std::error_code error;
+    const std::filesystem::file_time_type time = std::filesystem::last_write_time(path, error);
+    return error ? std::filesystem::file_time_type::min() : time;
+}
+
+} // namespace
+
+FileWatcher::FileWatcher(std::chrono::milliseconds pollInterval)
+    : mPollInterval_(pollInterval) {
+#ifdef __linux__
+    mInotifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+    mThread_ = std::thread(&FileWatcher::run, this);
+}
+
+FileWatcher::~FileWatcher() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex_);
+        mStopping_ = true;
+    }
+    mStopCondition_.notify_all();
+    mThread_.join();
+#ifdef __linux__
+    if (mInotifyFd_ >= 0) {
+        close(mInotifyFd_);
+    }
+#endif
+}
+
+std::string FileWatcher::normalize(const std::filesystem::path& path) {
+    std::error_code error;
+    std::filesystem::path absolute = std::filesystem::absolute(path, error);
+    return (error ? path : absolute).lexically_normal().string();
+}
+
+void FileWatcher::watch(const std::filesystem::path& path) {
+    const std::string file = normalize(path);
+    std::lock_guard<std::mutex> lock(mMutex_);
+    if (mFiles_.count(file) != 0) {
+        return;
+    }
+    mFiles_[file] = lastWriteTime(file);
+
+#ifdef __linux__
+    if (mInotifyFd_ >= 0) {
+        // editors often save by renaming a temporary file over the original, so watch the directory
+        const std::string directory = std::filesystem::path(file).parent_path().string();
+        const int watchDescriptor = inotify_add_watch(mInotifyFd_, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+        if (watchDescriptor >= 0) {
+            mDirectories_[watchDescriptor] = directory;
+        }
+    }
+#endif
+}
+
+std::vector<std::string> FileWatcher::takeChanged() {
+    std::lock_guard<std::mutex> lock(mMutex_);
+    std::vector<std::string> changed(mChanged_.begin(), mChanged_.end());
+    mChanged_.clear();
+    return changed;
+}
+
+bool FileWatcher::isUsingInotify() const {
+    return mInotifyFd_ >= 0;
+}
+
+void FileWatcher::run() {
+    std::unique_lock<std::mutex> lock(mMutex_);
+    while (!mStopping_) {
+        if (isUsingInotify()) {
+            lock.unlock();
+            readInotifyEvents();
+            lock.lock();
+        } else {
+            mStopCondition_.wait_for(lock, mPollInterval_, [this]() { return mStopping_; });
+            if (!mStopping_) {
+                pollTimestamps();
+            }
+        }
+    }
+}
+
+void FileWatcher::pollTimestamps() {
+    for (auto& [file, time] : mFiles_) {
+        const std::filesystem::file_time_type current = lastWriteTime(file);
+        if (current != time) {
+            time = current;
+            mChanged_.insert(file);
+        }
+    }
+}
+
+void FileWatcher::readInotifyEvents() {
+#ifdef __linux__
+    // the timeout bounds how long shutdown waits for this thread
+    pollfd descriptor{mInotifyFd_, POLLIN, 0};
+    if (poll(&descriptor, 1, static_cast<int>(mPollInterval_.count())) <= 0) {
+        return;
+    }
+
+    alignas(inotify_event) char buffer[4096];
+    ssize_t length;
+    while ((length = read(mInotifyFd_, buffer, sizeof(buffer))) > 0) {
+        std::lock_guard<std::mutex> lock(mMutex_);
+        for (ssize_t offset = 0; offset < length;) {
+            const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+            auto directory = mDirectories_.find(event->wd);
+            if (directory == mDirectories_.end() || event->len == 0) {
+                continue;
+            }
+            const std::string file = (std::filesystem::path(directory->second) / event->name).string();
+            if (mFiles_.count(file) != 0) {
+                mChanged_.insert(file);
+            }
+        }
+    }
+#endif
+}
+
+} // namespace clay::utils
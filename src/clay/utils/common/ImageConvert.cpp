@@ -0,0 +1,624 @@
+// standard lib
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+// third party
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define CLAY_IMAGE_CONVERT_X86
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+        // MSVC allows any intrinsic without per function flags
+        #define CLAY_TARGET(isa)
+    #else
+        #define CLAY_TARGET(isa) __attribute__((target(isa)))
+    #endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #define CLAY_IMAGE_CONVERT_NEON
+    #include <arm_neon.h>
+#endif
+// class
+#include "clay/utils/common/ImageConvert.h"
+
+namespace clay::utils::image_convert {
+
+namespace {
+
+constexpr int kLinearTableSize = 4096;
+
+struct SrgbTables {
+    std::array<float, 256> toLinear;
+    std::array<int32_t, kLinearTableSize> toSrgb; // 32 bit so AVX2 can gather it
+};
+
+const SrgbTables& getSrgbTables() {
+    static const SrgbTables tables = []() {
+        SrgbTables result{};
+        for (int i = 0; i < 256; ++i) {
+            const float value = i / 255.0f;
+            result.toLinear[i] = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+        }
+        for (int i = 0; i < kLinearTableSize; ++i) {
+            const float value = i / static_cast<float>(kLinearTableSize - 1);
+            const float encoded = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+            result.toSrgb[i] = static_cast<int32_t>(std::lround(encoded * 255.0f));
+        }
+        return result;
+    }();
+    return tables;
+}
+
+inline int32_t linearTableIndex(float value) {
+    return static_cast<int32_t>(std::clamp(value, 0.0f, 1.0f) * (kLinearTableSize - 1) + 0.5f);
+}
+
+/** Exact round(x / 255) for x <= 255 * 255 */
+inline uint8_t divide255(uint32_t x) {
+    x += 128;
+    return static_cast<uint8_t>((x + (x >> 8)) >> 8);
+}
+
+struct Kernels {
+    void (*rgbToRgba)(const uint8_t*, uint8_t*, std::size_t);
+    void (*swapRedBlue)(const uint8_t*, uint8_t*, std::size_t);
+    void (*grayToRgba)(const uint8_t*, uint8_t*, std::size_t);
+    void (*grayAlphaToRgba)(const uint8_t*, uint8_t*, std::size_t);
+    void (*premultiplyLinear)(uint8_t*, std::size_t);
+    void (*linearToSrgb)(const float*, uint8_t*, std::size_t);
+    // averages 2x2 blocks of two source rows holding 2 * dstCount RGBA pixels each
+    void (*downsampleRow)(const uint8_t*, const uint8_t*, uint8_t*, std::size_t);
+};
+
+// scalar kernels, also used for the tails of the vector ones
+
+void rgbToRgbaScalar(const uint8_t* src, uint8_t* dst, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        dst[i * 4 + 0] = src[i * 3 + 0];
+        dst[i * 4 + 1] = src[i * 3 + 1];
+        dst[i * 4 + 2] = src[i * 3 + 2];
+        dst[i * 4 + 3] = 255;
+    }
+}
+
+void swapRedBlueScalar(const uint8_t* src, uint8_t* dst, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        const uint8_t red = src[i * 4 + 0];
+        dst[i * 4 + 0] = src[i * 4 + 2];
+        dst[i * 4 + 1] = src[i * 4 + 1];
+        dst[i * 4 + 2] = red;
+        dst[i * 4 + 3] = src[i * 4 + 3];
+    }
+}
+
+void grayToRgbaScalar(const uint8_t* src, uint8_t* dst, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        dst[i * 4 + 0] = dst[i * 4 + 1] = dst[i * 4 + 2] = src[i];
+        dst[i * 4 + 3] = 255;
+    }
+}
+
+void grayAlphaToRgbaScalar(const uint8_t* src, uint8_t* dst, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        dst[i * 4 + 0] = dst[i * 4 + 1] = dst[i * 4 + 2] = src[i * 2];
+        dst[i * 4 + 3] = src[i * 2 + 1];
+    }
+}
+
+void premultiplyLinearScalar(uint8_t* rgba, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        uint8_t* pixel = rgba + i * 4;
+        pixel[0] = divide255(pixel[0] * pixel[3]);
+        pixel[1] = divide255(pixel[1] * pixel[3]);
+        pixel[2] = divide255(pixel[2] * pixel[3]);
+    }
+}
+
+void linearToSrgbScalar(const float* src, uint8_t* dst, std::size_t count) {
+    const SrgbTables& tables = getSrgbTables();
+    for (std::size_t i = 0; i < count; ++i) {
+        dst[i] = static_cast<uint8_t>(tables.toSrgb[linearTableIndex(src[i])]);
+    }
+}
+
+void downsampleRowScalar(const uint8_t* row0, const uint8_t* row1, uint8_t* dst, std::size_t count) {
+    for (std::size_t i = 0; i < count * 4; ++i) {
+        const std::size_t channel = i % 4;
+        const std::size_t source = (i - channel) * 2 + channel;
+        dst[i] = static_cast<uint8_t>((row0[source] + row0[source + 4] + row1[source] + row1[source + 4] + 2) >> 2);
+    }
+}
+
+constexpr Kernels kScalarKernels{
+    rgbToRgbaScalar,
+    swapRedBlueScalar,
+    grayToRgbaScalar,
+    grayAlphaToRgbaScalar,
+    premultiplyLinearScalar,
+    linearToSrgbScalar,
+    downsampleRowScalar
+};
+
+#ifdef CLAY_IMAGE_CONVERT_X86
+
+CLAY_TARGET("sse4.1")
+void rgbToRgbaSse4(const uint8_t* src, uint8_t* dst, std::size_t count) {
+    const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000));
+    std::size_t i = 0;
+    // the 16 byte load reads 4 bytes past the 4 pixels it converts
+    for (; i + 6 <= count; i += 4) {
+        const __m128i rgb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), _mm_or_si128(_mm_shuffle_epi8(rgb, shuffle), alpha));
+    }
+    rgbToRgbaScalar(src + i * 3, dst + i * 4, count - i);
+}
+
+CLAY_TARGET("sse4.1")
+void swapRedBlueSse4(const uint8_t* src, uint8_t* dst, std::size_t count) {
+    const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), _mm_shuffle_epi8(pixels, shuffle));
+    }
+    swapRedBlueScalar(src + i * 4, dst + i * 4, count - i);
+}
+
+CLAY_TARGET("sse4.1")
+void grayToRgbaSse4(const uint8_t* src, uint8_t* dst, std::size_t count) {
+    const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000));
+    const __m128i shuffles[4] = {
+        _mm_setr_epi8(0, 0, 0, -1, 1, 1, 1, -1, 2, 2, 2, -1, 3, 3, 3, -1),
+        _mm_setr_epi8(4, 4, 4, -1, 5, 5, 5, -1, 6, 6, 6, -1, 7, 7, 7, -1),
+        _mm_setr_epi8(8, 8, 8, -1, 9, 9, 9, -1, 10, 10, 10, -1, 11, 11, 11, -1),
+        _mm_setr_epi8(12, 12, 12, -1, 13, 13, 13, -1, 14, 14, 14, -1, 15, 15, 15, -1)
+    };
+    std::size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const __m128i gray = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        for (int part = 0; part < 4; ++part) {
+            _mm_storeu_si128(
+                reinterpret_cast<__m128i*>(dst + (i + part * 4) * 4),
+                _mm_or_si128(_mm_shuffle_epi8(gray, shuffles[part]), alpha)
+            );
+        }
+    }
+    grayToRgbaScalar(src + i, dst + i * 4, count - i);
+}
+
+CLAY_TARGET("sse4.1")
+void grayAlphaToRgbaSse4(const uint8_t* src, uint8_t* dst, std::size_t count) {
+    const __m128i low = _mm_setr_epi8(0, 0, 0, 1, 2, 2, 2, 3, 4, 4, 4, 5, 6, 6, 6, 7);
+    const __m128i high = _mm_setr_epi8(8, 8, 8, 9, 10, 10, 10, 11, 12, 12, 12, 13, 14, 14, 14, 15);
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m128i grayAlpha = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), _mm_shuffle_epi8(grayAlpha, low));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4 + 16), _mm_shuffle_epi8(grayAlpha, high));
+    }
+    grayAlphaToRgbaScalar(src + i * 2, dst + i * 4, count - i);
+}
+
+/** Two pixels widened to 16 bit times their alpha, divided by 255 */
+CLAY_TARGET("sse4.1")
+inline __m128i premultiplyWordsSse4(__m128i pixels) {
+    __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    // alpha itself is multiplied by 255 so it survives the division
+    alpha = _mm_blend_epi16(alpha, _mm_set1_epi16(255), 0x88);
+    const __m128i product = _mm_add_epi16(_mm_mullo_epi16(pixels, alpha), _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(product, _mm_srli_epi16(product, 8)), 8);
+}
+
+CLAY_TARGET("sse4.1")
+void premultiplyLinearSse4(uint8_t* rgba, std::size_t count) {
+    const __m128i zero = _mm_setzero_si128();
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgba + i * 4));
+        const __m128i low = premultiplyWordsSse4(_mm_unpacklo_epi8(pixels, zero));
+        const __m128i high = premultiplyWordsSse4(_mm_unpackhi_epi8(pixels, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(rgba + i * 4), _mm_packus_epi16(low, high));
+    }
+    premultiplyLinearScalar(rgba + i * 4, count - i);
+}
+
+CLAY_TARGET("sse4.1")
+void downsampleRowSse4(const uint8_t* row0, const uint8_t* row1, uint8_t* dst, std::size_t count) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i rounding = _mm_set1_epi16(2);
+    std::size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        const __m128i top = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + i * 8));
+        const __m128i bottom = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + i * 8));
+        // vertical sums of source pixels 0, 1 and 2, 3
+        const __m128i low = _mm_add_epi16(_mm_unpacklo_epi8(top, zero), _mm_unpacklo_epi8(bottom, zero));
+        const __m128i high = _mm_add_epi16(_mm_unpackhi_epi8(top, zero), _mm_unpackhi_epi8(bottom, zero));
+        // horizontal neighbour sums in the low 4 words
+        const __m128i sum = _mm_unpacklo_epi64(
+            _mm_add_epi16(low, _mm_srli_si128(low, 8)),
+            _mm_add_epi16(high, _mm_srli_si128(high, 8))
+        );
+        const __m128i average = _mm_srli_epi16(_mm_add_epi16(sum, rounding), 2);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i * 4), _mm_packus_epi16(average, average));
+    }
+    downsampleRowScalar(row0 + i * 8, row1 + i * 8, dst + i * 4, count - i);
+}
+
+CLAY_TARGET("avx2")
+void rgbToRgbaAvx2(const uint8_t* src, uint8_t* dst, std::size_t count) {
+    const __m256i shuffle = _mm256_setr_epi8(
+        0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+        0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1
+    );
+    const __m256i alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000));
+    std::size_t i = 0;
+    // 4 pixels per 128 bit lane, the upper load reads 4 bytes past the 8 pixels
+    for (; i + 10 <= count; i += 8) {
+        const __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3));
+        const __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3 + 12));
+        const __m256i rgb = _mm256_inserti128_si256(_mm256_castsi128_si256(first), second, 1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4), _mm256_or_si256(_mm256_shuffle_epi8(rgb, shuffle), alpha));
+    }
+    rgbToRgbaSse4(src + i * 3, dst + i * 4, count - i);
+}
+
+CLAY_TARGET("avx2")
+void swapRedBlueAvx2(const uint8_t* src, uint8_t* dst, std::size_t count) {
+    const __m256i shuffle = _mm256_setr_epi8(
+        2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+        2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15
+    );
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4), _mm256_shuffle_epi8(pixels, shuffle));
+    }
+    swapRedBlueScalar(src + i * 4, dst + i * 4, count - i);
+}
+
+CLAY_TARGET("avx2")
+inline __m256i premultiplyWordsAvx2(__m256i pixels) {
+    __m256i alpha = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    alpha = _mm256_blend_epi16(alpha, _mm256_set1_epi16(255), 0x88);
+    const __m256i product = _mm256_add_epi16(_mm256_mullo_epi16(pixels, alpha), _mm256_set1_epi16(128));
+    return _mm256_srli_epi16(_mm256_add_epi16(product, _mm256_srli_epi16(product, 8)), 8);
+}
+
+CLAY_TARGET("avx2")
+void premultiplyLinearAvx2(uint8_t* rgba, std::size_t count) {
+    const __m256i zero = _mm256_setzero_si256();
+    std::size_t i = 0;
+    // unpack and pack both work per 128 bit lane, so the pixel order is preserved
+    for (; i + 8 <= count; i += 8) {
+        const __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgba + i * 4));
+        const __m256i low = premultiplyWordsAvx2(_mm256_unpacklo_epi8(pixels, zero));
+        const __m256i high = premultiplyWordsAvx2(_mm256_unpackhi_epi8(pixels, zero));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(rgba + i * 4), _mm256_packus_epi16(low, high));
+    }
+    premultiplyLinearSse4(rgba + i * 4, count - i);
+}
+
+CLAY_TARGET("avx2")
+void linearToSrgbAvx2(const float* src, uint8_t* dst, std::size_t count) {
+    const int32_t* table = getSrgbTables().toSrgb.data();
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 scale = _mm256_set1_ps(static_cast<float>(kLinearTableSize - 1));
+    const __m256 half = _mm256_set1_ps(0.5f);
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256 value = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(src + i), zero), one);
+        const __m256i index = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(value, scale), half));
+        const __m256i encoded = _mm256_i32gather_epi32(table, index, 4);
+        const __m128i words = _mm_packus_epi32(_mm256_castsi256_si128(encoded), _mm256_extracti128_si256(encoded, 1));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(words, words));
+    }
+    linearToSrgbScalar(src + i, dst + i, count - i);
+}
+
+constexpr Kernels kSse4Kernels{
+    rgbToRgbaSse4,
+    swapRedBlueSse4,
+    grayToRgbaSse4,
+    grayAlphaToRgbaSse4,
+    premultiplyLinearSse4,
+    linearToSrgbScalar, // needs a gather to beat the table lookup
+    downsampleRowSse4
+};
+
+constexpr Kernels kAvx2Kernels{
+    rgbToRgbaAvx2,
+    swapRedBlueAvx2,
+    grayToRgbaSse4,      // bound by the stores, wider registers do not help
+    grayAlphaToRgbaSse4,
+    premultiplyLinearAvx2,
+    linearToSrgbAvx2,
+    downsampleRowSse4
+};
+
+#endif // CLAY_IMAGE_CONVERT_X86
+
+#ifdef CLAY_IMAGE_CONVERT_NEON
+
+void rgbToRgbaNeon(const uint8_t* src, uint8_t* dst, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const uint8x16x3_t rgb = vld3q_u8(src + i * 3);
+        const uint8x16x4_t rgba = {{rgb.val[0], rgb.val[1], rgb.val[2], vdupq_n_u8(255)}};
+        vst4q_u8(dst + i * 4, rgba);
+    }
+    rgbToRgbaScalar(src + i * 3, dst + i * 4, count - i);
+}
+
+void swapRedBlueNeon(const uint8_t* src, uint8_t* dst, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        uint8x16x4_t pixels = vld4q_u8(src + i * 4);
+        const uint8x16_t red = pixels.val[0];
+        pixels.val[0] = pixels.val[2];
+        pixels.val[2] = red;
+        vst4q_u8(dst + i * 4, pixels);
+    }
+    swapRedBlueScalar(src + i * 4, dst + i * 4, count - i);
+}
+
+void grayToRgbaNeon(const uint8_t* src, uint8_t* dst, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const uint8x16_t gray = vld1q_u8(src + i);
+        const uint8x16x4_t rgba = {{gray, gray, gray, vdupq_n_u8(255)}};
+        vst4q_u8(dst + i * 4, rgba);
+    }
+    grayToRgbaScalar(src + i, dst + i * 4, count - i);
+}
+
+void grayAlphaToRgbaNeon(const uint8_t* src, uint8_t* dst, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const uint8x16x2_t grayAlpha = vld2q_u8(src + i * 2);
+        const uint8x16x4_t rgba = {{grayAlpha.val[0], grayAlpha.val[0], grayAlpha.val[0], grayAlpha.val[1]}};
+        vst4q_u8(dst + i * 4, rgba);
+    }
+    grayAlphaToRgbaScalar(src + i * 2, dst + i * 4, count - i);
+}
+
+inline uint8x8_t multiplyDivide255Neon(uint8x8_t color, uint8x8_t alpha) {
+    const uint16x8_t product = vaddq_u16(vmull_u8(color, alpha), vdupq_n_u16(128));
+    return vaddhn_u16(product, vshrq_n_u16(product, 8));
+}
+
+void premultiplyLinearNeon(uint8_t* rgba, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        uint8x16x4_t pixels = vld4q_u8(rgba + i * 4);
+        const uint8x16_t alpha = pixels.val[3];
+        for (int channel = 0; channel < 3; ++channel) {
+            pixels.val[channel] = vcombine_u8(
+                multiplyDivide255Neon(vget_low_u8(pixels.val[channel]), vget_low_u8(alpha)),
+                multiplyDivide255Neon(vget_high_u8(pixels.val[channel]), vget_high_u8(alpha))
+            );
+        }
+        vst4q_u8(rgba + i * 4, pixels);
+    }
+    premultiplyLinearScalar(rgba + i * 4, count - i);
+}
+
+void downsampleRowNeon(const uint8_t* row0, const uint8_t* row1, uint8_t* dst, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const uint8x16x4_t top = vld4q_u8(row0 + i * 8);
+        const uint8x16x4_t bottom = vld4q_u8(row1 + i * 8);
+        uint8x8x4_t average;
+        for (int channel = 0; channel < 4; ++channel) {
+            const uint16x8_t sum = vpadalq_u8(vpaddlq_u8(top.val[channel]), bottom.val[channel]);
+            average.val[channel] = vrshrn_n_u16(sum, 2);
+        }
+        vst4_u8(dst + i * 4, average);
+    }
+    downsampleRowScalar(row0 + i * 8, row1 + i * 8, dst + i * 4, count - i);
+}
+
+constexpr Kernels kNeonKernels{
+    rgbToRgbaNeon,
+    swapRedBlueNeon,
+    grayToRgbaNeon,
+    grayAlphaToRgbaNeon,
+    premultiplyLinearNeon,
+    linearToSrgbScalar,
+    downsampleRowNeon
+};
+
+#endif // CLAY_IMAGE_CONVERT_NEON
+
+const Kernels& getKernels(SimdLevel level) {
+    switch (level) {
+#ifdef CLAY_IMAGE_CONVERT_X86
+        case SimdLevel::AVX2:
+            return kAvx2Kernels;
+        case SimdLevel::SSE4:
+            return kSse4Kernels;
+#endif
+#ifdef CLAY_IMAGE_CONVERT_NEON
+        case SimdLevel::NEON:
+            return kNeonKernels;
+#endif
+        default:
+            return kScalarKernels;
+    }
+}
+
+SimdLevel detectSimdLevel() {
+#if defined(CLAY_IMAGE_CONVERT_X86)
+    #if defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuid(info, 0);
+        const int maxLeaf = info[0];
+        __cpuid(info, 1);
+        const bool ssse3 = (info[2] & (1 << 9)) != 0;
+        const bool sse41 = (info[2] & (1 << 19)) != 0;
+        const bool osXsave = (info[2] & (1 << 27)) != 0;
+        const bool avx = (info[2] & (1 << 28)) != 0;
+        if (maxLeaf >= 7 && osXsave && avx && (_xgetbv(0) & 0x6) == 0x6) {
+            __cpuidex(info, 7, 0);
+            if ((info[1] & (1 << 5)) != 0) {
+                return SimdLevel::AVX2;
+            }
+        }
+        if (ssse3 && sse41) {
+            return SimdLevel::SSE4;
+        }
+    #else
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return SimdLevel::AVX2;
+        }
+        if (__builtin_cpu_supports("ssse3") && __builtin_cpu_supports("sse4.1")) {
+            return SimdLevel::SSE4;
+        }
+    #endif
+#elif defined(CLAY_IMAGE_CONVERT_NEON)
+    return SimdLevel::NEON;
+#endif
+    return SimdLevel::SCALAR;
+}
+
+struct Dispatch {
+    SimdLevel level;
+    const Kernels* kernels;
+};
+
+Dispatch& getDispatch() {
+    static Dispatch dispatch = []() {
+        const SimdLevel level = getSupportedSimdLevel();
+        return Dispatch{level, &getKernels(level)};
+    }();
+    return dispatch;
+}
+
+bool isSupported(SimdLevel level) {
+    const SimdLevel supported = getSupportedSimdLevel();
+    switch (level) {
+        case SimdLevel::SCALAR:
+            return true;
+        case SimdLevel::SSE4:
+            return supported == SimdLevel::SSE4 || supported == SimdLevel::AVX2;
+        default:
+            return level == supported;
+    }
+}
+
+} // namespace
+
+SimdLevel getSupportedSimdLevel() {
+    static const SimdLevel level = detectSimdLevel();
+    return level;
+}
+
+SimdLevel getSimdLevel() {
+    return getDispatch().level;
+}
+
+void setSimdLevel(SimdLevel level) {
+    if (!isSupported(level)) {
+        throw std::runtime_error(std::string("SIMD level ") + toString(level) + " is not supported by this CPU");
+    }
+    getDispatch() = {level, &getKernels(level)};
+}
+
+const char* toString(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::SSE4:
+            return "SSE4";
+        case SimdLevel::AVX2:
+            return "AVX2";
+        case SimdLevel::NEON:
+            return "NEON";
+        default:
+            return "scalar";
+    }
+}
+
+void rgbToRgba(const uint8_t* src, uint8_t* dst, std::size_t pixelCount) {
+    getDispatch().kernels->rgbToRgba(src, dst, pixelCount);
+}
+
+void swapRedBlue(const uint8_t* src, uint8_t* dst, std::size_t pixelCount) {
+    getDispatch().kernels->swapRedBlue(src, dst, pixelCount);
+}
+
+void grayToRgba(const uint8_t* src, uint8_t* dst, std::size_t pixelCount) {
+    getDispatch().kernels->grayToRgba(src, dst, pixelCount);
+}
+
+void grayAlphaToRgba(const uint8_t* src, uint8_t* dst, std::size_t pixelCount) {
+    getDispatch().kernels->grayAlphaToRgba(src, dst, pixelCount);
+}
+
+void premultiplyAlpha(uint8_t* rgba, std::size_t pixelCount, bool srgb) {
+    if (!srgb) {
+        getDispatch().kernels->premultiplyLinear(rgba, pixelCount);
+        return;
+    }
+
+    const SrgbTables& tables = getSrgbTables();
+    for (std::size_t i = 0; i < pixelCount; ++i) {
+        uint8_t* pixel = rgba + i * 4;
+        const float alpha = pixel[3] / 255.0f;
+        for (int channel = 0; channel < 3; ++channel) {
+            pixel[channel] = static_cast<uint8_t>(tables.toSrgb[linearTableIndex(tables.toLinear[pixel[channel]] * alpha)]);
+        }
+    }
+}
+
+void srgbToLinear(const uint8_t* src, float* dst, std::size_t count) {
+    const SrgbTables& tables = getSrgbTables();
+    for (std::size_t i = 0; i < count; ++i) {
+        dst[i] = tables.toLinear[src[i]];
+    }
+}
+
+void linearToSrgb(const float* src, uint8_t* dst, std::size_t count) {
+    getDispatch().kernels->linearToSrgb(src, dst, count);
+}
+
+void downsampleBoxRgba(const uint8_t* src, int width, int height, uint8_t* dst, bool srgb) {
+    const int dstWidth = std::max(width / 2, 1);
+    const int dstHeight = std::max(height / 2, 1);
+    const std::size_t srcStride = static_cast<std::size_t>(width) * 4;
+    const SrgbTables& tables = getSrgbTables();
+
+    for (int y = 0; y < dstHeight; ++y) {
+        const uint8_t* row0 = src + static_cast<std::size_t>(std::min(y * 2, height - 1)) * srcStride;
+        const uint8_t* row1 = src + static_cast<std::size_t>(std::min(y * 2 + 1, height - 1)) * srcStride;
+        uint8_t* dstRow = dst + static_cast<std::size_t>(y) * dstWidth * 4;
+
+        if (width == 1) {
+            // a single column has no horizontal neighbour
+            for (int channel = 0; channel < 4; ++channel) {
+                dstRow[channel] = srgb && channel < 3
+                    ? static_cast<uint8_t>(tables.toSrgb[linearTableIndex((tables.toLinear[row0[channel]] + tables.toLinear[row1[channel]]) * 0.5f)])
+                    : static_cast<uint8_t>((row0[channel] + row1[channel] + 1) >> 1);
+            }
+            continue;
+        }
+
+        if (!srgb) {
+            getDispatch().kernels->downsampleRow(row0, row1, dstRow, static_cast<std::size_t>(dstWidth));
+            continue;
+        }
+        for (int x = 0; x < dstWidth; ++x) {
+            const uint8_t* top = row0 + x * 8;
+            const uint8_t* bottom = row1 + x * 8;
+            for (int channel = 0; channel < 3; ++channel) {
+                const float sum = tables.toLinear[top[channel]] + tables.toLinear[top[channel + 4]] +
+                    tables.toLinear[bottom[channel]] + tables.toLinear[bottom[channel + 4]];
+                dstRow[x * 4 + channel] = static_cast<uint8_t>(tables.toSrgb[linearTableIndex(sum * 0.25f)]);
+            }
+            dstRow[x * 4 + 3] = static_cast<uint8_t>((top[3] + top[7] + bottom[3] + bottom[7] + 2) >> 2);
+        }
+    }
+}
+
+} // namespace clay::utils::image_convert
@@ -0,0 +1,112 @@
+// standard lib
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+// class
+#include "clay/utils/common/Ktx2.h"
+
+namespace clay::utils {
+
+namespace {
+
+constexpr uint8_t kKtx2Identifier[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+// byte offsets of the header fields
+constexpr std::size_t kHeaderSize = 80;
+constexpr std::size_t kLevelIndexEntrySize = 24;
+
+enum SupercompressionScheme : uint32_t {
+    NONE = 0,
+    BASIS_LZ = 1,
+    ZSTANDARD = 2,
+    ZLIB = 3
+};
+
+template<typename T>
+T readLittleEndian(const uint8_t* bytes) {
+    // KTX2 is little endian, as are all platforms this runs on
+    T value;
+    std::memcpy(&value, bytes, sizeof(T));
+    return value;
+}
+
+} // namespace
+
+bool isKtx2File(const FileData& fileData) {
+    return fileData.size >= sizeof(kKtx2Identifier) &&
+        std::memcmp(fileData.data.get(), kKtx2Identifier, sizeof(kKtx2Identifier)) == 0;
+}
+
+TextureData parseKtx2File(FileData&& fileData) {
+    if (!isKtx2File(fileData) || fileData.size < kHeaderSize) {
+        throw std::runtime_error("Not a KTX2 file");
+    }
+
+    const uint8_t* bytes = fileData.data.get();
+    const uint32_t vkFormat = readLittleEndian<uint32_t>(bytes + 12);
+    const uint32_t pixelWidth = readLittleEndian<uint32_t>(bytes + 20);
+    const uint32_t pixelHeight = readLittleEndian<uint32_t>(bytes + 24);
+    const uint32_t pixelDepth = readLittleEndian<uint32_t>(bytes + 28);
+    const uint32_t layerCount = readLittleEndian<uint32_t>(bytes + 32);
+    const uint32_t faceCount = readLittleEndian<uint32_t>(bytes + 36);
+    const uint32_t storedLevelCount = readLittleEndian<uint32_t>(bytes + 40);
+    const uint32_t supercompression = readLittleEndian<uint32_t>(bytes + 44);
+
+    if (supercompression == BASIS_LZ || vkFormat == 0) {
+        throw std::runtime_error("KTX2: Basis Universal textures need a transcoder, which is not available");
+    }
+    if (supercompression != NONE) {
+        throw std::runtime_error("KTX2: unsupported supercompression scheme " + std::to_string(supercompression));
+    }
+    if (pixelWidth == 0 || pixelHeight == 0 || pixelDepth > 1 || layerCount > 1 || faceCount != 1) {
+        throw std::runtime_error("KTX2: only 2D textures are supported");
+    }
+    if (pixelWidth > MAX_TEXTURE_DIMENSION || pixelHeight > MAX_TEXTURE_DIMENSION) {
+        throw std::runtime_error("KTX2: " + std::to_string(pixelWidth) + "x" + std::to_string(pixelHeight) + " is too large");
+    }
+    if (calculateLevelSize(vkFormat, 1, 1) == 0) {
+        throw std::runtime_error("KTX2: unsupported format " + std::to_string(vkFormat));
+    }
+    // a level count of 0 asks the loader to generate the mip chain from the single stored level
+    const uint32_t levelCount = std::max(storedLevelCount, 1u);
+    if (levelCount > calculateMipLevels(static_cast<int>(pixelWidth), static_cast<int>(pixelHeight))) {
+        throw std::runtime_error("KTX2: " + std::to_string(levelCount) + " levels is more than a full mip chain");
+    }
+    if (kHeaderSize + static_cast<std::size_t>(levelCount) * kLevelIndexEntrySize > fileData.size) {
+        throw std::runtime_error("KTX2: truncated level index");
+    }
+
+    TextureData textureData;
+    textureData.vkFormat = vkFormat;
+    textureData.width = pixelWidth;
+    textureData.height = pixelHeight;
+    textureData.generateMipmaps = storedLevelCount == 0;
+    textureData.levels.reserve(levelCount);
+
+    for (uint32_t level = 0; level < levelCount; ++level) {
+        const uint8_t* entry = bytes + kHeaderSize + level * kLevelIndexEntrySize;
+        const uint64_t byteOffset = readLittleEndian<uint64_t>(entry);
+        const uint64_t byteLength = readLittleEndian<uint64_t>(entry + 8);
+        if (byteOffset > fileData.size || byteLength > fileData.size - byteOffset) {
+            throw std::runtime_error("KTX2: level " + std::to_string(level) + " is out of bounds");
+        }
+        const uint32_t levelWidth = std::max(pixelWidth >> level, 1u);
+        const uint32_t levelHeight = std::max(pixelHeight >> level, 1u);
+        if (byteLength != calculateLevelSize(vkFormat, levelWidth, levelHeight)) {
+            throw std::runtime_error("KTX2: level " + std::to_string(level) + " size does not match its format");
+        }
+
+        textureData.levels.push_back({
+            static_cast<std::size_t>(byteOffset),
+            static_cast<std::size_t>(byteLength),
+            levelWidth,
+            levelHeight
+        });
+    }
+
+    textureData.storage = std::move(fileData);
+    return textureData;
+}
+
+} // namespace clay::utils
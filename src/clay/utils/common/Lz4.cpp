@@ -0,0 +1,160 @@
+// standard lib
+#include <cstring>
+#include <stdexcept>
+// class
+#include "clay/utils/common/Lz4.h"
+
+namespace clay::utils {
+
+namespace {
+
+constexpr std::size_t kMinMatch = 4;
+// the format requires the last 5 bytes to be literals and the last match to start 12 bytes before the end
+constexpr std::size_t kLastLiterals = 5;
+constexpr std::size_t kMatchFindLimit = 12;
+constexpr std::size_t kMaxOffset = 65535;
+constexpr uint32_t kHashBits = 16;
+
+uint32_t read32(const uint8_t* bytes) {
+    uint32_t value;
+    std::memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+uint32_t hashSequence(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - kHashBits);
+}
+
+void writeLength(std::vector<uint8_t>& output, std::size_t length) {
+    for (; length >= 255; length -= 255) {
+        output.push_back(255);
+    }
+    output.push_back(static_cast<uint8_t>(length));
+}
+
+void writeSequence(std::vector<uint8_t>& output, const uint8_t* literals, std::size_t literalCount, std::size_t offset, std::size_t matchLength) {
+    const std::size_t extraMatch = matchLength - kMinMatch;
+    const uint8_t literalToken = static_cast<uint8_t>(literalCount < 15 ? literalCount : 15);
+    const uint8_t matchToken = static_cast<uint8_t>(extraMatch < 15 ? extraMatch : 15);
+    output.push_back(static_cast<uint8_t>(literalToken << 4 | matchToken));
+    if (literalCount >= 15) {
+        writeLength(output, literalCount - 15);
+    }
+    output.insert(output.end(), literals, literals + literalCount);
+    output.push_back(static_cast<uint8_t>(offset & 0xFF));
+    output.push_back(static_cast<uint8_t>(offset >> 8));
+    if (extraMatch >= 15) {
+        writeLength(output, extraMatch - 15);
+    }
+}
+
+std::size_t readLength(const uint8_t* source, std::size_t sourceSize, std::size_t& position) {
+    std::size_t length = 0;
+    uint8_t byte;
+    do {
+        if (position >= sourceSize) {
+            throw std::runtime_error("LZ4: truncated length");
+        }
+        byte = source[position++];
+        length += byte;
+    } while (byte == 255);
+    return length;
+}
+
+} // namespace
+
+std::vector<uint8_t> compressLz4Block(const uint8_t* source, std::size_t sourceSize) {
+    std::vector<uint8_t> output;
+    output.reserve(sourceSize + sourceSize / 255 + 16);
+
+    // positions + 1 so 0 marks an empty bucket
+    std::vector<uint32_t> table(std::size_t{1} << kHashBits, 0);
+    std::size_t anchor = 0;
+    std::size_t position = 0;
+    const std::size_t matchLimit = sourceSize > kLastLiterals ? sourceSize - kLastLiterals : 0;
+    while (position + kMatchFindLimit <= sourceSize) {
+        const uint32_t sequence = read32(source + position);
+        uint32_t& bucket = table[hashSequence(sequence)];
+        const std::size_t candidate = bucket;
+        bucket = static_cast<uint32_t>(position + 1);
+
+        if (candidate == 0 || position - (candidate - 1) > kMaxOffset || read32(source + candidate - 1) != sequence) {
+            ++position;
+            continue;
+        }
+
+        const std::size_t matchStart = candidate - 1;
+        std::size_t matchLength = kMinMatch;
+        while (position + matchLength < matchLimit && source[matchStart + matchLength] == source[position + matchLength]) {
+            ++matchLength;
+        }
+        writeSequence(output, source + anchor, position - anchor, position - matchStart, matchLength);
+        position += matchLength;
+        anchor = position;
+    }
+
+    // the last sequence is literals only
+    const std::size_t literalCount = sourceSize - anchor;
+    output.push_back(static_cast<uint8_t>((literalCount < 15 ? literalCount : 15) << 4));
+    if (literalCount >= 15) {
+        writeLength(output, literalCount - 15);
+    }
+    output.insert(output.end(), source + anchor, source + sourceSize);
+    return output;
+}
+
+void decompressLz4Block(const uint8_t* source, std::size_t sourceSize, uint8_t* destination, std::size_t destinationSize) {
+    std::size_t in = 0;
+    std::size_t out = 0;
+    while (true) {
+        if (in >= sourceSize) {
+            throw std::runtime_error("LZ4: truncated block");
+        }
+        const uint8_t token = source[in++];
+
+        std::size_t literalCount = token >> 4;
+        if (literalCount == 15) {
+            literalCount += readLength(source, sourceSize, in);
+        }
+        if (literalCount > sourceSize - in || literalCount > destinationSize - out) {
+            throw std::runtime_error("LZ4: literals out of bounds");
+        }
+        if (literalCount > 0) {
+            std::memcpy(destination + out, source + in, literalCount);
+        }
+        in += literalCount;
+        out += literalCount;
+        if (in == sourceSize) {
+            break;
+        }
+
+        if (sourceSize - in < 2) {
+            throw std::runtime_error("LZ4: truncated offset");
+        }
+        const std::size_t offset = source[in] | static_cast<std::size_t>(source[in + 1]) << 8;
+        in += 2;
+        if (offset == 0 || offset > out) {
+            throw std::runtime_error("LZ4: offset out of bounds");
+        }
+
+        std::size_t matchLength = token & 0x0F;
+        if (matchLength == 15) {
+            matchLength += readLength(source, sourceSize, in);
+        }
+        matchLength += kMinMatch;
+        if (matchLength > destinationSize - out) {
+            throw std::runtime_error("LZ4: match out of bounds");
+        }
+        // byte by byte, the match may overlap the bytes it produces
+        const uint8_t* match = destination + out - offset;
+        for (std::size_t i = 0; i < matchLength; ++i) {
+            destination[out + i] = match[i];
+        }
+        out += matchLength;
+    }
+    if (out != destinationSize) {
+        throw std::runtime_error("LZ4: decoded size does not match");
+    }
+}
+
+} // namespace clay::utils
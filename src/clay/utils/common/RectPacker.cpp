@@ -0,0 +1,116 @@
+// standard lib
+#include <algorithm>
+#include <limits>
+// class
+#include "clay/utils/common/RectPacker.h"
+
+namespace clay::utils {
+
+RectPacker::RectPacker(uint32_t width, uint32_t height)
+    : mWidth_(width),
+      mHeight_(height) {
+    reset();
+}
+
+std::optional<RectPacker::Rect> RectPacker::pack(uint32_t width, uint32_t height) {
+    if (width == 0 || height == 0) {
+        return Rect{0, 0, width, height};
+    }
+
+    size_t bestIndex = mSkyline_.size();
+    uint32_t bestTop = std::numeric_limits<uint32_t>::max();
+    uint32_t bestWidth = std::numeric_limits<uint32_t>::max();
+    uint32_t bestY = 0;
+    for (size_t i = 0; i < mSkyline_.size(); ++i) {
+        const std::optional<uint32_t> y = fitAt(i, width, height);
+        if (!y.has_value()) {
+            continue;
+        }
+        const uint32_t top = *y + height;
+        if (top < bestTop || (top == bestTop && mSkyline_[i].width < bestWidth)) {
+            bestIndex = i;
+            bestTop = top;
+            bestWidth = mSkyline_[i].width;
+            bestY = *y;
+        }
+    }
+    if (bestIndex == mSkyline_.size()) {
+        return std::nullopt;
+    }
+
+    const Rect rect{mSkyline_[bestIndex].x, bestY, width, height};
+    addSegment(bestIndex, rect);
+    mUsedArea_ += static_cast<uint64_t>(width) * height;
+    return rect;
+}
+
+void RectPacker::reset() {
+    mSkyline_.clear();
+    mSkyline_.push_back({0, 0, mWidth_});
+    mUsedArea_ = 0;
+}
+
+uint32_t RectPacker::getWidth() const {
+    return mWidth_;
+}
+
+uint32_t RectPacker::getHeight() const {
+    return mHeight_;
+}
+
+float RectPacker::getOccupancy() const {
+    const uint64_t area = static_cast<uint64_t>(mWidth_) * mHeight_;
+    return area == 0 ? 0.0f : static_cast<float>(mUsedArea_) / static_cast<float>(area);
+}
+
+std::optional<uint32_t> RectPacker::fitAt(size_t index, uint32_t width, uint32_t height) const {
+    if (mSkyline_[index].x + width > mWidth_) {
+        return std::nullopt;
+    }
+
+    // the rectangle rests on the highest segment it spans
+    uint32_t y = 0;
+    uint32_t remaining = width;
+    for (size_t i = index; remaining > 0; ++i) {
+        if (i == mSkyline_.size()) {
+            return std::nullopt;
+        }
+        y = std::max(y, mSkyline_[i].y);
+        if (y + height > mHeight_) {
+            return std::nullopt;
+        }
+        remaining -= std::min(remaining, mSkyline_[i].width);
+    }
+    return y;
+}
+
+void RectPacker::addSegment(size_t index, const Rect& rect) {
+    mSkyline_.insert(mSkyline_.begin() + index, {rect.x, rect.y + rect.height, rect.width});
+
+    // trim or remove the segments now covered by the new one
+    const uint32_t right = rect.x + rect.width;
+    size_t i = index + 1;
+    while (i < mSkyline_.size() && mSkyline_[i].x < right) {
+        Segment& segment = mSkyline_[i];
+        const uint32_t segmentRight = segment.x + segment.width;
+        if (segmentRight <= right) {
+            mSkyline_.erase(mSkyline_.begin() + i);
+            continue;
+        }
+        segment.width = segmentRight - right;
+        segment.x = right;
+        break;
+    }
+
+    // merge neighbours at the same height
+    for (size_t j = 0; j + 1 < mSkyline_.size();) {
+        if (mSkyline_[j].y == mSkyline_[j + 1].y) {
+            mSkyline_[j].width += mSkyline_[j + 1].width;
+            mSkyline_.erase(mSkyline_.begin() + j + 1);
+        } else {
+            ++j;
+        }
+    }
+}
+
+} // namespace clay::utils
@@ -0,0 +1,50 @@
+// standard lib
+#include <algorithm>
+// class
+#include "clay/utils/common/ThreadPool.h"
+
+namespace clay::utils {
+
+ThreadPool::ThreadPool(uint32_t threadCount) {
+    if (threadCount == 0) {
+        const uint32_t hardwareThreads = std::thread::hardware_concurrency();
+        threadCount = std::max<uint32_t>(hardwareThreads > 1 ? hardwareThreads - 1 : 1, 1);
+    }
+    mWorkers_.reserve(threadCount);
+    for (uint32_t i = 0; i < threadCount; ++i) {
+        mWorkers_.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex_);
+        mStopping_ = true;
+    }
+    mCondition_.notify_all();
+    for (std::thread& worker : mWorkers_) {
+        worker.join();
+    }
+}
+
+uint32_t ThreadPool::getThreadCount() const {
+    return static_cast<uint32_t>(mWorkers_.size());
+}
+
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mMutex_);
+            mCondition_.wait(lock, [this]() { return mStopping_ || !mTasks_.empty(); });
+            if (mTasks_.empty()) {
+                return;
+            }
+            task = std::move(mTasks_.front());
+            mTasks_.pop_front();
+        }
+        task();
+    }
+}
+
+} // namespace clay::utils
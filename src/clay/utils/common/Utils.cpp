@@ -1,6 +1,15 @@
+// standard lib
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+// third party
+#include <vulkan/vulkan.hpp>
+// clay
+#include "clay/utils/common/ImageConvert.h"
 // class
 #include "clay/utils/common/Utils.h"
-#include <stdexcept>
 
 namespace clay::utils {
 
@@ -8,29 +17,276 @@ void convertRGBtoRGBA(ImageData& image) {
     if (image.channels != 3)
         throw std::runtime_error("convertRGBtoRGBA: input must have 3 channels");
 
-    const std::size_t pixelCount = static_cast<std::size_t>(image.width) * static_cast<std::size_t>(image.height);
+    convertToRGBA(image);
+}
 
-    // Allocate new buffer: 4 bytes per pixel
+void convertToRGBA(ImageData& image) {
+    if (image.channels == 4) {
+        return;
+    }
+    if (image.channels < 1 || image.channels > 4) {
+        throw std::runtime_error("convertToRGBA: unsupported channel count");
+    }
+
+    const std::size_t pixelCount = static_cast<std::size_t>(image.width) * static_cast<std::size_t>(image.height);
     std::unique_ptr<uint8_t[]> rgba = std::make_unique<uint8_t[]>(pixelCount * 4);
 
-    const uint8_t* src = image.pixels.get();
-    uint8_t* dst = rgba.get();
+    switch (image.channels) {
+        case 1:
+            image_convert::grayToRgba(image.pixels.get(), rgba.get(), pixelCount);
+            break;
+        case 2:
+            image_convert::grayAlphaToRgba(image.pixels.get(), rgba.get(), pixelCount);
+            break;
+        default:
+            image_convert::rgbToRgba(image.pixels.get(), rgba.get(), pixelCount);
+            break;
+    }
+
+    image.pixels = std::move(rgba);
+    image.channels = 4;
+}
 
-    for (std::size_t i = 0; i < pixelCount; ++i) {
-        // copy R,G,B
-        dst[0] = src[0];
-        dst[1] = src[1];
-        dst[2] = src[2];
-        // set A
-        dst[3] = 255;
+namespace {
 
-        src += 3;
-        dst += 4;
+constexpr float kPi = 3.14159265358979f;
+// kernel half width in source pixels and window shape for MipFilter::KAISER
+constexpr int kKaiserRadius = 3;
+constexpr float kKaiserAlpha = 4.0f;
+
+float srgbToLinear(float value) {
+    return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+float linearToSrgb(float value) {
+    return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+// zeroth order modified Bessel function of the first kind
+float besselI0(float x) {
+    float sum = 1.0f;
+    float term = 1.0f;
+    for (int k = 1; k < 16; ++k) {
+        term *= (x / (2.0f * k)) * (x / (2.0f * k));
+        sum += term;
     }
+    return sum;
+}
 
-    // Replace old data
-    image.pixels   = std::move(rgba);
-    image.channels = 4;
+float kaiserWeight(float distance) {
+    const float x = distance / static_cast<float>(kKaiserRadius);
+    if (std::abs(x) >= 1.0f) {
+        return 0.0f;
+    }
+    // sinc with the cutoff at the new nyquist frequency, half the source one
+    const float sincArg = kPi * distance * 0.5f;
+    const float sinc = sincArg == 0.0f ? 1.0f : std::sin(sincArg) / sincArg;
+    return sinc * besselI0(kKaiserAlpha * std::sqrt(1.0f - x * x)) / besselI0(kKaiserAlpha);
+}
+
+struct FilterTap {
+    int offset; // relative to 2 * destination index
+    float weight;
+};
+
+std::vector<FilterTap> makeKernel(utils::MipFilter filter) {
+    std::vector<FilterTap> taps;
+    if (filter == utils::MipFilter::BOX) {
+        taps = {{0, 0.5f}, {1, 0.5f}};
+        return taps;
+    }
+
+    // destination pixel center sits between source pixels 2x and 2x + 1
+    float total = 0.0f;
+    for (int offset = 1 - kKaiserRadius; offset <= kKaiserRadius; ++offset) {
+        const float weight = kaiserWeight(static_cast<float>(offset) - 0.5f);
+        taps.push_back({offset, weight});
+        total += weight;
+    }
+    for (FilterTap& tap : taps) {
+        tap.weight /= total;
+    }
+    return taps;
+}
+
+// one dimensional pass, from srcSize to dstSize samples spaced stride floats apart
+void filterLine(const float* src, int srcSize, float* dst, int dstSize, size_t stride, int channels, const std::vector<FilterTap>& taps) {
+    for (int x = 0; x < dstSize; ++x) {
+        std::array<float, 4> sum{};
+        for (const FilterTap& tap : taps) {
+            // a dimension that is already 1 is not downsampled
+            const int sourceIndex = srcSize == dstSize ? x : std::clamp(2 * x + tap.offset, 0, srcSize - 1);
+            const float* sample = src + sourceIndex * stride;
+            for (int c = 0; c < channels; ++c) {
+                sum[c] += sample[c] * tap.weight;
+            }
+        }
+        for (int c = 0; c < channels; ++c) {
+            dst[x * stride + c] = sum[c];
+        }
+    }
+}
+
+} // namespace
+
+uint32_t calculateMipLevels(int width, int height) {
+    return static_cast<uint32_t>(std::floor(std::log2(std::max(std::max(width, height), 1)))) + 1;
+}
+
+uint64_t calculateLevelSize(uint32_t vkFormat, uint32_t width, uint32_t height) {
+    const vk::Format format = static_cast<vk::Format>(vkFormat);
+    const uint64_t blockBytes = vk::blockSize(format);
+    if (format == vk::Format::eUndefined || blockBytes == 0 || vk::planeCount(format) != 1) {
+        return 0;
+    }
+    const std::array<uint8_t, 3> extent = vk::blockExtent(format);
+    if (extent[2] != 1) {
+        return 0;
+    }
+    const uint64_t blocksX = (static_cast<uint64_t>(width) + extent[0] - 1) / extent[0];
+    const uint64_t blocksY = (static_cast<uint64_t>(height) + extent[1] - 1) / extent[1];
+    return blocksX * blocksY * blockBytes;
+}
+
+ImageData downsampleImage(const ImageData& image, MipFilter filter, bool srgb) {
+    if (image.channels < 1 || image.channels > 4) {
+        throw std::runtime_error("downsampleImage: unsupported channel count");
+    }
+
+    const int channels = image.channels;
+    const int srcWidth = image.width;
+    const int srcHeight = image.height;
+    const int dstWidth = std::max(srcWidth / 2, 1);
+    const int dstHeight = std::max(srcHeight / 2, 1);
+
+    if (filter == MipFilter::BOX && channels == 4) {
+        ImageData result{
+            std::make_unique<uint8_t[]>(static_cast<size_t>(dstWidth) * dstHeight * 4),
+            dstWidth,
+            dstHeight,
+            channels
+        };
+        image_convert::downsampleBoxRgba(image.pixels.get(), srcWidth, srcHeight, result.pixels.get(), srgb);
+        return result;
+    }
+    // alpha is the 4th channel, or the 2nd of a two channel image
+    const int colorChannels = (srgb && (channels == 4 || channels == 2)) ? channels - 1 : (srgb ? channels : 0);
+
+    std::vector<float> source(static_cast<size_t>(srcWidth) * srcHeight * channels);
+    for (size_t i = 0; i < source.size(); ++i) {
+        const float value = image.pixels[i] / 255.0f;
+        source[i] = static_cast<int>(i % channels) < colorChannels ? srgbToLinear(value) : value;
+    }
+
+    const std::vector<FilterTap> taps = makeKernel(filter);
+
+    // horizontal pass into dstWidth x srcHeight, then vertical into dstWidth x dstHeight
+    std::vector<float> horizontal(static_cast<size_t>(dstWidth) * srcHeight * channels);
+    for (int y = 0; y < srcHeight; ++y) {
+        filterLine(
+            source.data() + static_cast<size_t>(y) * srcWidth * channels, srcWidth,
+            horizontal.data() + static_cast<size_t>(y) * dstWidth * channels, dstWidth,
+            channels, channels, taps
+        );
+    }
+    std::vector<float> vertical(static_cast<size_t>(dstWidth) * dstHeight * channels);
+    const size_t rowStride = static_cast<size_t>(dstWidth) * channels;
+    for (int x = 0; x < dstWidth; ++x) {
+        filterLine(
+            horizontal.data() + static_cast<size_t>(x) * channels, srcHeight,
+            vertical.data() + static_cast<size_t>(x) * channels, dstHeight,
+            rowStride, channels, taps
+        );
+    }
+
+    ImageData result{
+        std::make_unique<uint8_t[]>(vertical.size()),
+        dstWidth,
+        dstHeight,
+        channels
+    };
+    for (size_t i = 0; i < vertical.size(); ++i) {
+        float value = std::clamp(vertical[i], 0.0f, 1.0f); // the kaiser kernel has negative lobes
+        if (static_cast<int>(i % channels) < colorChannels) {
+            value = linearToSrgb(value);
+        }
+        result.pixels[i] = static_cast<uint8_t>(std::lround(value * 255.0f));
+    }
+    return result;
+}
+
+void premultiplyAlpha(ImageData& image, bool srgb) {
+    if (image.channels == 4) {
+        const size_t pixelCount = static_cast<size_t>(image.width) * static_cast<size_t>(image.height);
+        image_convert::premultiplyAlpha(image.pixels.get(), pixelCount, srgb);
+        return;
+    }
+    if (image.channels != 2) {
+        return;
+    }
+
+    const int channels = image.channels;
+    const size_t pixelCount = static_cast<size_t>(image.width) * static_cast<size_t>(image.height);
+    for (size_t i = 0; i < pixelCount; ++i) {
+        uint8_t* pixel = image.pixels.get() + i * channels;
+        const float alpha = pixel[channels - 1] / 255.0f;
+        for (int c = 0; c < channels - 1; ++c) {
+            float value = pixel[c] / 255.0f;
+            // the product has to be taken on linear values
+            value = srgb ? linearToSrgb(srgbToLinear(value) * alpha) : value * alpha;
+            pixel[c] = static_cast<uint8_t>(std::lround(value * 255.0f));
+        }
+    }
+}
+
+std::u32string decodeUtf8(std::string_view text) {
+    constexpr char32_t kReplacement = 0xFFFD;
+
+    std::u32string codepoints;
+    codepoints.reserve(text.size());
+    size_t i = 0;
+    while (i < text.size()) {
+        const uint8_t lead = static_cast<uint8_t>(text[i]);
+        size_t length;
+        char32_t codepoint;
+        char32_t minimum;
+        if (lead < 0x80) {
+            codepoints.push_back(lead);
+            ++i;
+            continue;
+        } else if ((lead & 0xE0) == 0xC0) {
+            length = 2;
+            codepoint = lead & 0x1F;
+            minimum = 0x80;
+        } else if ((lead & 0xF0) == 0xE0) {
+            length = 3;
+            codepoint = lead & 0x0F;
+            minimum = 0x800;
+        } else if ((lead & 0xF8) == 0xF0) {
+            length = 4;
+            codepoint = lead & 0x07;
+            minimum = 0x10000;
+        } else {
+            codepoints.push_back(kReplacement);
+            ++i;
+            continue;
+        }
+
+        size_t consumed = 1;
+        for (; consumed < length && i + consumed < text.size(); ++consumed) {
+            const uint8_t continuation = static_cast<uint8_t>(text[i + consumed]);
+            if ((continuation & 0xC0) != 0x80) {
+                break;
+            }
+            codepoint = (codepoint << 6) | (continuation & 0x3F);
+        }
+        // a broken sequence is replaced once and decoding resumes at the byte that broke it
+        const bool valid = consumed == length && codepoint >= minimum && codepoint <= 0x10FFFF &&
+            (codepoint < 0xD800 || codepoint > 0xDFFF);
+        codepoints.push_back(valid ? codepoint : kReplacement);
+        i += consumed;
+    }
+    return codepoints;
 }
 
-} // namespace clay::utils
\ No newline at end of file
+} // namespace clay::utils
@@ -3,6 +3,17 @@
 // standard lib
 #include <stdexcept>
 #include <fstream>
+#include <optional>
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 // third party
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
@@ -11,7 +22,84 @@
 
 namespace clay::utils {
 
+namespace {
+
+#ifdef _WIN32
+
+void unmapFile(uint8_t* data, std::size_t, void*) {
+    UnmapViewOfFile(data);
+}
+
+std::optional<FileData> mapFile(const std::filesystem::path& filePath) {
+    HANDLE file = CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return std::nullopt;
+    }
+    LARGE_INTEGER fileSize{};
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(file);
+        return std::nullopt;
+    }
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr) {
+        return std::nullopt;
+    }
+    // the view keeps the mapping alive after its handle closes
+    void* view = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    CloseHandle(mapping);
+    if (view == nullptr) {
+        return std::nullopt;
+    }
+    const std::size_t size = static_cast<std::size_t>(fileSize.QuadPart);
+    return FileData{
+        {static_cast<uint8_t*>(view), FileDataDeleter(unmapFile, size, nullptr)},
+        size
+    };
+}
+
+#else
+
+void unmapFile(uint8_t* data, std::size_t size, void*) {
+    munmap(data, size);
+}
+
+std::optional<FileData> mapFile(const std::filesystem::path& filePath) {
+    const int fd = open(filePath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return std::nullopt;
+    }
+    struct stat fileStat{};
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size <= 0) {
+        close(fd);
+        return std::nullopt;
+    }
+    const std::size_t size = static_cast<std::size_t>(fileStat.st_size);
+    // private so a stray write copies the page instead of reaching the file
+    void* mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        return std::nullopt;
+    }
+    return FileData{
+        {static_cast<uint8_t*>(mapped), FileDataDeleter(unmapFile, size, nullptr)},
+        size
+    };
+}
+
+#endif
+
+} // namespace
+
 FileData loadFileToMemory_desktop(const std::filesystem::path& filePath) {
+    // pages are read on first touch and never copied into a second buffer
+    if (std::optional<FileData> mapped = mapFile(filePath)) {
+        return std::move(*mapped);
+    }
+    return readFileToMemory_desktop(filePath);
+}
+
+FileData readFileToMemory_desktop(const std::filesystem::path& filePath) {
     std::ifstream file(filePath, std::ios::binary |
                                  std::ios::ate); // 	seek to the end of stream immediately after open to get the file size
     if (!file) {
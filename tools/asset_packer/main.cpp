@@ -0,0 +1,105 @@
+// standard lib
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+// clay
+#include "clay/utils/common/AssetArchive.h"
+#include "clay/utils/desktop/UtilsDesktop.h"
+
+namespace {
+
+struct PackOptions {
+    std::filesystem::path input;
+    std::filesystem::path output;
+    bool compress = false;
+    std::vector<std::string> rawExtensions = {".ctex", ".ktx2", ".png", ".jpg", ".ogg", ".mp3"};
+};
+
+void printUsage() {
+    std::cout <<
+        "Usage: clay_asset_packer <input directory> <output.cpak> [options]\n"
+        "  --lz4              compress entries that get smaller\n"
+        "  --raw <.ext>       never compress files with this extension, may repeat\n"
+        "                     (default .ctex .ktx2 .png .jpg .ogg .mp3, already compressed or mapped as is)\n";
+}
+
+PackOptions parseArguments(int argc, char* argv[]) {
+    if (argc < 3) {
+        throw std::invalid_argument("missing input or output path");
+    }
+
+    PackOptions options;
+    options.input = argv[1];
+    options.output = argv[2];
+    bool customRaw = false;
+    for (int i = 3; i < argc; ++i) {
+        const std::string argument = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (argument == "--lz4") {
+            options.compress = true;
+        } else if (argument == "--raw" && hasValue) {
+            if (!customRaw) {
+                options.rawExtensions.clear();
+                customRaw = true;
+            }
+            options.rawExtensions.push_back(argv[++i]);
+        } else {
+            throw std::invalid_argument("unknown option " + argument);
+        }
+    }
+    return options;
+}
+
+void packDirectory(const PackOptions& options) {
+    if (!std::filesystem::is_directory(options.input)) {
+        throw std::invalid_argument(options.input.string() + " is not a directory");
+    }
+
+    std::vector<clay::utils::AssetArchiveInput> inputs;
+    std::size_t inputBytes = 0;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(options.input)) {
+        if (!entry.is_regular_file()) {
+            continue;
+        }
+        const std::string extension = entry.path().extension().string();
+        const bool raw = std::find(options.rawExtensions.begin(), options.rawExtensions.end(), extension) != options.rawExtensions.end();
+
+        clay::utils::FileData file = clay::utils::readFileToMemory_desktop(entry.path());
+        inputs.push_back({
+            std::filesystem::relative(entry.path(), options.input).generic_string(),
+            {file.data.get(), file.data.get() + file.size},
+            options.compress && !raw
+        });
+        inputBytes += file.size;
+    }
+
+    const std::vector<uint8_t> archive = clay::utils::writeAssetArchive(inputs);
+
+    std::ofstream file(options.output, std::ios::binary | std::ios::trunc);
+    if (!file.write(reinterpret_cast<const char*>(archive.data()), static_cast<std::streamsize>(archive.size()))) {
+        throw std::runtime_error("Failed to write " + options.output.string());
+    }
+
+    std::cout << options.output.string() << ": " << inputs.size() << " files, "
+              << inputBytes << " bytes in, " << archive.size() << " bytes out\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        packDirectory(parseArguments(argc, argv));
+    } catch (const std::invalid_argument& e) {
+        std::cerr << e.what() << "\n";
+        printUsage();
+        return 2;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
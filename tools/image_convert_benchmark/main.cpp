@@ -0,0 +1,110 @@
+// standard lib
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <vector>
+// clay
+#include "clay/utils/common/ImageConvert.h"
+#include "clay/utils/common/Utils.h"
+
+namespace {
+
+namespace convert = clay::utils::image_convert;
+
+constexpr int kWidth = 4096;
+constexpr int kHeight = 4096;
+constexpr std::size_t kPixelCount = static_cast<std::size_t>(kWidth) * kHeight;
+constexpr int kRepeats = 5;
+
+/** The per pixel loop convertRGBtoRGBA used before the kernels, kept as the baseline */
+void legacyRgbToRgba(const uint8_t* src, uint8_t* dst, std::size_t pixelCount) {
+    for (std::size_t i = 0; i < pixelCount; ++i) {
+        dst[0] = src[0];
+        dst[1] = src[1];
+        dst[2] = src[2];
+        dst[3] = 255;
+        src += 3;
+        dst += 4;
+    }
+}
+
+/** Best of kRepeats, in source gigabytes per second */
+double measure(std::size_t sourceBytes, const std::function<void()>& run) {
+    double best = 0.0;
+    for (int i = 0; i < kRepeats; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        run();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::max(best, static_cast<double>(sourceBytes) / elapsed.count() / 1e9);
+    }
+    return best;
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 random(42);
+    std::vector<uint8_t> source(kPixelCount * 4);
+    for (uint8_t& value : source) {
+        value = static_cast<uint8_t>(random());
+    }
+    std::vector<float> linear(kPixelCount);
+    for (float& value : linear) {
+        value = static_cast<float>(random() % 1001) / 1000.0f;
+    }
+    std::vector<uint8_t> destination(kPixelCount * 4);
+    std::vector<uint8_t> scratch(kPixelCount * 4);
+
+    std::printf("%dx%d image, best of %d, GB/s of source data\n", kWidth, kHeight, kRepeats);
+    std::printf("%-22s %10.2f\n", "rgb->rgba legacy", measure(kPixelCount * 3, [&]() {
+        legacyRgbToRgba(source.data(), destination.data(), kPixelCount);
+    }));
+
+    std::vector<convert::SimdLevel> levels = {convert::SimdLevel::SCALAR};
+    const convert::SimdLevel supported = convert::getSupportedSimdLevel();
+    if (supported == convert::SimdLevel::AVX2) {
+        levels.push_back(convert::SimdLevel::SSE4);
+    }
+    if (supported != convert::SimdLevel::SCALAR) {
+        levels.push_back(supported);
+    }
+
+    for (convert::SimdLevel level : levels) {
+        convert::setSimdLevel(level);
+        std::printf("-- %s\n", convert::toString(level));
+        std::printf("%-22s %10.2f\n", "rgb->rgba", measure(kPixelCount * 3, [&]() {
+            convert::rgbToRgba(source.data(), destination.data(), kPixelCount);
+        }));
+        std::printf("%-22s %10.2f\n", "bgra<->rgba", measure(kPixelCount * 4, [&]() {
+            convert::swapRedBlue(source.data(), destination.data(), kPixelCount);
+        }));
+        std::printf("%-22s %10.2f\n", "gray->rgba", measure(kPixelCount, [&]() {
+            convert::grayToRgba(source.data(), destination.data(), kPixelCount);
+        }));
+        std::printf("%-22s %10.2f\n", "gray alpha->rgba", measure(kPixelCount * 2, [&]() {
+            convert::grayAlphaToRgba(source.data(), destination.data(), kPixelCount);
+        }));
+        std::printf("%-22s %10.2f\n", "premultiply", measure(kPixelCount * 4, [&]() {
+            scratch = source;
+            convert::premultiplyAlpha(scratch.data(), kPixelCount, false);
+        }));
+        std::printf("%-22s %10.2f\n", "premultiply srgb", measure(kPixelCount * 4, [&]() {
+            scratch = source;
+            convert::premultiplyAlpha(scratch.data(), kPixelCount, true);
+        }));
+        std::printf("%-22s %10.2f\n", "srgb->linear", measure(kPixelCount, [&]() {
+            convert::srgbToLinear(source.data(), linear.data(), kPixelCount);
+        }));
+        std::printf("%-22s %10.2f\n", "linear->srgb", measure(kPixelCount * sizeof(float), [&]() {
+            convert::linearToSrgb(linear.data(), destination.data(), kPixelCount);
+        }));
+        std::printf("%-22s %10.2f\n", "box downsample", measure(kPixelCount * 4, [&]() {
+            convert::downsampleBoxRgba(source.data(), kWidth, kHeight, destination.data(), false);
+        }));
+        std::printf("%-22s %10.2f\n", "box downsample srgb", measure(kPixelCount * 4, [&]() {
+            convert::downsampleBoxRgba(source.data(), kWidth, kHeight, destination.data(), true);
+        }));
+    }
+    return 0;
+}
@@ -0,0 +1,195 @@
+// standard lib
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <stdexcept>
+// class
+#include "BlockEncoder.h"
+
+namespace clay::tools {
+
+namespace {
+
+using Block = std::array<std::array<uint8_t, 4>, 16>;
+
+Block fetchBlock(const utils::ImageData& image, int blockX, int blockY) {
+    Block block;
+    for (int y = 0; y < 4; ++y) {
+        const int sourceY = std::min(blockY * 4 + y, image.height - 1);
+        for (int x = 0; x < 4; ++x) {
+            const int sourceX = std::min(blockX * 4 + x, image.width - 1);
+            const uint8_t* pixel = image.pixels.get() + (static_cast<size_t>(sourceY) * image.width + sourceX) * 4;
+            std::copy(pixel, pixel + 4, block[y * 4 + x].begin());
+        }
+    }
+    return block;
+}
+
+uint16_t packRgb565(const std::array<int, 3>& color) {
+    return static_cast<uint16_t>(((color[0] * 31 + 127) / 255) << 11 | ((color[1] * 63 + 127) / 255) << 5 | ((color[2] * 31 + 127) / 255));
+}
+
+std::array<int, 3> unpackRgb565(uint16_t packed) {
+    const int r = (packed >> 11) & 31;
+    const int g = (packed >> 5) & 63;
+    const int b = packed & 31;
+    return {(r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2)};
+}
+
+int colorDistance(const std::array<int, 3>& a, const uint8_t* b) {
+    const int dr = a[0] - b[0];
+    const int dg = a[1] - b[1];
+    const int db = a[2] - b[2];
+    return dr * dr + dg * dg + db * db;
+}
+
+void writeLittleEndian16(uint8_t* destination, uint16_t value) {
+    destination[0] = static_cast<uint8_t>(value & 0xFF);
+    destination[1] = static_cast<uint8_t>(value >> 8);
+}
+
+/** 8 byte BC1 color block. With punchThrough, texels with alpha < 128 use the transparent index 3 */
+void encodeColorBlock(const Block& block, bool punchThrough, uint8_t* destination) {
+    bool hasTransparent = false;
+    std::array<int, 3> minColor{255, 255, 255};
+    std::array<int, 3> maxColor{0, 0, 0};
+    for (const auto& texel : block) {
+        if (punchThrough && texel[3] < 128) {
+            hasTransparent = true;
+            continue;
+        }
+        for (int c = 0; c < 3; ++c) {
+            minColor[c] = std::min(minColor[c], static_cast<int>(texel[c]));
+            maxColor[c] = std::max(maxColor[c], static_cast<int>(texel[c]));
+        }
+    }
+    if (minColor[0] > maxColor[0]) {
+        // every texel is transparent
+        minColor = maxColor = {0, 0, 0};
+    }
+
+    // pull the endpoints in so the interpolated colors land closer to the block's spread
+    for (int c = 0; c < 3; ++c) {
+        const int inset = (maxColor[c] - minColor[c]) / 16;
+        minColor[c] += inset;
+        maxColor[c] -= inset;
+    }
+
+    uint16_t color0 = packRgb565(maxColor);
+    uint16_t color1 = packRgb565(minColor);
+    // color0 > color1 selects the 4 color mode, color0 <= color1 the 3 color + transparent mode
+    if (hasTransparent ? color0 > color1 : color0 < color1) {
+        std::swap(color0, color1);
+    }
+
+    const std::array<int, 3> endpoint0 = unpackRgb565(color0);
+    const std::array<int, 3> endpoint1 = unpackRgb565(color1);
+    std::array<std::array<int, 3>, 4> palette;
+    palette[0] = endpoint0;
+    palette[1] = endpoint1;
+    const bool fourColor = color0 > color1;
+    for (int c = 0; c < 3; ++c) {
+        if (fourColor) {
+            palette[2][c] = (2 * endpoint0[c] + endpoint1[c]) / 3;
+            palette[3][c] = (endpoint0[c] + 2 * endpoint1[c]) / 3;
+        } else {
+            palette[2][c] = (endpoint0[c] + endpoint1[c]) / 2;
+            palette[3][c] = 0;
+        }
+    }
+
+    uint32_t indices = 0;
+    for (int i = 0; i < 16; ++i) {
+        uint32_t bestIndex = 0;
+        if (hasTransparent && block[i][3] < 128) {
+            bestIndex = 3;
+        } else if (color0 != color1) {
+            int bestDistance = colorDistance(palette[0], block[i].data());
+            const uint32_t candidates = fourColor ? 4 : 3;
+            for (uint32_t index = 1; index < candidates; ++index) {
+                const int distance = colorDistance(palette[index], block[i].data());
+                if (distance < bestDistance) {
+                    bestDistance = distance;
+                    bestIndex = index;
+                }
+            }
+        }
+        indices |= bestIndex << (i * 2);
+    }
+
+    writeLittleEndian16(destination, color0);
+    writeLittleEndian16(destination + 2, color1);
+    for (int i = 0; i < 4; ++i) {
+        destination[4 + i] = static_cast<uint8_t>(indices >> (i * 8));
+    }
+}
+
+/** 8 byte BC3 alpha block, always in the 8 value mode */
+void encodeAlphaBlock(const Block& block, uint8_t* destination) {
+    int minAlpha = 255;
+    int maxAlpha = 0;
+    for (const auto& texel : block) {
+        minAlpha = std::min(minAlpha, static_cast<int>(texel[3]));
+        maxAlpha = std::max(maxAlpha, static_cast<int>(texel[3]));
+    }
+
+    destination[0] = static_cast<uint8_t>(maxAlpha);
+    destination[1] = static_cast<uint8_t>(minAlpha);
+    uint64_t indices = 0;
+    if (maxAlpha != minAlpha) {
+        std::array<int, 8> palette;
+        palette[0] = maxAlpha;
+        palette[1] = minAlpha;
+        for (int i = 1; i < 7; ++i) {
+            palette[i + 1] = ((7 - i) * maxAlpha + i * minAlpha) / 7;
+        }
+        for (int i = 0; i < 16; ++i) {
+            uint64_t bestIndex = 0;
+            int bestDistance = 256;
+            for (uint64_t index = 0; index < 8; ++index) {
+                const int distance = std::abs(palette[index] - block[i][3]);
+                if (distance < bestDistance) {
+                    bestDistance = distance;
+                    bestIndex = index;
+                }
+            }
+            indices |= bestIndex << (i * 3);
+        }
+    }
+    for (int i = 0; i < 6; ++i) {
+        destination[2 + i] = static_cast<uint8_t>(indices >> (i * 8));
+    }
+}
+
+template<size_t BlockSize, typename EncodeBlock>
+std::vector<uint8_t> encodeBlocks(const utils::ImageData& image, EncodeBlock encodeBlock) {
+    if (image.channels != 4) {
+        throw std::runtime_error("Block compression expects an RGBA8 image");
+    }
+    const int blocksX = (image.width + 3) / 4;
+    const int blocksY = (image.height + 3) / 4;
+    std::vector<uint8_t> output(static_cast<size_t>(blocksX) * blocksY * BlockSize);
+    for (int y = 0; y < blocksY; ++y) {
+        for (int x = 0; x < blocksX; ++x) {
+            encodeBlock(fetchBlock(image, x, y), output.data() + (static_cast<size_t>(y) * blocksX + x) * BlockSize);
+        }
+    }
+    return output;
+}
+
+} // namespace
+
+std::vector<uint8_t> encodeBC1(const utils::ImageData& image) {
+    return encodeBlocks<8>(image, [](const Block& block, uint8_t* destination) {
+        encodeColorBlock(block, true, destination);
+    });
+}
+
+std::vector<uint8_t> encodeBC3(const utils::ImageData& image) {
+    return encodeBlocks<16>(image, [](const Block& block, uint8_t* destination) {
+        encodeAlphaBlock(block, destination);
+        encodeColorBlock(block, false, destination + 8);
+    });
+}
+
+} // namespace clay::tools
@@ -0,0 +1,19 @@
+#pragma once
+// standard lib
+#include <cstdint>
+#include <vector>
+// clay
+#include "clay/utils/common/Utils.h"
+
+namespace clay::tools {
+
+/**
+ * Encodes an RGBA8 image into BC1 (8 bytes per 4x4 block, 1 bit alpha) or BC3 (16 bytes per block, BC4
+ * style alpha). Edge blocks repeat the last row and column. Endpoints come from the block's bounding box
+ * inset by 1/16, which is fast and good enough for a bulk offline pass
+ */
+std::vector<uint8_t> encodeBC1(const utils::ImageData& image);
+
+std::vector<uint8_t> encodeBC3(const utils::ImageData& image);
+
+} // namespace clay::tools
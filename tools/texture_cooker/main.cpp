@@ -0,0 +1,171 @@
+// standard lib
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+// third party
+#include <vulkan/vulkan.hpp>
+// clay
+#include "clay/utils/common/CookedTexture.h"
+#include "clay/utils/common/Utils.h"
+#include "clay/utils/desktop/UtilsDesktop.h"
+// tool
+#include "BlockEncoder.h"
+
+namespace {
+
+enum class OutputFormat {
+    RGBA8,
+    BC1,
+    BC3
+};
+
+struct CookOptions {
+    std::filesystem::path input;
+    std::filesystem::path output;
+    OutputFormat format = OutputFormat::RGBA8;
+    clay::utils::MipFilter filter = clay::utils::MipFilter::KAISER;
+    bool srgb = true;
+    bool premultiply = true;
+    bool mipmaps = true;
+};
+
+void printUsage() {
+    std::cout <<
+        "Usage: clay_texture_cooker <input.png|jpg> <output.ctex> [options]\n"
+        "  --format rgba8|bc1|bc3   GPU format of every level (default rgba8)\n"
+        "  --filter box|kaiser      mip filter (default kaiser)\n"
+        "  --linear                 data is not color, no sRGB conversion\n"
+        "  --straight-alpha         do not premultiply color by alpha\n"
+        "  --no-mips                only store the base level\n";
+}
+
+CookOptions parseArguments(int argc, char* argv[]) {
+    if (argc < 3) {
+        throw std::invalid_argument("missing input or output path");
+    }
+
+    CookOptions options;
+    options.input = argv[1];
+    options.output = argv[2];
+    for (int i = 3; i < argc; ++i) {
+        const std::string argument = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (argument == "--format" && hasValue) {
+            const std::string value = argv[++i];
+            if (value == "rgba8") {
+                options.format = OutputFormat::RGBA8;
+            } else if (value == "bc1") {
+                options.format = OutputFormat::BC1;
+            } else if (value == "bc3") {
+                options.format = OutputFormat::BC3;
+            } else {
+                throw std::invalid_argument("unknown format " + value);
+            }
+        } else if (argument == "--filter" && hasValue) {
+            const std::string value = argv[++i];
+            if (value == "box") {
+                options.filter = clay::utils::MipFilter::BOX;
+            } else if (value == "kaiser") {
+                options.filter = clay::utils::MipFilter::KAISER;
+            } else {
+                throw std::invalid_argument("unknown filter " + value);
+            }
+        } else if (argument == "--linear") {
+            options.srgb = false;
+        } else if (argument == "--straight-alpha") {
+            options.premultiply = false;
+        } else if (argument == "--no-mips") {
+            options.mipmaps = false;
+        } else {
+            throw std::invalid_argument("unknown option " + argument);
+        }
+    }
+    return options;
+}
+
+vk::Format getVkFormat(OutputFormat format, bool srgb) {
+    switch (format) {
+        case OutputFormat::BC1:
+            return srgb ? vk::Format::eBc1RgbaSrgbBlock : vk::Format::eBc1RgbaUnormBlock;
+        case OutputFormat::BC3:
+            return srgb ? vk::Format::eBc3SrgbBlock : vk::Format::eBc3UnormBlock;
+        case OutputFormat::RGBA8:
+        default:
+            return srgb ? vk::Format::eR8G8B8A8Srgb : vk::Format::eR8G8B8A8Unorm;
+    }
+}
+
+std::vector<uint8_t> encodeLevel(const clay::utils::ImageData& level, OutputFormat format) {
+    switch (format) {
+        case OutputFormat::BC1:
+            return clay::tools::encodeBC1(level);
+        case OutputFormat::BC3:
+            return clay::tools::encodeBC3(level);
+        case OutputFormat::RGBA8:
+        default: {
+            const uint8_t* pixels = level.pixels.get();
+            return {pixels, pixels + static_cast<size_t>(level.width) * level.height * 4};
+        }
+    }
+}
+
+void cookTexture(const CookOptions& options) {
+    clay::utils::ImageData image = clay::utils::loadImageFileToMemory_desktop(options.input);
+    if (image.pixels == nullptr) {
+        throw std::runtime_error("Failed to decode " + options.input.string());
+    }
+    clay::utils::convertToRGBA(image);
+
+    // premultiply before filtering so transparent texels do not bleed color into the mips
+    if (options.premultiply) {
+        clay::utils::premultiplyAlpha(image, options.srgb);
+    }
+
+    const uint32_t width = static_cast<uint32_t>(image.width);
+    const uint32_t height = static_cast<uint32_t>(image.height);
+    const uint32_t levelCount = options.mipmaps ? clay::utils::calculateMipLevels(image.width, image.height) : 1;
+
+    std::vector<std::vector<uint8_t>> levels;
+    levels.reserve(levelCount);
+    levels.push_back(encodeLevel(image, options.format));
+    for (uint32_t level = 1; level < levelCount; ++level) {
+        image = clay::utils::downsampleImage(image, options.filter, options.srgb);
+        levels.push_back(encodeLevel(image, options.format));
+    }
+
+    const std::vector<uint8_t> cooked = clay::utils::writeCookedTexture(
+        static_cast<uint32_t>(getVkFormat(options.format, options.srgb)),
+        width,
+        height,
+        options.premultiply ? clay::utils::COOKED_TEXTURE_PREMULTIPLIED_ALPHA : 0u,
+        levels
+    );
+
+    std::ofstream file(options.output, std::ios::binary | std::ios::trunc);
+    if (!file.write(reinterpret_cast<const char*>(cooked.data()), static_cast<std::streamsize>(cooked.size()))) {
+        throw std::runtime_error("Failed to write " + options.output.string());
+    }
+
+    std::cout << options.output.string() << ": " << width << "x" << height << ", "
+              << levelCount << " levels, " << cooked.size() << " bytes\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        cookTexture(parseArguments(argc, argv));
+    } catch (const std::invalid_argument& e) {
+        std::cerr << e.what() << "\n";
+        printUsage();
+        return 2;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}